@@ -0,0 +1,27 @@
+#version 330 core
+
+in vec2 f_Local;
+flat in vec2 f_HalfSize;
+flat in float f_CornerRadius;
+flat in float f_Thickness;
+in vec3 f_Color;
+
+out vec4 FragColor;
+
+void main()
+{
+	// signed distance to a rounded box, circles and capsules are rounded boxes as well
+	vec2 q = abs(f_Local) - f_HalfSize + f_CornerRadius;
+	float dist = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - f_CornerRadius;
+
+	// outlines keep only a band of the given thickness inside the edge
+	if (f_Thickness > 0.0)
+		dist = abs(dist + f_Thickness * 0.5) - f_Thickness * 0.5;
+
+	// analytic anti-aliasing over one pixel
+	float alpha = clamp(0.5 - dist / fwidth(dist), 0.0, 1.0);
+	if (alpha <= 0.0)
+		discard;
+
+	FragColor = vec4(f_Color, alpha);
+}
@@ -0,0 +1,35 @@
+#version 330 core
+
+layout(location = 0) in vec2 v_Corner;
+layout(location = 1) in vec2 v_Center;
+layout(location = 2) in vec2 v_HalfSize;
+layout(location = 3) in vec3 v_Params; // corner radius, outline thickness, rotation
+layout(location = 4) in vec3 v_Color;
+
+out vec2 f_Local;
+flat out vec2 f_HalfSize;
+flat out float f_CornerRadius;
+flat out float f_Thickness;
+out vec3 f_Color;
+
+layout (std140) uniform Matrices
+{
+	mat4 VP;
+};
+
+void main()
+{
+	// grow the quad past the shape edge to leave room for anti-aliasing
+	vec2 local = v_Corner * (v_HalfSize + 2.0);
+
+	float s = sin(v_Params.z);
+	float c = cos(v_Params.z);
+	vec2 world = v_Center + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+
+	gl_Position = VP * vec4(world, 0, 1);
+	f_Local = local;
+	f_HalfSize = v_HalfSize;
+	f_CornerRadius = v_Params.x;
+	f_Thickness = v_Params.y;
+	f_Color = v_Color;
+}
@@ -0,0 +1,55 @@
+#version 330 core
+
+layout(location = 0) in vec2 v_Corner;
+layout(location = 1) in vec2 v_Center;
+layout(location = 2) in vec2 v_HalfSize;
+layout(location = 3) in vec3 v_Params; // corner radius, outline thickness, rotation
+layout(location = 4) in vec3 v_Color;
+
+out vec2 f_Local;
+flat out vec2 f_HalfSize;
+flat out float f_CornerRadius;
+flat out float f_Thickness;
+out vec3 f_Color;
+
+// view-projection and viewport of every view, see Graphics::SetViews()
+layout (std140) uniform Views
+{
+	mat4 u_ViewVP[8];
+	vec4 u_ViewRect[8];	// clip space scale (xy) and offset (zw) of the viewport
+	float u_ViewCount;
+};
+
+// instances are drawn once per view, the view's viewport is carved out of the framebuffer in clip space
+vec4 ViewPosition(vec2 world)
+{
+	int view = gl_InstanceID % int(u_ViewCount);
+	vec4 clip = u_ViewVP[view] * vec4(world, 0, 1);
+
+	// clip to the view's own frustum, not the framebuffer's
+	gl_ClipDistance[0] = clip.w + clip.x;
+	gl_ClipDistance[1] = clip.w - clip.x;
+	gl_ClipDistance[2] = clip.w + clip.y;
+	gl_ClipDistance[3] = clip.w - clip.y;
+
+	vec4 rect = u_ViewRect[view];
+	clip.xy = clip.xy * rect.xy + rect.zw * clip.w;
+	return clip;
+}
+
+void main()
+{
+	// grow the quad past the shape edge to leave room for anti-aliasing
+	vec2 local = v_Corner * (v_HalfSize + 2.0);
+
+	float s = sin(v_Params.z);
+	float c = cos(v_Params.z);
+	vec2 world = v_Center + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+
+	gl_Position = ViewPosition(world);
+	f_Local = local;
+	f_HalfSize = v_HalfSize;
+	f_CornerRadius = v_Params.x;
+	f_Thickness = v_Params.y;
+	f_Color = v_Color;
+}
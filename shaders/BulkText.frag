@@ -0,0 +1,22 @@
+#version 330 core
+
+in vec2 f_TextureCoord;
+in vec3 f_Color;
+
+out vec4 r_FragColor;
+
+uniform sampler2D u_Font;
+uniform int u_DistanceField;	// 1 when the font was loaded with LoadSDFFont()
+
+void main()
+{
+	vec4 texel = texture(u_Font, f_TextureCoord);
+
+	if (u_DistanceField != 0)
+	{	// same edge reconstruction as the SDF_TEXT shader
+		float width = fwidth(texel.r) * 0.5;
+		r_FragColor = vec4(f_Color, smoothstep(0.5 - width, 0.5 + width, texel.r));
+	}
+	else
+		r_FragColor = texel * vec4(f_Color, 1.0);
+}
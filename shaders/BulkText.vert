@@ -0,0 +1,46 @@
+#version 330 core
+
+// one glyph per instance: pen offset, char | low run bits << 8, high run bits
+layout(location = 0) in uvec3 v_Glyph;
+
+out vec2 f_TextureCoord;
+out vec3 f_Color;
+
+layout (std140) uniform Matrices
+{
+	mat4 VP;
+};
+
+// per char (u, v, bearing, unused), u and v are the top left of the char's atlas cell
+layout (std140) uniform GlyphMetrics
+{
+	vec4 u_Glyphs[256];
+};
+
+uniform samplerBuffer u_Runs;	// 2 texels per run: (x, y, scale, rotation), (r, g, b, unused)
+uniform vec2 u_CellSize;		// glyph cell in pixels
+uniform vec2 u_CellUV;			// glyph cell in texture coordinates
+
+void main()
+{
+	uint ch = v_Glyph.y & 0xFFu;
+	int run = int((v_Glyph.z << 8) | (v_Glyph.y >> 8));
+
+	vec4 origin = texelFetch(u_Runs, run * 2);
+	vec4 metrics = u_Glyphs[ch];
+
+	// quad corner from the vertex id, drawn as a 4 vertex strip
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+	// same layout as Print(), rotated around the left middle of the line
+	vec2 position = (vec2(float(v_Glyph.x) + metrics.z, 0.0) + corner * u_CellSize) * origin.z;
+	vec2 pivot = vec2(0.0, u_CellSize.y * 0.5 * origin.z);
+	float s = sin(origin.w);
+	float c = cos(origin.w);
+	position -= pivot;
+	position = vec2(c * position.x - s * position.y, s * position.x + c * position.y) + pivot;
+
+	gl_Position = VP * vec4(origin.xy + position, 0, 1);
+	f_TextureCoord = metrics.xy + corner * u_CellUV;
+	f_Color = texelFetch(u_Runs, run * 2 + 1).rgb;
+}
@@ -0,0 +1,9 @@
+#version 330 core
+
+out float Density;
+
+void main()
+{
+	// additive blending sums every point landing on this pixel
+	Density = 1.0;
+}
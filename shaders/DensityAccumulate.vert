@@ -0,0 +1,14 @@
+#version 330 core
+
+layout(location = 0) in vec2 V_Position;
+
+layout (std140) uniform Matrices
+{
+	mat4 VP;
+};
+
+void main()
+{
+	gl_Position = VP * vec4(V_Position, 0, 1);
+	gl_PointSize = 1.0;
+}
@@ -0,0 +1,23 @@
+#version 330 core
+
+in vec2 f_TextureCoord;
+
+out vec4 FragColor;
+
+uniform sampler2D u_Density;
+uniform float u_MaxDensity;
+
+void main()
+{
+	float density = texture(u_Density, f_TextureCoord).r;
+	if (density <= 0.0)
+		discard;
+
+	// log scale so sparse outliers stay visible next to dense clusters
+	float t = clamp(log(1.0 + density) / log(1.0 + u_MaxDensity), 0.0, 1.0);
+
+	// dark blue, teal, green, yellow gradient
+	vec3 low = mix(vec3(0.27, 0.00, 0.33), vec3(0.13, 0.57, 0.55), clamp(t * 2.0, 0.0, 1.0));
+	vec3 high = mix(vec3(0.13, 0.57, 0.55), vec3(0.99, 0.91, 0.14), clamp(t * 2.0 - 1.0, 0.0, 1.0));
+	FragColor = vec4(t < 0.5 ? low : high, 1.0);
+}
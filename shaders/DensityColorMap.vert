@@ -0,0 +1,11 @@
+#version 330 core
+
+out vec2 f_TextureCoord;
+
+void main()
+{
+	// single triangle covering the whole screen, no vertex data needed
+	vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	f_TextureCoord = position;
+	gl_Position = vec4(position * 2.0 - 1.0, 0, 1);
+}
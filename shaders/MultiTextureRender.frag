@@ -10,7 +10,11 @@ uniform sampler2D u_Textures[16];
 
 void main()
 {
+	// indices past the 16 units sample premultiplied textures, like layers
 	int index = f_TextureIndex;
+	bool premultiplied = index >= 16;
+	if (premultiplied)
+		index -= 16;
 
 	if (index == 0)
 		r_FragColor = texture(u_Textures[0], f_TextureCoord);
@@ -47,5 +51,9 @@ void main()
 	else 
 		r_FragColor = vec4(1, 0, 1, 1);
 
+	// dividing the alpha back out lets the usual SRC_ALPHA, ONE_MINUS_SRC_ALPHA blend composite premultiplied color like ONE, ONE_MINUS_SRC_ALPHA
+	if (premultiplied && r_FragColor.a > 0.0)
+		r_FragColor.rgb /= r_FragColor.a;
+
 	r_FragColor = r_FragColor * vec4(f_ColorOffset, 1);
 }
\ No newline at end of file
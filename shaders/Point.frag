@@ -0,0 +1,19 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec3 color;
+flat in int shape;
+
+void main()
+{
+	// round points drop every fragment outside the inscribed circle
+	if (shape == 1)
+	{
+		vec2 coord = gl_PointCoord * 2.0 - 1.0;
+		if (dot(coord, coord) > 1.0)
+			discard;
+	}
+
+	FragColor = vec4(color, 1.0);
+}
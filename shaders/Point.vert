@@ -0,0 +1,22 @@
+#version 330 core
+
+layout(location = 0) in vec2 V_Position;
+layout(location = 1) in vec3 V_Color;
+layout(location = 2) in float V_Size;
+layout(location = 3) in float V_Shape;
+
+layout (std140) uniform Matrices
+{
+	mat4 VP;
+};
+
+out vec3 color;
+flat out int shape;
+
+void main()
+{
+	gl_Position = VP * vec4(V_Position, 0, 1);
+	gl_PointSize = V_Size;
+	color = V_Color;
+	shape = int(V_Shape);
+}
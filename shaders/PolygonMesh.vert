@@ -0,0 +1,20 @@
+#version 330 core
+
+layout(location = 0) in vec2 V_Position;
+
+layout (std140) uniform Matrices
+{
+	mat4 VP;
+};
+
+uniform vec4 u_Transform; // x, y, rotation, scale
+
+void main()
+{
+	float s = sin(u_Transform.z);
+	float c = cos(u_Transform.z);
+	vec2 position = V_Position * u_Transform.w;
+	position = vec2(c * position.x - s * position.y, s * position.x + c * position.y) + u_Transform.xy;
+
+	gl_Position = VP * vec4(position, 0, 1);
+}
@@ -0,0 +1,59 @@
+#version 330 core
+
+in vec2 f_TextureCoord;
+in vec3 f_ColorOffset;
+in flat int f_TextureIndex;
+
+out vec4 r_FragColor;
+
+uniform sampler2D u_Textures[16];
+
+// distance fields store 0.5 on the glyph edge, inside is above
+float SampleDistance(int index, vec2 coord)
+{
+	if (index == 0)
+		return texture(u_Textures[0], coord).r;
+	else if (index == 1)
+		return texture(u_Textures[1], coord).r;
+	else if (index == 2)
+		return texture(u_Textures[2], coord).r;
+	else if (index == 3)
+		return texture(u_Textures[3], coord).r;
+	else if (index == 4)
+		return texture(u_Textures[4], coord).r;
+	else if (index == 5)
+		return texture(u_Textures[5], coord).r;
+	else if (index == 6)
+		return texture(u_Textures[6], coord).r;
+	else if (index == 7)
+		return texture(u_Textures[7], coord).r;
+	else if (index == 8)
+		return texture(u_Textures[8], coord).r;
+	else if (index == 9)
+		return texture(u_Textures[9], coord).r;
+	else if (index == 10)
+		return texture(u_Textures[10], coord).r;
+	else if (index == 11)
+		return texture(u_Textures[11], coord).r;
+	else if (index == 12)
+		return texture(u_Textures[12], coord).r;
+	else if (index == 13)
+		return texture(u_Textures[13], coord).r;
+	else if (index == 14)
+		return texture(u_Textures[14], coord).r;
+	else if (index == 15)
+		return texture(u_Textures[15], coord).r;
+	else
+		return 0.0;
+}
+
+void main()
+{
+	float distance = SampleDistance(f_TextureIndex, f_TextureCoord);
+
+	// smooth over one screen pixel, so edges stay crisp at any scale
+	float width = fwidth(distance) * 0.5;
+	float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+
+	r_FragColor = vec4(f_ColorOffset, alpha);
+}
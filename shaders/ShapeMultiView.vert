@@ -0,0 +1,37 @@
+#version 330 core
+
+layout(location = 0) in vec2 V_Position;
+layout(location = 1) in vec3 V_Color;
+
+out vec3 color;
+
+// view-projection and viewport of every view, see Graphics::SetViews()
+layout (std140) uniform Views
+{
+	mat4 u_ViewVP[8];
+	vec4 u_ViewRect[8];	// clip space scale (xy) and offset (zw) of the viewport
+	float u_ViewCount;
+};
+
+// instances are drawn once per view, the view's viewport is carved out of the framebuffer in clip space
+vec4 ViewPosition(vec2 world)
+{
+	int view = gl_InstanceID % int(u_ViewCount);
+	vec4 clip = u_ViewVP[view] * vec4(world, 0, 1);
+
+	// clip to the view's own frustum, not the framebuffer's
+	gl_ClipDistance[0] = clip.w + clip.x;
+	gl_ClipDistance[1] = clip.w - clip.x;
+	gl_ClipDistance[2] = clip.w + clip.y;
+	gl_ClipDistance[3] = clip.w - clip.y;
+
+	vec4 rect = u_ViewRect[view];
+	clip.xy = clip.xy * rect.xy + rect.zw * clip.w;
+	return clip;
+}
+
+void main()
+{
+	gl_Position = ViewPosition(V_Position);
+	color = V_Color;
+}
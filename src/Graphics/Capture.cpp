@@ -0,0 +1,556 @@
+#include "Capture.h"
+#include "Graphics.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+	// file header, the version changes whenever a command's arguments change
+	const char CaptureMagic[4] = { 'G', 'C', 'A', 'P' };
+	const unsigned int CaptureVersion = 1;
+
+	// recorded bytes are written out in chunks of about this size
+	const size_t CaptureFlushSize = 1 << 20;
+
+	// cursor over the bytes of a capture file
+	// reading past the end returns zeros and marks the stream as failed, so a truncated capture ends the replay
+	struct CaptureReader
+	{
+		const char* Bytes = nullptr;
+		size_t Size = 0;
+		size_t Position = 0;
+		bool Failed = false;
+
+		bool Has(size_t size)
+		{
+			if (Position + size <= Size)
+				return true;
+
+			Failed = true;
+			Position = Size;
+			return false;
+		}
+
+		template<typename T>
+		T Read()
+		{
+			T value = T();
+			if (Has(sizeof(T)))
+			{
+				memcpy(&value, Bytes + Position, sizeof(T));
+				Position += sizeof(T);
+			}
+			return value;
+		}
+
+		// read count floats into values, which keeps its storage between commands
+		const float* ReadFloats(std::vector<float>& values, unsigned int count)
+		{
+			values.resize(count);
+			if (count > 0 && Has(sizeof(float) * count))
+			{
+				memcpy(values.data(), Bytes + Position, sizeof(float) * count);
+				Position += sizeof(float) * count;
+			}
+			return values.data();
+		}
+
+		std::string ReadText()
+		{
+			unsigned int length = Read<unsigned int>();
+			if (!Has(length))
+				return std::string();
+
+			std::string text(Bytes + Position, length);
+			Position += length;
+			return text;
+		}
+	};
+
+	// state of a replay, atlases are blank stand-ins created from their recorded definitions
+	struct ReplayState
+	{
+		CaptureReader Reader;
+		std::unordered_map<int, TextureAtlas*> Atlases;	// stand-ins by recorded texture unit
+		TextureAtlas* Undefined = nullptr;		// stand-in for units the stream never defined, created on first use
+		int StandInCount = 0;					// texture units claimed by stand-ins
+		std::vector<float> Floats;				// arguments of the current command
+		std::vector<float> Vertices;			// polygon vertices of the current command
+		CompiledRenderData Container;
+		std::string Text;
+
+		TextureAtlas* ReadAtlas()
+		{
+			int unit = Reader.Read<int>();
+			if (Reader.Read<unsigned char>())
+			{
+				int width = Reader.Read<int>();
+				int height = Reader.Read<int>();
+				int atlasWidth = Reader.Read<int>();
+				int atlasHeight = Reader.Read<int>();
+				if (Reader.Failed || width <= 0 || height <= 0 || atlasWidth <= 0 || atlasHeight <= 0)
+					return nullptr;
+
+				// a mid grey texture of the recorded size samples and caches like the original
+				std::vector<unsigned char> pixels((size_t)width * height * 4, 128);
+				TextureAtlas*& atlas = Atlases[unit];
+				if (atlas)
+				{
+					atlas->GetTexture().Clean();
+					delete atlas;
+				}
+				atlas = new TextureAtlas(pixels.data(), width, height, 4, atlasWidth, atlasHeight);
+				StandInCount++;
+			}
+
+			std::unordered_map<int, TextureAtlas*>::iterator found = Atlases.find(unit);
+			return found == Atlases.end() ? nullptr : found->second;
+		}
+
+		// stand-in for a recorded unit, units without a definition (font atlases, atlases only drawn through containers) share a blank one
+		// so a recorded unit never samples whatever atlas holds the same unit in the replaying context
+		TextureAtlas* RemapUnit(int unit)
+		{
+			std::unordered_map<int, TextureAtlas*>::iterator found = Atlases.find(unit);
+			if (found != Atlases.end())
+				return found->second;
+
+			if (!Undefined)
+			{	// no size was recorded, texture coordinates are normalized so a single mid grey pixel samples the same everywhere
+				const unsigned char pixel[4] = { 128, 128, 128, 128 };
+				Undefined = new TextureAtlas(pixel, 1, 1, 4);
+				StandInCount++;
+			}
+			return Undefined;
+		}
+
+		// read a container into Container, moving the quads of every recorded unit onto a stand-in
+		CompiledRenderData& ReadContainer()
+		{
+			unsigned int count = Reader.Read<unsigned int>();
+			if (!Reader.Has((size_t)count * (sizeof(float) * VERTEX_FLOAT_COUNT + sizeof(unsigned int) * INDEX_UINT_COUNT)))
+				count = 0;
+
+			Container.Count = count;
+			Container.Capacity = count;
+			Container.Vertices.resize((size_t)count * VERTEX_FLOAT_COUNT);
+			Container.Indices.resize((size_t)count * INDEX_UINT_COUNT);
+			if (count == 0)
+				return Container;
+
+			memcpy(Container.Vertices.data(), Reader.Bytes + Reader.Position, sizeof(float) * Container.Vertices.size());
+			Reader.Position += sizeof(float) * Container.Vertices.size();
+			memcpy(Container.Indices.data(), Reader.Bytes + Reader.Position, sizeof(unsigned int) * Container.Indices.size());
+			Reader.Position += sizeof(unsigned int) * Container.Indices.size();
+
+			// the texture unit is the last of the 8 floats of every vertex
+			for (size_t i = 7; i < Container.Vertices.size(); i += 8)
+				Container.Vertices[i] = (float)RemapUnit((int)Container.Vertices[i])->GetID();
+			return Container;
+		}
+
+		// issue a single command, returns false at the end of a frame
+		bool Issue(CaptureCommand command);
+	};
+
+	bool ReplayState::Issue(CaptureCommand command)
+	{
+		// arguments are read one statement at a time, function arguments have no evaluation order
+		switch (command)
+		{
+		case CAPTURE_POLYGON:
+		{
+			Graphics::DrawMode mode = (Graphics::DrawMode)Reader.Read<int>();
+			unsigned int vertexCount = Reader.Read<unsigned int>();
+			if (!Reader.Has((size_t)vertexCount * 2 * sizeof(float)))
+				break;
+			Reader.ReadFloats(Vertices, vertexCount * 2);
+			const float* color = Reader.ReadFloats(Floats, 3);
+			if (!Reader.Failed)
+				Graphics::Polygon(mode, Vertices.data(), vertexCount, color[0], color[1], color[2]);
+			break;
+		}
+		case CAPTURE_CIRCLE:
+		{
+			Graphics::DrawMode mode = (Graphics::DrawMode)Reader.Read<int>();
+			const float* f = Reader.ReadFloats(Floats, 6);
+			unsigned int precision = Reader.Read<unsigned int>();
+			if (!Reader.Failed)
+				Graphics::Circle(mode, f[0], f[1], f[2], f[3], f[4], f[5], precision);
+			break;
+		}
+		case CAPTURE_RECTANGLE:
+		{
+			Graphics::DrawMode mode = (Graphics::DrawMode)Reader.Read<int>();
+			const float* f = Reader.ReadFloats(Floats, 10);
+			if (!Reader.Failed)
+				Graphics::Rectangle(mode, f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8], f[9]);
+			break;
+		}
+		case CAPTURE_ANALYTIC_CIRCLE:
+		{
+			Graphics::DrawMode mode = (Graphics::DrawMode)Reader.Read<int>();
+			const float* f = Reader.ReadFloats(Floats, 7);
+			if (!Reader.Failed)
+				Graphics::AnalyticCircle(mode, f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+			break;
+		}
+		case CAPTURE_ANALYTIC_RING:
+		{
+			const float* f = Reader.ReadFloats(Floats, 7);
+			if (!Reader.Failed)
+				Graphics::AnalyticRing(f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+			break;
+		}
+		case CAPTURE_ANALYTIC_ROUNDED_RECTANGLE:
+		{
+			Graphics::DrawMode mode = (Graphics::DrawMode)Reader.Read<int>();
+			const float* f = Reader.ReadFloats(Floats, 12);
+			if (!Reader.Failed)
+				Graphics::AnalyticRoundedRectangle(mode, f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8], f[9], f[10], f[11]);
+			break;
+		}
+		case CAPTURE_ANALYTIC_CAPSULE:
+		{
+			Graphics::DrawMode mode = (Graphics::DrawMode)Reader.Read<int>();
+			const float* f = Reader.ReadFloats(Floats, 9);
+			if (!Reader.Failed)
+				Graphics::AnalyticCapsule(mode, f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8]);
+			break;
+		}
+		case CAPTURE_FLUSH_SHAPES:
+			Graphics::FlushShapes();
+			break;
+		case CAPTURE_BATCH_LINES_PUSH:
+			Graphics::BatchLinesPush();
+			break;
+		case CAPTURE_LINE:
+		{
+			const float* f = Reader.ReadFloats(Floats, 7);
+			if (!Reader.Failed)
+				Graphics::Line(f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+			break;
+		}
+		case CAPTURE_BATCH_LINES_POP:
+			Graphics::BatchLinesPop();
+			break;
+		case CAPTURE_BATCH_POINTS_PUSH:
+			Graphics::BatchPointsPush();
+			break;
+		case CAPTURE_POINT:
+		{
+			float x = Reader.Read<float>();
+			float y = Reader.Read<float>();
+			unsigned int size = Reader.Read<unsigned int>();
+			const float* color = Reader.ReadFloats(Floats, 3);
+			Graphics::PointShape shape = (Graphics::PointShape)Reader.Read<int>();
+			if (!Reader.Failed)
+				Graphics::Point(x, y, size, color[0], color[1], color[2], shape);
+			break;
+		}
+		case CAPTURE_BATCH_POINTS_POP:
+		{
+			unsigned int pointSize = Reader.Read<unsigned int>();
+			if (!Reader.Failed)
+				Graphics::BatchPointsPop(pointSize);
+			break;
+		}
+		case CAPTURE_PRINT:
+		{
+			Text = Reader.ReadText();
+			const float* f = Reader.ReadFloats(Floats, 4);
+			float x = f[0], y = f[1], scale = f[2], rotation = f[3];
+			int digitTruncate = Reader.Read<int>();
+			const float* color = Reader.ReadFloats(Floats, 3);
+			if (!Reader.Failed)
+				Graphics::PrintInternal(Text, x, y, scale, rotation, digitTruncate, color[0], color[1], color[2]);
+			break;
+		}
+		case CAPTURE_DRAW_INDEX:
+		{
+			TextureAtlas* atlas = ReadAtlas();
+			unsigned int index = Reader.Read<unsigned int>();
+			const float* f = Reader.ReadFloats(Floats, 10);
+			if (atlas && !Reader.Failed)
+				Graphics::Draw(atlas, index, f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8], f[9]);
+			break;
+		}
+		case CAPTURE_DRAW_QUAD:
+		{
+			TextureAtlas* atlas = ReadAtlas();
+			const float* f = Reader.ReadFloats(Floats, 14);
+			if (atlas && !Reader.Failed)
+				Graphics::Draw(atlas, glm::vec4(f[0], f[1], f[2], f[3]), f[4], f[5], f[6], f[7], f[8], f[9], f[10], f[11], f[12], f[13]);
+			break;
+		}
+		case CAPTURE_DRAW_COMPILED:
+		{
+			CompiledRenderData& container = ReadContainer();
+			if (!Reader.Failed)
+				Graphics::Draw(container);
+			break;
+		}
+		case CAPTURE_LOAD_STATIC:
+		{
+			CompiledRenderData& container = ReadContainer();
+			if (!Reader.Failed)
+				Graphics::LoadStaticDrawData(container);
+			break;
+		}
+		case CAPTURE_CLEAR_STATIC:
+			Graphics::ClearStaticDrawData();
+			break;
+		case CAPTURE_LOAD_FONT:
+		{
+			std::string imagePath = Reader.ReadText();
+			std::string dataPath = Reader.ReadText();
+			if (!Reader.Failed)
+				Graphics::LoadFont(imagePath, dataPath);
+			break;
+		}
+		case CAPTURE_LOAD_SDF_FONT:
+		{
+			std::string imagePath = Reader.ReadText();
+			std::string dataPath = Reader.ReadText();
+			int spread = Reader.Read<int>();
+			if (!Reader.Failed)
+				Graphics::LoadSDFFont(imagePath, dataPath, spread);
+			break;
+		}
+		case CAPTURE_LOAD_TRUETYPE_FONT:
+		{
+			std::string fontPath = Reader.ReadText();
+			if (!Reader.Failed)
+				Graphics::LoadTrueTypeFont(fontPath);
+			break;
+		}
+		case CAPTURE_SET_FONT:
+		{
+			int font = Reader.Read<int>();
+			float pixelHeight = Reader.Read<float>();
+			if (!Reader.Failed)
+				Graphics::SetFont(font, pixelHeight);
+			break;
+		}
+		case CAPTURE_BEGIN_FRAME:
+			Graphics::BeginFrame();
+			break;
+		case CAPTURE_END_FRAME:
+			Graphics::EndFrame();
+			break;
+		case CAPTURE_RENDER:
+			Graphics::Render();
+			return false;
+		default:
+			std::cout << "Capture: unknown command " << (int)command << std::endl;
+			Reader.Failed = true;
+			break;
+		}
+
+		return true;
+	}
+
+}
+
+Capture::~Capture()
+{
+	Close();
+}
+
+bool Capture::Open(const std::string& path)
+{
+	Close();
+
+	m_File.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_File)
+	{
+		std::cout << "Capture: could not create " << path << std::endl;
+		return false;
+	}
+
+	m_Buffer.clear();
+	m_Atlases.clear();
+	m_Depth = 0;
+
+	Append(CaptureMagic, sizeof(CaptureMagic));
+	Write(CaptureVersion);
+	return true;
+}
+
+void Capture::Close()
+{
+	if (!m_File.is_open())
+		return;
+
+	FlushBuffer();
+	m_File.close();
+}
+
+bool Capture::IsOpen()
+{
+	return m_File.is_open();
+}
+
+bool Capture::Begin(CaptureCommand command)
+{
+	m_Depth++;
+	if (m_Depth > 1 || !m_File.is_open())
+		return false;
+
+	Append(&command, sizeof(command));
+	return true;
+}
+
+void Capture::End()
+{
+	m_Depth--;
+
+	// commands are only written out whole, between calls
+	if (m_Depth == 0 && m_Buffer.size() >= CaptureFlushSize)
+		FlushBuffer();
+}
+
+void Capture::Write(std::string_view text)
+{
+	Write((unsigned int)text.size());
+	Append(text.data(), text.size());
+}
+
+void Capture::Write(const std::string& text)
+{
+	Write(std::string_view(text));
+}
+
+void Capture::Write(const float* values, unsigned int count)
+{
+	Append(values, sizeof(float) * count);
+}
+
+void Capture::Write(TextureAtlas* atlas)
+{
+	int unit = atlas->GetID();
+	Write(unit);
+
+	// the first reference of a texture unit defines its atlas
+	bool define = m_Atlases.insert(unit).second;
+	Write((unsigned char)define);
+	if (define)
+		Record(atlas->GetTextureWidth(), atlas->GetTextureHeight(), atlas->GetAtlasWidth(), atlas->GetAtlasHeight());
+}
+
+void Capture::Write(const CompiledRenderData& container)
+{
+	Write(container.Count);
+	Append(container.Vertices.data(), sizeof(float) * container.Count * VERTEX_FLOAT_COUNT);
+	Append(container.Indices.data(), sizeof(unsigned int) * container.Count * INDEX_UINT_COUNT);
+}
+
+void Capture::Append(const void* data, size_t size)
+{
+	const char* bytes = (const char*)data;
+	m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+}
+
+void Capture::FlushBuffer()
+{
+	m_File.write(m_Buffer.data(), m_Buffer.size());
+	m_Buffer.clear();
+}
+
+bool Capture::Replay(const std::string& path, std::vector<CaptureFrameTime>& frames)
+{
+	frames.clear();
+
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		std::cout << "Capture: could not open " << path << std::endl;
+		return false;
+	}
+
+	// the whole capture is read up front, so replay never waits on the disk
+	std::vector<char> bytes((size_t)file.tellg());
+	file.seekg(0);
+	file.read(bytes.data(), bytes.size());
+
+	// stand-ins claim texture units of the context, they are given back once the replay is done
+	int atlasCount = TextureAtlas::GetAtlasCount();
+
+	ReplayState state;
+	state.Reader.Bytes = bytes.data();
+	state.Reader.Size = bytes.size();
+
+	char magic[4] = {};
+	if (state.Reader.Has(sizeof(magic)))
+	{
+		memcpy(magic, bytes.data(), sizeof(magic));
+		state.Reader.Position += sizeof(magic);
+	}
+	unsigned int version = state.Reader.Read<unsigned int>();
+	if (memcmp(magic, CaptureMagic, sizeof(magic)) != 0 || version != CaptureVersion)
+	{
+		std::cout << "Capture: " << path << " is not a capture of version " << CaptureVersion << std::endl;
+		return false;
+	}
+
+	// gpu time is measured with a timer query per frame, results are collected at the end so frames never wait on them
+	std::vector<unsigned int> queries;
+	bool frameOpen = false;
+	std::chrono::steady_clock::time_point frameStart;
+
+	while (state.Reader.Position < state.Reader.Size && !state.Reader.Failed)
+	{
+		if (!frameOpen)
+		{
+			unsigned int query = 0;
+			glGenQueries(1, &query);
+			glBeginQuery(GL_TIME_ELAPSED, query);
+			queries.push_back(query);
+			frameStart = std::chrono::steady_clock::now();
+			frameOpen = true;
+		}
+
+		CaptureCommand command = (CaptureCommand)state.Reader.Read<unsigned char>();
+		if (!state.Issue(command))
+		{
+			glEndQuery(GL_TIME_ELAPSED);
+
+			CaptureFrameTime frame;
+			frame.Cpu = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+			frames.push_back(frame);
+			frameOpen = false;
+		}
+	}
+
+	// calls after the last Render() are not a frame
+	if (frameOpen)
+		glEndQuery(GL_TIME_ELAPSED);
+
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &elapsed);
+		frames[i].Gpu = elapsed / 1e6;
+	}
+	glDeleteQueries((GLsizei)queries.size(), queries.data());
+
+	for (std::pair<const int, TextureAtlas*>& atlas : state.Atlases)
+	{
+		atlas.second->GetTexture().Clean();
+		delete atlas.second;
+	}
+	if (state.Undefined)
+	{
+		state.Undefined->GetTexture().Clean();
+		delete state.Undefined;
+	}
+
+	// atlases created by replayed calls, like fonts, live on with their units, so the count only goes back when stand-ins claimed all of them
+	if (TextureAtlas::GetAtlasCount() == atlasCount + state.StandInCount)
+		TextureAtlas::GetAtlasCount() = atlasCount;
+
+	return !state.Reader.Failed;
+}
@@ -0,0 +1,148 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "TextureRenderer.h"
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+// Enum for the recorded Graphics calls, each command is followed by the call's arguments
+enum CaptureCommand : unsigned char
+{
+	CAPTURE_POLYGON,
+	CAPTURE_CIRCLE,
+	CAPTURE_RECTANGLE,
+	CAPTURE_ANALYTIC_CIRCLE,
+	CAPTURE_ANALYTIC_RING,
+	CAPTURE_ANALYTIC_ROUNDED_RECTANGLE,
+	CAPTURE_ANALYTIC_CAPSULE,
+	CAPTURE_FLUSH_SHAPES,
+	CAPTURE_BATCH_LINES_PUSH,
+	CAPTURE_LINE,
+	CAPTURE_BATCH_LINES_POP,
+	CAPTURE_BATCH_POINTS_PUSH,
+	CAPTURE_POINT,
+	CAPTURE_BATCH_POINTS_POP,
+	CAPTURE_PRINT,
+	CAPTURE_DRAW_INDEX,
+	CAPTURE_DRAW_QUAD,
+	CAPTURE_DRAW_COMPILED,
+	CAPTURE_LOAD_STATIC,
+	CAPTURE_CLEAR_STATIC,
+	CAPTURE_LOAD_FONT,
+	CAPTURE_LOAD_SDF_FONT,
+	CAPTURE_LOAD_TRUETYPE_FONT,
+	CAPTURE_SET_FONT,
+	CAPTURE_BEGIN_FRAME,
+	CAPTURE_END_FRAME,
+	CAPTURE_RENDER
+};
+
+// Time a replayed frame took, in milliseconds
+struct CaptureFrameTime
+{
+	double Cpu = 0.0;	// Issuing the frame's calls up to and including Render()
+	double Gpu = 0.0;	// Executing the GL commands of the frame, 0 when nothing reached GL
+};
+
+// Binary stream of the calls an application made to Graphics, see Graphics::StartCapture()
+// Commands are a byte followed by their arguments in native byte order, so a capture replays on machines of the same endianness
+// Atlases are written as their texture unit, with their size and cell grid the first time, and replay draws them with blank textures of that size
+// Quads of containers sampling a unit that was never defined, like a font atlas, replay from one blank texture shared by all of them
+class Capture
+{
+public:
+	Capture() = default;
+	~Capture();
+
+	Capture(const Capture&) = delete;
+	Capture& operator=(const Capture&) = delete;
+
+	// start recording into a file, returns false when it can't be created
+	bool Open(const std::string& path);
+	// write out the recorded commands and close the file
+	void Close();
+	bool IsOpen();
+
+	// start recording a command, returns false for calls made while another command is recorded
+	// so a recorded call using other Graphics calls is only replayed once
+	// * every Begin() needs an End(), whatever it returned, see CaptureScope
+	bool Begin(CaptureCommand command);
+	void End();
+
+	// write the arguments of the command being recorded
+	template<typename T>
+	void Write(T value)
+	{
+		static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only numbers and enums are written as is");
+		if constexpr (std::is_enum<T>::value)
+		{
+			int number = (int)value;
+			Append(&number, sizeof(int));
+		}
+		else
+			Append(&value, sizeof(T));
+	}
+	void Write(std::string_view text);
+	void Write(const std::string& text);
+	void Write(const float* values, unsigned int count);
+	void Write(TextureAtlas* atlas);
+	void Write(const CompiledRenderData& container);
+
+	template<typename... T>
+	void Record(const T&... values)
+	{
+		(Write(values), ...);
+	}
+
+	// re-issue every command of a capture file on the current Graphics context, as fast as the context takes them
+	// frames receives the time of every frame, frames end on Render()
+	// * the context has to be set up like the recorded one, with the same Init calls, shaders and view projection
+	// * returns false when the file can't be read or ends in the middle of a command
+	// * blank textures claim texture units of the context while replaying, released afterwards unless replayed calls (like font loads) claimed units too
+	static bool Replay(const std::string& path, std::vector<CaptureFrameTime>& frames);
+
+private:
+	void Append(const void* data, size_t size);
+	void FlushBuffer();
+
+private:
+	std::ofstream m_File;
+	std::vector<char> m_Buffer;				// recorded bytes not written to the file yet
+	std::unordered_set<int> m_Atlases;		// texture units of the atlases already defined in the stream
+	int m_Depth = 0;						// nesting of recorded calls
+};
+
+// Recorded Graphics call, from construction to the end of its scope
+// ex: CaptureScope capture(recorder, CAPTURE_LINE); if (capture) capture->Record(x1, y1, x2, y2);
+class CaptureScope
+{
+public:
+	CaptureScope(Capture* capture, CaptureCommand command)
+		: m_Capture(capture), m_Recording(capture && capture->Begin(command))
+	{
+	}
+
+	~CaptureScope()
+	{
+		if (m_Capture)
+			m_Capture->End();
+	}
+
+	CaptureScope(const CaptureScope&) = delete;
+	CaptureScope& operator=(const CaptureScope&) = delete;
+
+	// true when the arguments of this call have to be written
+	explicit operator bool() const { return m_Recording; }
+	Capture* operator->() { return m_Capture; }
+
+private:
+	Capture* m_Capture;
+	bool m_Recording;
+};
+
+#endif
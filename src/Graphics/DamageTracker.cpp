@@ -0,0 +1,230 @@
+#include "DamageTracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+DamageTracker::DamageTracker(int width, int height, int tileSize)
+	: m_TileSize(std::max(tileSize, 1))
+{
+	glGenFramebuffers(1, &m_FBO);
+	glGenRenderbuffers(1, &m_ColorBuffer);
+
+	Resize(width, height);
+}
+
+void DamageTracker::Resize(int width, int height)
+{
+	m_Width = width;
+	m_Height = height;
+	m_TilesX = (width + m_TileSize - 1) / m_TileSize;
+	m_TilesY = (height + m_TileSize - 1) / m_TileSize;
+
+	// the target only needs color, it is copied to the screen and never sampled
+	glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	// attach the color buffer, keeping whatever framebuffer was bound
+	int previousFBO = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: Damage tracking framebuffer incomplete!" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+
+	size_t tileCount = (size_t)m_TilesX * m_TilesY;
+	m_Hashes.assign(tileCount, HASH_SEED);
+	m_PreviousHashes.assign(tileCount, HASH_SEED);
+	m_Forced.assign(tileCount, 0);
+
+	Invalidate();
+}
+
+void DamageTracker::SetViewProjection(glm::mat4 viewProjection)
+{
+	m_ViewProjection = viewProjection;
+	Invalidate();
+}
+
+void DamageTracker::Add(float minX, float minY, float maxX, float maxY, uint64_t hash)
+{
+	int tileX0, tileY0, tileX1, tileY1;
+	if (!GetTileRange(minX, minY, maxX, maxY, tileX0, tileY0, tileX1, tileY1))
+		return;
+
+	// chained in submission order, so a change in draw order also damages the tiles
+	for (int y = tileY0; y <= tileY1; y++)
+	{
+		uint64_t* row = &m_Hashes[(size_t)y * m_TilesX];
+		for (int x = tileX0; x <= tileX1; x++)
+			row[x] = (row[x] ^ hash) * 0x100000001B3ull;
+	}
+}
+
+void DamageTracker::Damage(float minX, float minY, float maxX, float maxY)
+{
+	int tileX0, tileY0, tileX1, tileY1;
+	if (!GetTileRange(minX, minY, maxX, maxY, tileX0, tileY0, tileX1, tileY1))
+		return;
+
+	for (int y = tileY0; y <= tileY1; y++)
+		memset(&m_Forced[(size_t)y * m_TilesX + tileX0], 1, tileX1 - tileX0 + 1);
+}
+
+void DamageTracker::Invalidate()
+{
+	m_Invalidated = true;
+}
+
+const std::vector<DamageRect>& DamageTracker::Update()
+{
+	m_Rects.clear();
+
+	// dirty tiles of a row are joined into runs, and a run continues the rect above it when both span the same columns
+	// rects are built in tiles and converted to pixels at the end
+	for (int y = 0; y < m_TilesY; y++)
+	{
+		int x = 0;
+		while (x < m_TilesX)
+		{
+			size_t tile = (size_t)y * m_TilesX + x;
+			if (!m_Invalidated && !m_Forced[tile] && m_Hashes[tile] == m_PreviousHashes[tile])
+			{
+				x++;
+				continue;
+			}
+
+			int runStart = x;
+			while (x < m_TilesX)
+			{
+				tile = (size_t)y * m_TilesX + x;
+				if (!m_Invalidated && !m_Forced[tile] && m_Hashes[tile] == m_PreviousHashes[tile])
+					break;
+				x++;
+			}
+
+			auto above = std::find_if(m_Rects.begin(), m_Rects.end(), [&](const DamageRect& rect)
+				{
+					return rect.X == runStart && rect.Width == x - runStart && rect.Y + rect.Height == y;
+				});
+
+			if (above != m_Rects.end())
+				above->Height++;
+			else
+				m_Rects.push_back({ runStart, y, x - runStart, 1 });
+		}
+	}
+
+	// many small rects cost more in draw calls than their union costs in fill
+	if (m_Rects.size() > MAX_RECTS)
+	{
+		DamageRect bounds = m_Rects[0];
+		for (const DamageRect& rect : m_Rects)
+		{
+			int right = std::max(bounds.X + bounds.Width, rect.X + rect.Width);
+			int top = std::max(bounds.Y + bounds.Height, rect.Y + rect.Height);
+			bounds.X = std::min(bounds.X, rect.X);
+			bounds.Y = std::min(bounds.Y, rect.Y);
+			bounds.Width = right - bounds.X;
+			bounds.Height = top - bounds.Y;
+		}
+		m_Rects.assign(1, bounds);
+	}
+
+	for (DamageRect& rect : m_Rects)
+	{
+		rect.X *= m_TileSize;
+		rect.Y *= m_TileSize;
+		rect.Width = std::min(rect.Width * m_TileSize, m_Width - rect.X);
+		rect.Height = std::min(rect.Height * m_TileSize, m_Height - rect.Y);
+	}
+
+	// this frame is the one the next frame is compared against
+	std::swap(m_Hashes, m_PreviousHashes);
+	std::fill(m_Hashes.begin(), m_Hashes.end(), HASH_SEED);
+	std::fill(m_Forced.begin(), m_Forced.end(), 0);
+	m_Invalidated = false;
+
+	return m_Rects;
+}
+
+const std::vector<DamageRect>& DamageTracker::GetRects()
+{
+	return m_Rects;
+}
+
+void DamageTracker::BindTarget()
+{
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_PreviousFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+}
+
+void DamageTracker::Present()
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_FBO);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_PreviousFBO);
+	glBlitFramebuffer(0, 0, m_Width, m_Height, 0, 0, m_Width, m_Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_PreviousFBO);
+}
+
+void DamageTracker::Clean() const
+{
+	glDeleteFramebuffers(1, &m_FBO);
+	glDeleteRenderbuffers(1, &m_ColorBuffer);
+}
+
+uint64_t DamageTracker::Hash(const float* data, size_t count, uint64_t seed)
+{
+	// FNV-1a over the float bits
+	uint64_t hash = seed;
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t bits;
+		memcpy(&bits, &data[i], sizeof(bits));
+		hash = (hash ^ bits) * 0x100000001B3ull;
+	}
+	return hash;
+}
+
+bool DamageTracker::GetTileRange(float minX, float minY, float maxX, float maxY, int& tileX0, int& tileY0, int& tileX1, int& tileY1)
+{
+	// project the box corners to pixels, rotations and flips of the projection are covered by taking their bounds
+	const glm::mat4& m = m_ViewProjection;
+	float pixelMinX = INFINITY, pixelMinY = INFINITY;
+	float pixelMaxX = -INFINITY, pixelMaxY = -INFINITY;
+
+	const float corners[8] = { minX, minY, maxX, minY, minX, maxY, maxX, maxY };
+	for (int i = 0; i < 8; i += 2)
+	{
+		float x = corners[i];
+		float y = corners[i + 1];
+
+		float w = m[0][3] * x + m[1][3] * y + m[3][3];
+		float pixelX = ((m[0][0] * x + m[1][0] * y + m[3][0]) / w + 1.f) * 0.5f * m_Width;
+		float pixelY = ((m[0][1] * x + m[1][1] * y + m[3][1]) / w + 1.f) * 0.5f * m_Height;
+
+		pixelMinX = std::min(pixelMinX, pixelX);
+		pixelMinY = std::min(pixelMinY, pixelY);
+		pixelMaxX = std::max(pixelMaxX, pixelX);
+		pixelMaxY = std::max(pixelMaxY, pixelY);
+	}
+
+	// a pixel of slack for rasterization rounding and line width
+	pixelMinX -= 1.f;
+	pixelMinY -= 1.f;
+	pixelMaxX += 1.f;
+	pixelMaxY += 1.f;
+
+	if (pixelMaxX < 0.f || pixelMaxY < 0.f || pixelMinX >= m_Width || pixelMinY >= m_Height)
+		return false;
+
+	tileX0 = std::max((int)pixelMinX, 0) / m_TileSize;
+	tileY0 = std::max((int)pixelMinY, 0) / m_TileSize;
+	tileX1 = std::min((int)pixelMaxX, m_Width - 1) / m_TileSize;
+	tileY1 = std::min((int)pixelMaxY, m_Height - 1) / m_TileSize;
+	return true;
+}
@@ -0,0 +1,91 @@
+#ifndef DAMAGE_TRACKER_H
+#define DAMAGE_TRACKER_H
+
+#include "Shader.h"
+
+#include <cstdint>
+#include <vector>
+
+// Region of a frame to redraw, in framebuffer pixels with a bottom left origin like glScissor()
+struct DamageRect
+{
+	int X = 0;
+	int Y = 0;
+	int Width = 0;
+	int Height = 0;
+};
+
+// Tracks which parts of a mostly unchanging frame need to be drawn again
+// The framebuffer is split into tiles, every primitive of a frame mixes its hash into the tiles it covers,
+// and tiles whose hash differs from the previous frame are merged into the rects to redraw
+// The frame lives in an offscreen target that keeps its pixels, so unchanged tiles are only copied to the screen
+class DamageTracker
+{
+public:
+	DamageTracker() = default;
+	// width and height are the framebuffer dimentions, tileSize the tile edge in pixels
+	DamageTracker(int width, int height, int tileSize = 32);
+
+	// resize the target and tiles, the next frame is redrawn whole
+	void Resize(int width, int height);
+
+	// set the view projection used to place primitives on tiles, the same one the Matrices uniform buffer holds
+	// the next frame is redrawn whole
+	void SetViewProjection(glm::mat4 viewProjection);
+
+	// add a primitive covering a world space box, hash identifies everything that affects its pixels
+	void Add(float minX, float minY, float maxX, float maxY, uint64_t hash);
+	// redraw a world space box on the next frame, for changes the hashes can't see like new texture contents
+	void Damage(float minX, float minY, float maxX, float maxY);
+	// redraw the whole next frame
+	void Invalidate();
+
+	// compare the frame's tiles against the previous frame and start the next one
+	// returns the rects to redraw, more than MAX_RECTS rects are merged into their bounding rect
+	const std::vector<DamageRect>& Update();
+	// rects returned by the last Update()
+	const std::vector<DamageRect>& GetRects();
+
+	// bind the offscreen target, remembering the framebuffer bound before
+	void BindTarget();
+	// copy the target into the framebuffer bound before BindTarget(), and bind it again
+	void Present();
+
+	// delete the target
+	void Clean() const;
+
+	// hash an array of floats, chained through seed
+	static uint64_t Hash(const float* data, size_t count, uint64_t seed = HASH_SEED);
+
+public:
+	static const unsigned int MAX_RECTS = 16;
+	static constexpr uint64_t HASH_SEED = 0xCBF29CE484222325ull;
+
+private:
+	// private helper functions
+	// project a world space box to a range of tiles, returns false when it is off the target
+	bool GetTileRange(float minX, float minY, float maxX, float maxY, int& tileX0, int& tileY0, int& tileX1, int& tileY1);
+
+private:
+	// opengl specific members
+	unsigned int m_FBO = 0, m_ColorBuffer = 0;
+	int m_PreviousFBO = 0;
+
+	// target and tile grid dimentions
+	int m_Width = 0, m_Height = 0;
+	int m_TileSize = 32;
+	int m_TilesX = 0, m_TilesY = 0;
+
+	glm::mat4 m_ViewProjection = glm::mat4(1.f);
+
+	// tile hashes of the frame being submitted and of the last presented frame, rows from the bottom up
+	std::vector<uint64_t> m_Hashes;
+	std::vector<uint64_t> m_PreviousHashes;
+	// tiles redrawn regardless of their hash
+	std::vector<unsigned char> m_Forced;
+	bool m_Invalidated = true;
+
+	std::vector<DamageRect> m_Rects;
+};
+
+#endif
@@ -0,0 +1,374 @@
+#include "DensityRenderer.h"
+#include "TextureAtlas.h"
+
+#include <algorithm>
+
+DensityRenderer::DensityRenderer(Shader* accumulateShader, Shader* colorMapShader, int width, int height, DensityMode mode, unsigned int threadCount)
+	: m_AccumulateShader(accumulateShader), m_ColorMapShader(colorMapShader), m_Mode(mode), m_ThreadCount(threadCount)
+{
+	if (m_ThreadCount == 0)
+		m_ThreadCount = std::thread::hardware_concurrency();
+	if (m_ThreadCount == 0)
+		m_ThreadCount = 1;
+
+	// claim a texture unit the same way atlases do, so the density texture never displaces one
+	m_TextureUnit = TextureAtlas::GetAtlasCount();
+	TextureAtlas::GetAtlasCount()++;
+
+	// point stream, positions only
+	glGenVertexArrays(1, &m_VAO);
+	glGenBuffers(1, &m_VBO);
+
+	glBindVertexArray(m_VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 2, (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// the full screen pass generates its vertices, but core profile still needs a vao bound
+	glGenVertexArrays(1, &m_ScreenVAO);
+	glBindVertexArray(0);
+
+	// density texture and the framebuffer accumulating into it
+	glGenTextures(1, &m_DensityTexture);
+	glGenFramebuffers(1, &m_FBO);
+
+	m_DensityLocation = glGetUniformLocation(m_ColorMapShader->getID(), "u_Density");
+	m_MaxDensityLocation = glGetUniformLocation(m_ColorMapShader->getID(), "u_MaxDensity");
+
+	// the maximum density is read back through a pixel buffer, sized by Resize()
+	if (m_Mode == DENSITY_GPU)
+		glGenBuffers(1, &m_ReadBackPBO);
+
+	Resize(width, height);
+
+	// the thread calling AddPoints() is the last binning thread
+	if (m_Mode == DENSITY_CPU)
+	{
+		m_Workers.reserve(m_ThreadCount - 1);
+		for (unsigned int t = 1; t < m_ThreadCount; t++)
+			m_Workers.emplace_back(&DensityRenderer::WorkerLoop, this);
+	}
+}
+
+DensityRenderer::~DensityRenderer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_Start.notify_all();
+
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+void DensityRenderer::Resize(int width, int height)
+{
+	m_Width = width;
+	m_Height = height;
+
+	// one float count per pixel
+	glActiveTexture(GL_TEXTURE0 + m_TextureUnit);
+	glBindTexture(GL_TEXTURE_2D, m_DensityTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, m_Width, m_Height, 0, GL_RED, GL_FLOAT, NULL);
+
+	// attach the texture, keeping whatever framebuffer was bound
+	int previousFBO = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_DensityTexture, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: Density framebuffer incomplete!" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+
+	// cpu grids
+	m_Grid.resize((size_t)m_Width * m_Height);
+	if (m_Mode == DENSITY_CPU)
+		m_ThreadGrids.assign(m_ThreadCount, std::vector<unsigned int>((size_t)m_Width * m_Height));
+
+	// a readback in flight has the old size, start over
+	if (m_Mode == DENSITY_GPU)
+	{
+		if (m_ReadBackFence)
+			glDeleteSync(m_ReadBackFence);
+		m_ReadBackFence = 0;
+		m_ReadBackMax = -1.f;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_ReadBackPBO);
+		glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(float) * m_Width * m_Height, NULL, GL_STREAM_READ);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	Clear();
+}
+
+void DensityRenderer::SetViewProjection(glm::mat4 viewProjection)
+{
+	m_ViewProjection = viewProjection;
+}
+
+void DensityRenderer::Clear()
+{
+	if (m_Mode == DENSITY_CPU)
+	{
+		for (std::vector<unsigned int>& grid : m_ThreadGrids)
+			std::fill(grid.begin(), grid.end(), 0);
+		return;
+	}
+
+	// clear the density texture through its framebuffer, restoring the clear color afterwards
+	int previousFBO = 0;
+	float clearColor[4];
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	glClearColor(0.f, 0.f, 0.f, 0.f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+}
+
+void DensityRenderer::AddPoints(const float* points, unsigned int count)
+{
+	if (count == 0)
+		return;
+
+	if (m_Mode == DENSITY_CPU)
+		AccumulateCPU(points, count);
+	else
+		AccumulateGPU(points, count);
+}
+
+void DensityRenderer::Render(float maxDensity)
+{
+	float gridMax = 0.f;
+	if (m_Mode == DENSITY_CPU)
+		gridMax = ResolveCPU();
+	else if (maxDensity <= 0.f)
+		gridMax = ReadBackGPUAsync();
+
+	if (maxDensity <= 0.f)
+		maxDensity = gridMax > 0.f ? gridMax : 1.f;
+
+	glActiveTexture(GL_TEXTURE0 + m_TextureUnit);
+	glBindTexture(GL_TEXTURE_2D, m_DensityTexture);
+
+	// bind shader
+	m_ColorMapShader->use();
+	glUniform1i(m_DensityLocation, m_TextureUnit);
+	glUniform1f(m_MaxDensityLocation, maxDensity);
+
+	// issue draw call for the full screen triangle
+	glBindVertexArray(m_ScreenVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void DensityRenderer::AccumulateGPU(const float* points, unsigned int count)
+{
+	// store the state changed by accumulation
+	int previousFBO = 0;
+	int viewport[4];
+	int blendSrc = 0, blendDst = 0;
+	bool blendEnabled = glIsEnabled(GL_BLEND);
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrc);
+	glGetIntegerv(GL_BLEND_DST_RGB, &blendDst);
+
+	// every point adds 1 to its pixel
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	glViewport(0, 0, m_Width, m_Height);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+	glEnable(GL_PROGRAM_POINT_SIZE);
+
+	m_AccumulateShader->use();
+	glBindVertexArray(m_VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+
+	// stream the points through a fixed size buffer, orphaning it every chunk
+	for (unsigned int first = 0; first < count; first += CHUNK_POINT_COUNT)
+	{
+		unsigned int chunk = count - first < CHUNK_POINT_COUNT ? count - first : CHUNK_POINT_COUNT;
+
+		glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 2 * CHUNK_POINT_COUNT, NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GL_FLOAT) * 2 * chunk, points + (size_t)first * 2);
+
+		glDrawArrays(GL_POINTS, 0, chunk);
+	}
+
+	// restore state
+	glDisable(GL_PROGRAM_POINT_SIZE);
+	glBlendFunc(blendSrc, blendDst);
+	if (!blendEnabled)
+		glDisable(GL_BLEND);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+}
+
+void DensityRenderer::AccumulateCPU(const float* points, unsigned int count)
+{
+	// every slice is binned into its own grid, so no synchronization is needed
+	m_JobPoints = points;
+	m_JobCount = count;
+	m_JobSliceCount = m_ThreadCount < count ? m_ThreadCount : count;
+	m_JobSlice = (count + m_JobSliceCount - 1) / m_JobSliceCount;
+	m_NextSlice = 0;
+
+	if (!m_Workers.empty())
+	{	// wake the workers for this call's slices
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Job++;
+			m_Busy = (unsigned int)m_Workers.size();
+		}
+		m_Start.notify_all();
+	}
+
+	// the calling thread bins slices as well
+	BinNextSlices();
+
+	// slices taken by a worker may still be binning
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Done.wait(lock, [this]() { return m_Busy == 0; });
+}
+
+void DensityRenderer::BinNextSlices()
+{
+	const glm::mat4& m = m_ViewProjection;
+	float halfWidth = m_Width * 0.5f;
+	float halfHeight = m_Height * 0.5f;
+
+	for (unsigned int slice = m_NextSlice++; slice < m_JobSliceCount; slice = m_NextSlice++)
+	{
+		std::vector<unsigned int>& grid = m_ThreadGrids[slice];
+		unsigned int begin = slice * m_JobSlice;
+		unsigned int end = begin + m_JobSlice < m_JobCount ? begin + m_JobSlice : m_JobCount;
+
+		for (unsigned int i = begin; i < end; i++)
+		{
+			float x = m_JobPoints[(size_t)i * 2];
+			float y = m_JobPoints[(size_t)i * 2 + 1];
+
+			// project to normalized device coordinates, then to grid cells
+			float w = m[0][3] * x + m[1][3] * y + m[3][3];
+			float ndcX = (m[0][0] * x + m[1][0] * y + m[3][0]) / w;
+			float ndcY = (m[0][1] * x + m[1][1] * y + m[3][1]) / w;
+
+			float cellX = (ndcX + 1.f) * halfWidth;
+			float cellY = (ndcY + 1.f) * halfHeight;
+			if (cellX < 0.f || cellY < 0.f || cellX >= m_Width || cellY >= m_Height)
+				continue;
+
+			grid[(size_t)cellY * m_Width + (size_t)cellX]++;
+		}
+	}
+}
+
+void DensityRenderer::WorkerLoop()
+{
+	unsigned long long job = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Start.wait(lock, [this, job]() { return m_Stopping || m_Job != job; });
+			if (m_Stopping)
+				return;
+			job = m_Job;
+		}
+
+		BinNextSlices();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (--m_Busy == 0)
+			m_Done.notify_one();
+	}
+}
+
+float DensityRenderer::ResolveCPU()
+{
+	float maxDensity = 0.f;
+
+	for (size_t i = 0; i < m_Grid.size(); i++)
+	{
+		unsigned int sum = 0;
+		for (const std::vector<unsigned int>& grid : m_ThreadGrids)
+			sum += grid[i];
+
+		m_Grid[i] = (float)sum;
+		if (m_Grid[i] > maxDensity)
+			maxDensity = m_Grid[i];
+	}
+
+	glActiveTexture(GL_TEXTURE0 + m_TextureUnit);
+	glBindTexture(GL_TEXTURE_2D, m_DensityTexture);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, GL_RED, GL_FLOAT, m_Grid.data());
+
+	return maxDensity;
+}
+
+float DensityRenderer::ReadBackGPU()
+{
+	glActiveTexture(GL_TEXTURE0 + m_TextureUnit);
+	glBindTexture(GL_TEXTURE_2D, m_DensityTexture);
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, m_Grid.data());
+
+	float maxDensity = 0.f;
+	for (float density : m_Grid)
+	{
+		if (density > maxDensity)
+			maxDensity = density;
+	}
+
+	return maxDensity;
+}
+
+float DensityRenderer::ReadBackGPUAsync()
+{
+	// pick up the last readback once the GPU is done with it, flushing so its fence is eventually signaled
+	if (m_ReadBackFence)
+	{
+		GLenum status = glClientWaitSync(m_ReadBackFence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+		{
+			glDeleteSync(m_ReadBackFence);
+			m_ReadBackFence = 0;
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, m_ReadBackPBO);
+			const float* densities = (const float*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(float) * m_Width * m_Height, GL_MAP_READ_BIT);
+			if (densities)
+			{
+				m_ReadBackMax = *std::max_element(densities, densities + (size_t)m_Width * m_Height);
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			}
+			else
+				std::cout << "Error: Failed to map density readback buffer!" << std::endl;
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		}
+	}
+
+	// the first frame has nothing to lag behind, so it reads the grid directly
+	if (m_ReadBackMax < 0.f)
+		m_ReadBackMax = ReadBackGPU();
+
+	// the copy lands in the pixel buffer, glGetTexImage() returns without waiting for accumulation to finish
+	if (!m_ReadBackFence)
+	{
+		glActiveTexture(GL_TEXTURE0 + m_TextureUnit);
+		glBindTexture(GL_TEXTURE_2D, m_DensityTexture);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_ReadBackPBO);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, (void*)0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		m_ReadBackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	return m_ReadBackMax;
+}
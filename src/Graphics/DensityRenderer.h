@@ -0,0 +1,122 @@
+#ifndef DENSITY_RENDERER_H
+#define DENSITY_RENDERER_H
+
+#include "Shader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Enum for the way points are binned into the density grid
+enum DensityMode
+{
+	// Points are streamed to the GPU in chunks and summed with additive blending
+	DENSITY_GPU,
+	// Points are binned on the CPU by a pool of threads and uploaded once per Render()
+	DENSITY_CPU
+};
+
+// renderer for very large point clouds
+// points are binned into a screen sized density grid, then drawn as a single color mapped full screen pass
+// memory and frame time depend on the grid size instead of the point count
+class DensityRenderer
+{
+public:
+	DensityRenderer() = default;
+	// initialize a density renderer using shaders from the DENSITY_ACCUMULATE and DENSITY_COLOR_MAP premade types
+	// width and height are the grid dimentions, usually the screen size
+	// threadCount is only used by DENSITY_CPU, 0 uses every hardware thread
+	// * the calling thread of AddPoints() bins as well, threadCount - 1 workers are started here and kept until destruction
+	DensityRenderer(Shader* accumulateShader, Shader* colorMapShader, int width, int height, DensityMode mode = DENSITY_GPU, unsigned int threadCount = 0);
+	~DensityRenderer();
+
+	DensityRenderer(const DensityRenderer&) = delete;
+	DensityRenderer& operator=(const DensityRenderer&) = delete;
+
+	// resize the density grid, clears it as well
+	void Resize(int width, int height);
+
+	// set the view projection used to place points on the grid
+	// * only needed by DENSITY_CPU, DENSITY_GPU uses the Matrices uniform buffer like the other shaders
+	void SetViewProjection(glm::mat4 viewProjection);
+
+	// reset the density grid, call before adding a new set of points
+	void Clear();
+
+	// bin an array of points, 2 floats per point
+	// * points are processed in chunks, so the array can be any size
+	void AddPoints(const float* points, unsigned int count);
+
+	// color map the density grid to the screen
+	// maxDensity is the point count mapped to the top of the color map
+	// * passing 0 uses the grid's maximum, DENSITY_GPU reads it back without waiting so it lags a frame behind
+	void Render(float maxDensity = 0.f);
+
+private:
+	// private helper functions
+	void AccumulateGPU(const float* points, unsigned int count);
+	void AccumulateCPU(const float* points, unsigned int count);
+	// merge the per-thread grids into m_Grid and upload it, returns the largest count
+	float ResolveCPU();
+	// read the density texture back into m_Grid, returns the largest count
+	float ReadBackGPU();
+	// largest count of the last finished readback, starting the next one, never waits unless none finished yet
+	float ReadBackGPUAsync();
+
+	// bin the slices of the current job until none are left, run by the workers and the thread calling AddPoints()
+	void BinNextSlices();
+	void WorkerLoop();
+
+private:
+	Shader* m_AccumulateShader = nullptr;
+	Shader* m_ColorMapShader = nullptr;
+
+	DensityMode m_Mode = DENSITY_GPU;
+	unsigned int m_ThreadCount = 1;
+
+	// opengl specific members
+	unsigned int m_VAO = 0, m_VBO = 0;
+	unsigned int m_ScreenVAO = 0;
+	unsigned int m_FBO = 0;
+	unsigned int m_DensityTexture = 0;
+	int m_TextureUnit = -1;
+	int m_DensityLocation = -1;
+	int m_MaxDensityLocation = -1;
+
+	// asynchronous readback of the density texture, m_ReadBackFence is 0 when none is in flight
+	unsigned int m_ReadBackPBO = 0;
+	GLsync m_ReadBackFence = 0;
+	float m_ReadBackMax = -1.f;	// below 0 until a readback finished
+
+	// points uploaded per GPU draw call
+	static const unsigned int CHUNK_POINT_COUNT = 1 << 20;
+
+	// grid members
+	int m_Width = 0;
+	int m_Height = 0;
+	glm::mat4 m_ViewProjection = glm::mat4(1.f);
+
+	// data storage members
+	std::vector<float> m_Grid;
+	std::vector<std::vector<unsigned int>> m_ThreadGrids;
+
+	// worker pool, every AddPoints() bumps m_Job and waits until m_Busy workers are done with it
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_Start;
+	std::condition_variable m_Done;
+	unsigned long long m_Job = 0;
+	unsigned int m_Busy = 0;
+	bool m_Stopping = false;
+
+	// current job, slice i of the points is binned into m_ThreadGrids[i]
+	const float* m_JobPoints = nullptr;
+	unsigned int m_JobCount = 0;
+	unsigned int m_JobSlice = 0;
+	unsigned int m_JobSliceCount = 0;
+	std::atomic<unsigned int> m_NextSlice{ 0 };
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "FileMapping.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FileMapping::~FileMapping()
+{
+	Close();
+}
+
+bool FileMapping::Open(const std::string& path)
+{
+	Close();
+
+	// the view keeps the mapping alive, so the file handles are closed right away
+	void* data = nullptr;
+	size_t size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		std::cout << "Error: File at " << path << " not found!" << std::endl;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+	{
+		size = (size_t)fileSize.QuadPart;
+		HANDLE fileMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (fileMapping)
+		{
+			data = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(fileMapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		std::cout << "Error: File at " << path << " not found!" << std::endl;
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+	{
+		size = (size_t)fileStat.st_size;
+		data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data == MAP_FAILED)
+			data = nullptr;
+	}
+	close(file);
+#endif
+
+	// an empty file has nothing to map
+	if (size > 0 && !data)
+	{
+		std::cout << "Error: Failed to map file at " << path << std::endl;
+		return false;
+	}
+
+	m_Data = data;
+	m_Size = size;
+	return true;
+}
+
+void FileMapping::Close()
+{
+	if (m_Data)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_Data);
+#else
+		munmap(m_Data, m_Size);
+#endif
+	}
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
+
+const char* FileMapping::GetData()
+{
+	return (const char*)m_Data;
+}
+
+size_t FileMapping::GetSize()
+{
+	return m_Size;
+}
@@ -0,0 +1,32 @@
+#ifndef FILE_MAPPING_H
+#define FILE_MAPPING_H
+
+#include <string>
+
+// Read only memory mapping of a whole file
+// Kept apart from the Graphics headers, so the platform headers it needs never meet them in one translation unit
+class FileMapping
+{
+public:
+	FileMapping() = default;
+	~FileMapping();
+
+	FileMapping(const FileMapping&) = delete;
+	FileMapping& operator=(const FileMapping&) = delete;
+
+	// map a file, returns false and prints the error when it could not be opened or mapped
+	// * an empty file opens without a mapping
+	bool Open(const std::string& path);
+	// unmap the file
+	void Close();
+
+	// mapped bytes, nullptr while nothing is mapped
+	const char* GetData();
+	size_t GetSize();
+
+private:
+	void* m_Data = nullptr;
+	size_t m_Size = 0;
+};
+
+#endif
@@ -0,0 +1,272 @@
+#include "FontMetrics.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Parse a whole string_view as an int, surrounding spaces are allowed
+static bool ParseInt(std::string_view text, int& value)
+{
+	while (!text.empty() && text.front() == ' ')
+		text.remove_prefix(1);
+	while (!text.empty() && text.back() == ' ')
+		text.remove_suffix(1);
+
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+	return result.ec == std::errc() && result.ptr == text.data() + text.size() && !text.empty();
+}
+
+bool FontMetrics::Load(const std::string& path)
+{
+	*this = FontMetrics();
+
+	std::ifstream fin(path, std::ios::binary | std::ios::ate);
+	if (fin.fail())
+	{
+		std::cout << "Error: Font data path at " << path << " not found!" << std::endl;
+		return false;
+	}
+
+	// read the whole file at once
+	std::string data((size_t)fin.tellg(), '\0');
+	fin.seekg(0);
+	fin.read(&data[0], data.size());
+	if (fin.fail())
+	{
+		std::cout << "Error: Failed to read font data at " << path << std::endl;
+		return false;
+	}
+
+	uint32_t magic = 0;
+	if (data.size() >= sizeof(magic))
+		memcpy(&magic, data.data(), sizeof(magic));
+
+	bool parsed = magic == BINARY_MAGIC ? ParseBinary(data, path) : ParseCSV(data, path);
+	return parsed && Validate(path);
+}
+
+bool FontMetrics::Save(const std::string& path) const
+{
+	std::ofstream fout(path, std::ios::binary);
+	if (fout.fail())
+	{
+		std::cout << "Error: Font data path at " << path << " could not be created!" << std::endl;
+		return false;
+	}
+
+	// assembled in memory and written at once, mirroring the single read in Load()
+	std::string data(BINARY_HEADER_SIZE + BINARY_TABLES_SIZE + Kerning.size() * BINARY_KERNING_SIZE, '\0');
+	char* write = &data[0];
+
+	const int32_t header[8] = {
+		(int32_t)BINARY_MAGIC, (int32_t)BINARY_VERSION,
+		ImageWidth, ImageHeight, CellWidth, CellHeight, StartChar,
+		(int32_t)Kerning.size()
+	};
+	memcpy(write, header, sizeof(header));
+	write += sizeof(header);
+
+	for (int i = 0; i < 256; i++)
+	{
+		int16_t width = (int16_t)Widths[i];
+		memcpy(write + i * sizeof(int16_t), &width, sizeof(int16_t));
+
+		int16_t bearing = (int16_t)Bearings[i];
+		memcpy(write + (256 + i) * sizeof(int16_t), &bearing, sizeof(int16_t));
+	}
+	write += BINARY_TABLES_SIZE;
+
+	for (const FontKerningPair& pair : Kerning)
+	{
+		int16_t amount = pair.Amount;
+		write[0] = (char)pair.Left;
+		write[1] = (char)pair.Right;
+		memcpy(write + 2, &amount, sizeof(int16_t));
+		write += BINARY_KERNING_SIZE;
+	}
+
+	fout.write(data.data(), data.size());
+	return !fout.fail();
+}
+
+int FontMetrics::FindKerning(const std::vector<FontKerningPair>& kerning, unsigned char left, unsigned char right)
+{
+	if (kerning.empty())
+		return 0;
+
+	auto found = std::lower_bound(kerning.begin(), kerning.end(), std::make_pair(left, right),
+		[](const FontKerningPair& pair, const std::pair<unsigned char, unsigned char>& key)
+		{
+			return pair.Left < key.first || (pair.Left == key.first && pair.Right < key.second);
+		});
+
+	if (found != kerning.end() && found->Left == left && found->Right == right)
+		return found->Amount;
+	return 0;
+}
+
+bool FontMetrics::ParseBinary(std::string_view data, const std::string& path)
+{
+	if (data.size() < BINARY_HEADER_SIZE + BINARY_TABLES_SIZE)
+	{
+		std::cout << "Error: Font data at " << path << " is truncated" << std::endl;
+		return false;
+	}
+
+	int32_t header[8];
+	memcpy(header, data.data(), sizeof(header));
+	if ((uint32_t)header[1] != BINARY_VERSION)
+	{
+		std::cout << "Error: Font data at " << path << " has unsupported version " << header[1] << std::endl;
+		return false;
+	}
+
+	ImageWidth = header[2];
+	ImageHeight = header[3];
+	CellWidth = header[4];
+	CellHeight = header[5];
+	StartChar = header[6];
+
+	size_t kerningCount = (uint32_t)header[7];
+	if (data.size() != BINARY_HEADER_SIZE + BINARY_TABLES_SIZE + kerningCount * BINARY_KERNING_SIZE)
+	{
+		std::cout << "Error: Font data at " << path << " does not match its kerning pair count" << std::endl;
+		return false;
+	}
+
+	const char* read = data.data() + BINARY_HEADER_SIZE;
+	for (int i = 0; i < 256; i++)
+	{
+		int16_t width, bearing;
+		memcpy(&width, read + i * sizeof(int16_t), sizeof(int16_t));
+		memcpy(&bearing, read + (256 + i) * sizeof(int16_t), sizeof(int16_t));
+		Widths[i] = width;
+		Bearings[i] = bearing;
+	}
+	read += BINARY_TABLES_SIZE;
+
+	Kerning.resize(kerningCount);
+	for (FontKerningPair& pair : Kerning)
+	{
+		pair.Left = (unsigned char)read[0];
+		pair.Right = (unsigned char)read[1];
+		memcpy(&pair.Amount, read + 2, sizeof(int16_t));
+		read += BINARY_KERNING_SIZE;
+	}
+
+	return true;
+}
+
+bool FontMetrics::ParseCSV(std::string_view text, const std::string& path)
+{
+	// "Key,Value" lines of the font generator, keys this renderer doesn't use are skipped
+	// besides the generator's keys, "Char N Bearing,x" and "Kerning L R,x" lines fill the bearing and kerning tables
+	int lineNumber = 0;
+	while (!text.empty())
+	{
+		size_t end = text.find('\n');
+		std::string_view line = text.substr(0, end);
+		text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+		lineNumber++;
+
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+		if (line.empty())
+			continue;
+
+		size_t comma = line.find(',');
+		std::string_view key = line.substr(0, comma);
+		std::string_view value = comma == std::string_view::npos ? std::string_view() : line.substr(comma + 1);
+
+		// only the first value of a line is used
+		value = value.substr(0, value.find(','));
+
+		int* target = nullptr;
+		int kerningLeft = -1, kerningRight = -1;
+
+		if (key == "Cell Width")
+			target = &CellWidth;
+		else if (key == "Cell Height")
+			target = &CellHeight;
+		else if (key == "Start Char")
+			target = &StartChar;
+		else if (key == "Image Width")
+			target = &ImageWidth;
+		else if (key == "Image Height")
+			target = &ImageHeight;
+		else if (key.substr(0, 5) == "Char ")
+		{	// "Char N Base Width" or "Char N Bearing"
+			std::string_view rest = key.substr(5);
+			size_t space = rest.find(' ');
+			std::string_view field = space == std::string_view::npos ? std::string_view() : rest.substr(space + 1);
+			if (field != "Base Width" && field != "Bearing")
+				continue;
+
+			int ch = 0;
+			if (!ParseInt(rest.substr(0, space), ch) || ch < 0 || ch > 255)
+			{
+				std::cout << "Error: " << path << ":" << lineNumber << ": invalid char code" << std::endl;
+				return false;
+			}
+			target = field == "Base Width" ? &Widths[ch] : &Bearings[ch];
+		}
+		else if (key.substr(0, 8) == "Kerning ")
+		{	// "Kerning L R", as char codes
+			std::string_view rest = key.substr(8);
+			size_t space = rest.find(' ');
+			if (space == std::string_view::npos || !ParseInt(rest.substr(0, space), kerningLeft) || !ParseInt(rest.substr(space + 1), kerningRight) ||
+				kerningLeft < 0 || kerningLeft > 255 || kerningRight < 0 || kerningRight > 255)
+			{
+				std::cout << "Error: " << path << ":" << lineNumber << ": invalid kerning pair" << std::endl;
+				return false;
+			}
+		}
+		else
+			continue;
+
+		int number = 0;
+		if (!ParseInt(value, number))
+		{
+			std::cout << "Error: " << path << ":" << lineNumber << ": \"" << value << "\" is not a number" << std::endl;
+			return false;
+		}
+
+		if (target)
+			*target = number;
+		else
+			Kerning.push_back({ (unsigned char)kerningLeft, (unsigned char)kerningRight, (short)number });
+	}
+
+	std::sort(Kerning.begin(), Kerning.end(), [](const FontKerningPair& a, const FontKerningPair& b)
+		{
+			return a.Left < b.Left || (a.Left == b.Left && a.Right < b.Right);
+		});
+
+	return true;
+}
+
+bool FontMetrics::Validate(const std::string& path)
+{
+	const char* error = nullptr;
+	if (CellWidth <= 0 || CellHeight <= 0)
+		error = "cell size must be positive";
+	else if (ImageWidth < CellWidth || ImageHeight < CellHeight)
+		error = "image must be at least one cell";
+	else if (StartChar < 0 || StartChar > 255)
+		error = "start char must be within 0 and 255";
+	else if (!std::is_sorted(Kerning.begin(), Kerning.end(), [](const FontKerningPair& a, const FontKerningPair& b)
+		{
+			return a.Left < b.Left || (a.Left == b.Left && a.Right < b.Right);
+		}))
+		error = "kerning pairs are not sorted";
+
+	if (error)
+	{
+		std::cout << "Error: Font data at " << path << ": " << error << std::endl;
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,60 @@
+#ifndef FONT_METRICS_H
+#define FONT_METRICS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Pen adjustment between two chars of a bitmap font
+struct FontKerningPair
+{
+	unsigned char Left;
+	unsigned char Right;
+	short Amount;		// in pixels at scale 1
+};
+
+// Metrics of a bitmap font atlas, read from the font generator's CSV or from the binary format
+//
+// The binary format is little endian and read with a single file read:
+//   header		8 x int32: magic "GFNT", version, image width, image height, cell width, cell height, start char, kerning pair count
+//   widths		256 x int16 advance per char
+//   bearings	256 x int16 horizontal cell offset per char
+//   kerning	pair count x (uint8 left, uint8 right, int16 amount), sorted by left then right
+class FontMetrics
+{
+public:
+	// read font metrics in either format, the binary format is detected by its magic
+	// returns false and prints the error when the file is missing or malformed
+	bool Load(const std::string& path);
+	// write the metrics in the binary format
+	bool Save(const std::string& path) const;
+
+	// pen adjustment between two chars, 0 when the pair has none
+	static int FindKerning(const std::vector<FontKerningPair>& kerning, unsigned char left, unsigned char right);
+
+public:
+	int ImageWidth = 0;
+	int ImageHeight = 0;
+	int CellWidth = 0;
+	int CellHeight = 0;
+	int StartChar = 0;
+	int Widths[256] = {};
+	int Bearings[256] = {};
+	std::vector<FontKerningPair> Kerning;
+
+private:
+	// private helper functions
+	bool ParseBinary(std::string_view data, const std::string& path);
+	bool ParseCSV(std::string_view text, const std::string& path);
+	bool Validate(const std::string& path);
+
+private:
+	static const uint32_t BINARY_MAGIC = 0x544E4647;	// "GFNT" read as a little endian int32
+	static const uint32_t BINARY_VERSION = 1;
+	static const size_t BINARY_HEADER_SIZE = 8 * sizeof(int32_t);
+	static const size_t BINARY_TABLES_SIZE = 2 * 256 * sizeof(int16_t);
+	static const size_t BINARY_KERNING_SIZE = 4;
+};
+
+#endif
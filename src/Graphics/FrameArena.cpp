@@ -0,0 +1,134 @@
+#include "FrameArena.h"
+
+#include <cstring>
+
+#ifdef GRAPHICS_COUNT_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+// heap allocations of the current thread, counted by the replaced global operator new
+static thread_local unsigned long long HeapAllocations = 0;
+
+void* operator new(size_t size)
+{
+	HeapAllocations++;
+
+	if (size == 0)
+		size = 1;
+	while (true)
+	{
+		if (void* memory = malloc(size))
+			return memory;
+
+		std::new_handler handler = std::get_new_handler();
+		if (!handler)
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+#endif
+
+FrameArena::FrameArena(size_t initialSize)
+	: m_InitialSize(initialSize > 0 ? initialSize : 1)
+{
+	// room for a few overflow blocks, so growing within a frame doesn't reallocate the block list either
+	m_Blocks.reserve(8);
+}
+
+FrameArena::~FrameArena()
+{
+	for (Block& block : m_Blocks)
+		delete[] block.Memory;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	if (!m_Blocks.empty())
+	{
+		Block& block = m_Blocks.back();
+		size_t offset = (m_Offset + alignment - 1) / alignment * alignment;
+		if (offset + size <= block.Size)
+		{
+			m_Offset = offset + size;
+			return block.Memory + offset;
+		}
+	}
+
+	// the block is full, earlier allocations stay where they are and the rest of the frame uses a larger block
+	size_t blockSize = m_Blocks.empty() ? m_InitialSize : m_Blocks.back().Size * 2;
+	if (blockSize < size + alignment)
+		blockSize = size + alignment;
+	AddBlock(blockSize);
+
+	return Allocate(size, alignment);
+}
+
+std::string_view FrameArena::Copy(std::string_view text)
+{
+	char* memory = Allocate<char>(text.size());
+	memcpy(memory, text.data(), text.size());
+	return std::string_view(memory, text.size());
+}
+
+void FrameArena::Reset()
+{
+	// a single block big enough for the whole frame replaces the blocks it needed
+	if (m_Blocks.size() > 1)
+	{
+		size_t total = 0;
+		for (Block& block : m_Blocks)
+		{
+			total += block.Size;
+			delete[] block.Memory;
+		}
+		m_Blocks.clear();
+		AddBlock(total);
+	}
+
+	m_Offset = 0;
+	m_Used = 0;
+}
+
+size_t FrameArena::GetUsed()
+{
+	return m_Used + m_Offset;
+}
+
+size_t FrameArena::GetCapacity()
+{
+	size_t capacity = 0;
+	for (Block& block : m_Blocks)
+		capacity += block.Size;
+	return capacity;
+}
+
+void FrameArena::AddBlock(size_t size)
+{
+	if (!m_Blocks.empty())
+		m_Used += m_Offset;
+
+	Block block;
+	block.Memory = new unsigned char[size];
+	block.Size = size;
+	m_Blocks.push_back(block);
+	m_Offset = 0;
+}
+
+unsigned long long FrameArena::GetHeapAllocationCount()
+{
+#ifdef GRAPHICS_COUNT_ALLOCATIONS
+	return HeapAllocations;
+#else
+	return 0;
+#endif
+}
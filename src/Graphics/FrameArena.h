@@ -0,0 +1,62 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of a frame
+// Allocations are a pointer increment into a block, and are all released at once by Reset()
+// A frame that outgrows the arena leaves it with a single block large enough for the whole frame, so steady frames never touch the heap
+class FrameArena
+{
+public:
+	// initialSize is the size of the first block in bytes, allocated on first use
+	FrameArena(size_t initialSize = 64 * 1024);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// allocate size bytes, valid until the next Reset()
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	// allocate an uninitialized array of count values
+	template<typename T>
+	T* Allocate(size_t count)
+	{
+		return (T*)Allocate(sizeof(T) * count, alignof(T));
+	}
+
+	// copy text into the arena, valid until the next Reset()
+	std::string_view Copy(std::string_view text);
+
+	// release every allocation, merging the blocks of a frame that outgrew the arena into one
+	void Reset();
+
+	// bytes allocated since the last Reset(), and bytes the arena holds
+	size_t GetUsed();
+	size_t GetCapacity();
+
+	// heap allocations made on the calling thread so far
+	// * only counted with GRAPHICS_COUNT_ALLOCATIONS defined, which replaces the global operator new, 0 otherwise
+	static unsigned long long GetHeapAllocationCount();
+
+private:
+	struct Block
+	{
+		unsigned char* Memory = nullptr;
+		size_t Size = 0;
+	};
+
+	// private helper functions
+	void AddBlock(size_t size);
+
+private:
+	std::vector<Block> m_Blocks;	// allocations come from the last block
+	size_t m_Offset = 0;			// bytes used in the last block
+	size_t m_Used = 0;				// bytes used in the blocks before the last
+	size_t m_InitialSize = 0;
+};
+
+#endif
@@ -0,0 +1,300 @@
+#include "GlyphCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+GlyphCache::GlyphCache(int pageSize, int maxPages)
+	: m_PageSize(pageSize), m_MaxPages(std::max(maxPages, 1))
+{
+}
+
+int GlyphCache::LoadFont(const std::string& fontPath)
+{
+	std::ifstream fin(fontPath, std::ios::binary);
+	if (fin.fail())
+	{
+		std::cout << "Error: TrueType font at " << fontPath << " not found!" << std::endl;
+		return -1;
+	}
+
+	Font font;
+	font.FileData.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+
+	int offset = stbtt_GetFontOffsetForIndex(font.FileData.data(), 0);
+	if (offset < 0 || !stbtt_InitFont(&font.Info, font.FileData.data(), offset))
+	{
+		std::cout << "Error: " << fontPath << " is not a valid TrueType font!" << std::endl;
+		return -1;
+	}
+	stbtt_GetFontVMetrics(&font.Info, &font.Ascent, &font.Descent, &font.LineGap);
+
+	// moving the font keeps the file data buffer, so the font info stays valid
+	m_Fonts.push_back(std::move(font));
+	return (int)m_Fonts.size() - 1;
+}
+
+const CachedGlyph* GlyphCache::GetGlyph(int font, int pixelHeight, uint32_t codepoint)
+{
+	if (font < 0 || font >= (int)m_Fonts.size() || pixelHeight <= 0)
+		return nullptr;
+
+	m_UseCount++;
+
+	uint64_t key = GlyphKey(font, pixelHeight, codepoint);
+	auto found = m_Glyphs.find(key);
+	if (found != m_Glyphs.end())
+	{	// hit, keep the page alive
+		if (found->second.second >= 0)
+			m_Pages[found->second.second].LastUsed = m_UseCount;
+		return &found->second.first;
+	}
+
+	Font& fontData = m_Fonts[font];
+	float scale = stbtt_ScaleForPixelHeight(&fontData.Info, (float)pixelHeight);
+
+	CachedGlyph glyph;
+	glyph.Index = stbtt_FindGlyphIndex(&fontData.Info, (int)codepoint);
+
+	int advance = 0, leftBearing = 0;
+	stbtt_GetGlyphHMetrics(&fontData.Info, glyph.Index, &advance, &leftBearing);
+	glyph.Advance = advance * scale;
+
+	int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+	stbtt_GetGlyphBitmapBox(&fontData.Info, glyph.Index, scale, scale, &x0, &y0, &x1, &y1);
+	glyph.OffsetX = (float)x0;
+	glyph.OffsetY = (float)y0;
+
+	int width = x1 - x0;
+	int height = y1 - y0;
+	int pageIndex = -1;
+	if (width > 0 && height > 0)
+	{
+		int x = 0, y = 0;
+		if (!Allocate(width + GLYPH_PADDING * 2, height + GLYPH_PADDING * 2, pageIndex, x, y))
+			return nullptr;
+
+		// rasterize and upload only the glyph rectangle
+		m_Bitmap.assign(width * height, 0);
+		stbtt_MakeGlyphBitmap(&fontData.Info, m_Bitmap.data(), width, height, width, scale, scale, glyph.Index);
+
+		Page& page = m_Pages[pageIndex];
+		page.Atlas->Bind();
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x + GLYPH_PADDING, y + GLYPH_PADDING, width, height, GL_RED, GL_UNSIGNED_BYTE, m_Bitmap.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		page.LastUsed = m_UseCount;
+		glyph.Page = page.Atlas;
+		glyph.Quad = glm::vec4(x + GLYPH_PADDING, y + GLYPH_PADDING, width, height);
+	}
+
+	auto inserted = m_Glyphs.emplace(key, std::make_pair(glyph, pageIndex));
+	return &inserted.first->second.first;
+}
+
+float GlyphCache::GetAscent(int font, int pixelHeight)
+{
+	if (font < 0 || font >= (int)m_Fonts.size())
+		return 0.f;
+
+	Font& fontData = m_Fonts[font];
+	return fontData.Ascent * stbtt_ScaleForPixelHeight(&fontData.Info, (float)pixelHeight);
+}
+
+float GlyphCache::GetLineHeight(int font, int pixelHeight)
+{
+	if (font < 0 || font >= (int)m_Fonts.size())
+		return 0.f;
+
+	Font& fontData = m_Fonts[font];
+	return (fontData.Ascent - fontData.Descent + fontData.LineGap) * stbtt_ScaleForPixelHeight(&fontData.Info, (float)pixelHeight);
+}
+
+float GlyphCache::GetKerning(int font, int pixelHeight, const CachedGlyph& left, const CachedGlyph& right)
+{
+	if (font < 0 || font >= (int)m_Fonts.size())
+		return 0.f;
+
+	Font& fontData = m_Fonts[font];
+	return stbtt_GetGlyphKernAdvance(&fontData.Info, left.Index, right.Index) * stbtt_ScaleForPixelHeight(&fontData.Info, (float)pixelHeight);
+}
+
+void GlyphCache::SetEvictCallback(std::function<void()> callback)
+{
+	m_EvictCallback = callback;
+}
+
+unsigned int GlyphCache::GetGeneration()
+{
+	return m_Generation;
+}
+
+void GlyphCache::Clean()
+{
+	for (Page& page : m_Pages)
+	{
+		page.Atlas->GetTexture().Clean();
+		delete page.Atlas;
+	}
+
+	m_Pages.clear();
+	m_Glyphs.clear();
+	m_Generation++;
+}
+
+uint32_t GlyphCache::DecodeUTF8(std::string_view text, size_t& index)
+{
+	const uint32_t REPLACEMENT = 0xFFFD;
+
+	unsigned char lead = (unsigned char)text[index++];
+	if (lead < 0x80)
+		return lead;
+
+	// sequence length and payload bits of the lead byte
+	int length = 0;
+	uint32_t codepoint = 0;
+	if ((lead & 0xE0) == 0xC0)
+	{
+		length = 2;
+		codepoint = lead & 0x1F;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		length = 3;
+		codepoint = lead & 0x0F;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		length = 4;
+		codepoint = lead & 0x07;
+	}
+	else
+		return REPLACEMENT;
+
+	if (index + length - 1 > text.size())
+		return REPLACEMENT;
+
+	for (int i = 1; i < length; i++)
+	{
+		unsigned char next = (unsigned char)text[index];
+		if ((next & 0xC0) != 0x80)
+			return REPLACEMENT;
+
+		codepoint = (codepoint << 6) | (next & 0x3F);
+		index++;
+	}
+
+	// reject overlong encodings, surrogates and values past the unicode range
+	const uint32_t minimum[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+	if (codepoint < minimum[length] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+		return REPLACEMENT;
+
+	return codepoint;
+}
+
+bool GlyphCache::Allocate(int width, int height, int& page, int& x, int& y)
+{
+	if (width > m_PageSize || height > m_PageSize)
+		return false;
+
+	// try the existing pages first
+	for (int i = 0; i < (int)m_Pages.size(); i++)
+	{
+		if (Fit(m_Pages[i], width, height, x, y))
+		{
+			page = i;
+			return true;
+		}
+	}
+
+	// then a new page, then the least recently used one
+	page = (int)m_Pages.size() < m_MaxPages ? AddPage() : EvictPage();
+	return Fit(m_Pages[page], width, height, x, y);
+}
+
+bool GlyphCache::Fit(Page& page, int width, int height, int& x, int& y)
+{
+	int cursorX = page.CursorX;
+	int cursorY = page.CursorY;
+	int shelfHeight = page.ShelfHeight;
+
+	// start a new shelf when the current one is out of room
+	if (cursorX + width > m_PageSize)
+	{
+		cursorX = 0;
+		cursorY += shelfHeight;
+		shelfHeight = 0;
+	}
+
+	if (cursorY + height > m_PageSize)
+		return false;
+
+	x = cursorX;
+	y = cursorY;
+
+	page.CursorX = cursorX + width;
+	page.CursorY = cursorY;
+	page.ShelfHeight = std::max(shelfHeight, height);
+	return true;
+}
+
+int GlyphCache::AddPage()
+{
+	// cleared pages, so padding around glyphs is always empty
+	std::vector<unsigned char> empty(m_PageSize * m_PageSize, 0);
+
+	Page page;
+	page.Atlas = new TextureAtlas(empty.data(), m_PageSize, m_PageSize, 1);
+
+	// sample the coverage as white with alpha, so pages draw through the regular texture shader
+	const GLint swizzle[4] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+	page.Atlas->Bind();
+	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+
+	m_Pages.push_back(page);
+	return (int)m_Pages.size() - 1;
+}
+
+int GlyphCache::EvictPage()
+{
+	int oldest = 0;
+	for (int i = 1; i < (int)m_Pages.size(); i++)
+	{
+		if (m_Pages[i].LastUsed < m_Pages[oldest].LastUsed)
+			oldest = i;
+	}
+
+	// let queued quads sampling the page draw before it changes
+	if (m_EvictCallback)
+		m_EvictCallback();
+
+	for (auto it = m_Glyphs.begin(); it != m_Glyphs.end();)
+	{
+		if (it->second.second == oldest)
+			it = m_Glyphs.erase(it);
+		else
+			++it;
+	}
+
+	std::vector<unsigned char> empty(m_PageSize * m_PageSize, 0);
+	Page& page = m_Pages[oldest];
+	page.Atlas->Bind();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_PageSize, m_PageSize, GL_RED, GL_UNSIGNED_BYTE, empty.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	page.CursorX = 0;
+	page.CursorY = 0;
+	page.ShelfHeight = 0;
+	m_Generation++;
+
+	return oldest;
+}
+
+uint64_t GlyphCache::GlyphKey(int font, int pixelHeight, uint32_t codepoint)
+{
+	// 21 bits hold every codepoint, leaving 16 bits of pixel height and 27 of font handle
+	return ((uint64_t)font << 37) | ((uint64_t)(pixelHeight & 0xFFFF) << 21) | (codepoint & 0x1FFFFF);
+}
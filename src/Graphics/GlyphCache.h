@@ -0,0 +1,110 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include "TextureAtlas.h"
+
+#include <stb_truetype/stb_truetype.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Glyph rasterized into a page of a GlyphCache
+struct CachedGlyph
+{
+	TextureAtlas* Page = nullptr;	// page holding the glyph, nullptr for glyphs without pixels like spaces
+	glm::vec4 Quad = glm::vec4(0.f);	// pixel rectangle of the glyph in the page, (x, y, width, height)
+	float OffsetX = 0.f;			// offset from the pen position to the left edge of the glyph
+	float OffsetY = 0.f;			// offset from the baseline to the top edge of the glyph, negative is up
+	float Advance = 0.f;			// pen movement to the next glyph
+	int Index = 0;					// glyph index in the font, used for kerning
+};
+
+// Cache of TrueType glyphs, rasterized the first time they are used
+// Glyphs of every font and size share single channel pages, each page is a TextureAtlas claiming one texture unit
+// When every page is full the least recently used page is cleared and reused, so memory follows the glyphs actually drawn
+class GlyphCache
+{
+public:
+	GlyphCache() = default;
+	// pageSize is the width and height of every page in pixels, pages are only created when needed
+	GlyphCache(int pageSize, int maxPages);
+
+	// load a TrueType font file, returns its handle or -1 when the file could not be read
+	int LoadFont(const std::string& fontPath);
+
+	// find a glyph of a font at a pixel height, rasterizing it on first use
+	// returns nullptr for unknown fonts and glyphs larger than a page
+	const CachedGlyph* GetGlyph(int font, int pixelHeight, uint32_t codepoint);
+
+	// distance from the top of a line to the baseline in pixels
+	float GetAscent(int font, int pixelHeight);
+	// distance between two baselines in pixels
+	float GetLineHeight(int font, int pixelHeight);
+	// pen adjustment between two glyphs in pixels
+	float GetKerning(int font, int pixelHeight, const CachedGlyph& left, const CachedGlyph& right);
+
+	// called before a page is reused, so quads still sampling it can be drawn first
+	void SetEvictCallback(std::function<void()> callback);
+
+	// changes every time a page is reused, glyph quads laid out with an older generation are stale
+	unsigned int GetGeneration();
+
+	// delete all page textures
+	void Clean();
+
+	// decode the utf-8 codepoint starting at index and move index past it
+	// invalid or truncated sequences decode to U+FFFD one byte at a time
+	static uint32_t DecodeUTF8(std::string_view text, size_t& index);
+
+private:
+	// loaded font file, the font info points into the file data
+	struct Font
+	{
+		std::vector<unsigned char> FileData;
+		stbtt_fontinfo Info;
+		int Ascent = 0, Descent = 0, LineGap = 0;	// unscaled vertical metrics
+	};
+
+	// atlas page filled shelf by shelf, left to right
+	struct Page
+	{
+		TextureAtlas* Atlas = nullptr;
+		int CursorX = 0;
+		int CursorY = 0;
+		int ShelfHeight = 0;
+		uint64_t LastUsed = 0;
+	};
+
+	// private helper functions
+	bool Allocate(int width, int height, int& page, int& x, int& y);
+	bool Fit(Page& page, int width, int height, int& x, int& y);
+	int AddPage();
+	int EvictPage();
+
+	static uint64_t GlyphKey(int font, int pixelHeight, uint32_t codepoint);
+
+private:
+	// free pixels around every glyph, so linear filtering never reads a neighbour
+	static const int GLYPH_PADDING = 1;
+
+	int m_PageSize = 1024;
+	int m_MaxPages = 4;
+
+	std::vector<Font> m_Fonts;
+	std::vector<Page> m_Pages;
+
+	// glyphs by font, pixel height and codepoint, with the page they live in
+	std::unordered_map<uint64_t, std::pair<CachedGlyph, int>> m_Glyphs;
+
+	std::function<void()> m_EvictCallback;
+	std::vector<unsigned char> m_Bitmap;	// reused rasterization buffer
+
+	uint64_t m_UseCount = 0;
+	unsigned int m_Generation = 0;
+};
+
+#endif
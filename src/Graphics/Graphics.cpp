@@ -1,4 +1,10 @@
 #include "Graphics.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 
 namespace Graphics {
 
@@ -10,631 +16,1977 @@ namespace Graphics {
 		 1.f,  1.f,  1.0f,  1.0f  // 3
 	};
 
-	GraphicsData Data;
+	// state of the default context, used by threads that have no context current
+	static GraphicsData DefaultData;
+
+	// context current on the calling thread, nullptr for the default context, and the state of that context
+	static thread_local Context* CurrentContext = nullptr;
+	static thread_local GraphicsData* Data = &DefaultData;
+
+	// Append a single interleaved (x, y, r, g, b) vertex to a shape stream
+	static inline void PushShapeVertex(std::vector<float>& stream, float x, float y, float red, float green, float blue)
+	{
+		stream.push_back(x);
+		stream.push_back(y);
+		stream.push_back(red);
+		stream.push_back(green);
+		stream.push_back(blue);
+	}
+
+	// Create a vao and stream buffer for vertices starting with an interleaved (x, y, r, g, b)
+	// floatsPerVertex allows extra per-vertex data after the color
+	static void CreateColorVertexStream(unsigned int& vao, StreamBuffer& buffer, unsigned int floatsPerVertex = 5)
+	{
+		glGenVertexArrays(1, &vao);
+		buffer = StreamBuffer(GL_ARRAY_BUFFER);
+
+		glBindVertexArray(vao);
+
+		glBindBuffer(GL_ARRAY_BUFFER, buffer.GetID());
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * floatsPerVertex, (void*)0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * floatsPerVertex, (void*)(2 * sizeof(GL_FLOAT)));
+		glEnableVertexAttribArray(0);
+		glEnableVertexAttribArray(1);
+	}
+
+	// Upload the recorded line vertices and draw them as line pairs
+	static void DrawLineVertices()
+	{
+		// draw queued shapes first to keep submission order
+		FlushShapes();
+
+		unsigned int size = sizeof(GL_FLOAT) * (unsigned int)Data->LineVertices.size();
+
+		glBindVertexArray(Data->LineVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, Data->LineBuffer.GetID());
+		unsigned int offset = Data->LineBuffer.Upload(Data->LineVertices.data(), size, sizeof(GL_FLOAT) * 5);
+
+		// bind shader
+		Data->ShapeShader->use();
+
+		// issue draw call, 5 floats per vertex
+		glDrawArrays(GL_LINES, offset / (sizeof(GL_FLOAT) * 5), (unsigned int)Data->LineVertices.size() / 5);
+
+		Data->LineVertices.clear();
+	}
+
+	// Upload the recorded point vertices and draw them
+	// pointSize is only used without a point shader
+	static void DrawPointVertices(unsigned int pointSize)
+	{
+		// draw queued shapes first to keep submission order
+		FlushShapes();
+
+		unsigned int size = sizeof(GL_FLOAT) * (unsigned int)Data->PointVertices.size();
+
+		glBindVertexArray(Data->PointVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, Data->PointBuffer.GetID());
+		unsigned int offset = Data->PointBuffer.Upload(Data->PointVertices.data(), size, sizeof(GL_FLOAT) * 7);
+
+		if (Data->PointShader)
+		{	// the point shader writes every point's own size
+			glEnable(GL_PROGRAM_POINT_SIZE);
+			Data->PointShader->use();
+		}
+		else
+		{
+			// set point size
+			glPointSize((float)pointSize);
+			// bind shader
+			Data->ShapeShader->use();
+		}
+
+		// issue draw call, 7 floats per vertex
+		glDrawArrays(GL_POINTS, offset / (sizeof(GL_FLOAT) * 7), (unsigned int)Data->PointVertices.size() / 7);
+
+		if (Data->PointShader)
+			glDisable(GL_PROGRAM_POINT_SIZE);
+
+		Data->PointVertices.clear();
+	}
+
+	// Hash of the text cache key of a string printed at a scale and rotation with a font (FNV-1a)
+	static uint64_t TextCacheHash(std::string_view text, float scale, float rotation, int font, float fontSize)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		auto add = [&hash](const void* data, size_t size)
+		{
+			const unsigned char* bytes = (const unsigned char*)data;
+			for (size_t i = 0; i < size; i++)
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+		};
+
+		add(text.data(), text.size());
+		add(&scale, sizeof(float));
+		add(&rotation, sizeof(float));
+		add(&font, sizeof(int));
+		add(&fontSize, sizeof(float));
+		return hash;
+	}
+
+	static uint64_t TextCacheHash(const TextBlob& blob)
+	{
+		return TextCacheHash(blob.Text, blob.Scale, blob.Rotation, blob.Font, blob.FontSize);
+	}
+
+	// Add a cached blob to the lookup table, the table always has free slots
+	static void InsertTextCacheBlob(std::list<TextBlob>::iterator blob)
+	{
+		std::vector<TextCacheSlot>& slots = Data->TextCacheLookup;
+		size_t mask = slots.size() - 1;
+		uint64_t hash = TextCacheHash(*blob);
+
+		size_t i = hash & mask;
+		while (slots[i].Used)
+			i = (i + 1) & mask;
+
+		slots[i].Hash = hash;
+		slots[i].Blob = blob;
+		slots[i].Used = true;
+	}
+
+	// Remove a cached blob from the lookup table
+	static void EraseTextCacheBlob(std::list<TextBlob>::iterator blob)
+	{
+		std::vector<TextCacheSlot>& slots = Data->TextCacheLookup;
+		size_t mask = slots.size() - 1;
+
+		size_t hole = TextCacheHash(*blob) & mask;
+		while (!(slots[hole].Used && slots[hole].Blob == blob))
+			hole = (hole + 1) & mask;
+
+		// shift the following slots back into the hole, so no probe sequence is cut short
+		for (size_t i = (hole + 1) & mask; slots[i].Used; i = (i + 1) & mask)
+		{
+			size_t home = slots[i].Hash & mask;
+			if (((i - home) & mask) >= ((i - hole) & mask))
+			{
+				slots[hole] = slots[i];
+				hole = i;
+			}
+		}
+		slots[hole].Used = false;
+	}
+
+	// Find the cached blob of a string printed with the active font, returns the end of the cache when it isn't cached
+	static std::list<TextBlob>::iterator FindTextCacheBlob(std::string_view text, float scale, float rotation)
+	{
+		std::vector<TextCacheSlot>& slots = Data->TextCacheLookup;
+		size_t mask = slots.size() - 1;
+		uint64_t hash = TextCacheHash(text, scale, rotation, Data->ActiveFont, Data->ActiveFontSize);
+
+		for (size_t i = hash & mask; slots[i].Used; i = (i + 1) & mask)
+		{
+			const TextBlob& blob = *slots[i].Blob;
+			if (slots[i].Hash == hash && blob.Text == text && blob.Scale == scale && blob.Rotation == rotation
+				&& blob.Font == Data->ActiveFont && blob.FontSize == Data->ActiveFontSize)
+				return slots[i].Blob;
+		}
+		return Data->TextCache.end();
+	}
+
+	// Size the lookup table for the cache capacity and fill it with the cached blobs
+	// * the table is at most half full, so probes stay short and a miss never allocates
+	static void RebuildTextCacheLookup()
+	{
+		size_t size = 16;
+		while (size < (size_t)Data->TextCacheCapacity * 2)
+			size *= 2;
+		Data->TextCacheLookup.assign(size, TextCacheSlot());
+
+		for (auto blob = Data->TextCache.begin(); blob != Data->TextCache.end(); blob++)
+			InsertTextCacheBlob(blob);
+	}
+
+	// Renderer drawing the glyphs of a font, TrueType pages draw through the regular renderer
+	static inline TextureRenderer* FontRenderer(int font)
+	{
+		return font < 0 && Data->isFontSDF ? Data->SDFTextRenderer : Data->Renderer;
+	}
+
+	// Lay out utf-8 text with a TrueType font, relative to the top left of the line
+	// emit(glyph, centerX, centerY, rotationOffsetX, rotationOffsetY) is called for every glyph with pixels
+	template<typename Emit>
+	static void LayoutTrueType(std::string_view text, int font, float fontSize, float scale, Emit emit)
+	{
+		int pixelHeight = std::max((int)(fontSize * scale + 0.5f), 1);
+		float ascent = Data->Glyphs->GetAscent(font, pixelHeight);
+		float pivotY = Data->Glyphs->GetLineHeight(font, pixelHeight) / 2.f;
+
+		float penX = 0.f;
+		CachedGlyph previous;
+		bool hasPrevious = false;
+
+		size_t i = 0;
+		while (i < text.size())
+		{
+			const CachedGlyph* found = Data->Glyphs->GetGlyph(font, pixelHeight, GlyphCache::DecodeUTF8(text, i));
+			if (!found)
+			{
+				hasPrevious = false;
+				continue;
+			}
+
+			// copied, a later miss may reuse the page the glyph lives in
+			CachedGlyph glyph = *found;
+			if (hasPrevious)
+				penX += Data->Glyphs->GetKerning(font, pixelHeight, previous, glyph);
+
+			if (glyph.Page)
+			{	// glyphs were rasterized on whole pixels, keep them there
+				float centerX = floorf(penX + 0.5f) + glyph.OffsetX + glyph.Quad.z / 2.f;
+				float centerY = ascent + glyph.OffsetY + glyph.Quad.w / 2.f;
+				emit(glyph, centerX, centerY, -centerX, pivotY - centerY);
+			}
+
+			penX += glyph.Advance;
+			previous = glyph;
+			hasPrevious = true;
+		}
+	}
+
+	// Record vertices appended to a shape stream, merging them into the last run when the type matches
+	static void AddShapeRun(ShapeRunType type, unsigned int first, unsigned int count)
+	{
+		if (!Data->ShapeRuns.empty() && Data->ShapeRuns.back().Type == type)
+		{
+			Data->ShapeRuns.back().Count += count;
+			return;
+		}
+
+		Data->ShapeRuns.push_back({ type, first, count });
+	}
+
+	// Queue a single analytic shape instance
+	static void PushAnalyticShape(float x, float y, float halfWidth, float halfHeight, float cornerRadius, float thickness, float rotation, float red, float green, float blue)
+	{
+		// Analytic shapes need their shader, see InitAnalyticShapes()
+		assert(Data->AnalyticShader != nullptr);
+
+		float instance[10] = {
+			x, y, halfWidth, halfHeight, cornerRadius, thickness, rotation, red, green, blue
+		};
+
+		unsigned int first = (unsigned int)Data->AnalyticInstances.size() / 10;
+		Data->AnalyticInstances.insert(Data->AnalyticInstances.end(), instance, instance + 10);
+
+		AddShapeRun(SHAPE_RUN_ANALYTIC, first, 1);
+	}
 
 	void Init(Shader* shapeShader, Shader* renderShader)
 	{
-		Data.RenderShader = renderShader;
-		Data.Renderer = new TextureRenderer(renderShader);
+		Data->RenderShader = renderShader;
+		Data->Renderer = new TextureRenderer(renderShader);
 
 		// Init shader
-		Data.ShapeShader = shapeShader;
+		Data->ShapeShader = shapeShader;
 		
-		// Create vertex array
-		glGenVertexArrays(1, &Data.VAO);
+		// Create the deferred shape stream, line batch and point batch vaos and vbos
+		CreateColorVertexStream(Data->ShapeVAO, Data->ShapeBuffer);
+		CreateColorVertexStream(Data->LineVAO, Data->LineBuffer);
+		CreateColorVertexStream(Data->PointVAO, Data->PointBuffer, 7);
 
-		// Create vbo
-		glGenBuffers(1, &Data.VBO);
+		// points carry a size and shape after the color
+		glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 7, (void*)(5 * sizeof(GL_FLOAT)));
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 7, (void*)(6 * sizeof(GL_FLOAT)));
+		glEnableVertexAttribArray(2);
+		glEnableVertexAttribArray(3);
 
-		// Bind vertex array
-		glBindVertexArray(Data.VAO);
+		// Clean up and unbind everything
+		glBindVertexArray(0);
+	}
 
-		// Bind and set up vbo
-		glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 2, NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 2, (void*)0);
-		glEnableVertexAttribArray(0);
+	// Copy loaded font metrics into Data
+	static void ApplyFontMetrics(const FontMetrics& metrics)
+	{
+		Data->FontCellWidth = metrics.CellWidth;
+		Data->FontCellHeight = metrics.CellHeight;
+		Data->FontStartingChar = metrics.StartChar;
+		std::copy(metrics.Widths, metrics.Widths + 256, Data->FontWidths);
+		std::copy(metrics.Bearings, metrics.Bearings + 256, Data->FontBearings);
+		Data->FontKerning = metrics.Kerning;
+
+		// blobs laid out with a previous font are stale
+		Data->TextCache.clear();
+		RebuildTextCacheLookup();
+	}
 
-		// Create color vbo
-		glGenBuffers(1, &Data.ColorVBO);
+	// Replace the font atlas, releasing the previous one
+	static void SetFontAtlas(TextureAtlas* atlas, bool isSDF)
+	{
+		if (Data->FontAtlas)
+		{
+			Data->FontAtlas->GetTexture().Clean();
+			delete Data->FontAtlas;
+		}
 
-		// bind and set up color vbo
-		glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3, NULL, GL_DYNAMIC_DRAW);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 3, (void*)0);
-		glEnableVertexAttribArray(1);
+		// the new atlas may get the address of the old one, so bulk text tracks the generation instead
+		Data->FontAtlas = atlas;
+		Data->isFontSDF = isSDF;
+		Data->FontGeneration++;
+	}
 
-		// Clean up and unbind everything
-		glBindVertexArray(0);
+	// Squared distance transform of a sampled function along one row or column (Felzenszwalb and Huttenlocher)
+	// v and z are scratch arrays of n and n + 1 elements
+	static void DistanceTransform1D(const float* f, float* d, int n, int* v, float* z)
+	{
+		const float INF = 1e20f;
+
+		// lower envelope of the parabolas rooted at every sample
+		int k = 0;
+		v[0] = 0;
+		z[0] = -INF;
+		z[1] = INF;
+		for (int q = 1; q < n; q++)
+		{
+			float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+			while (s <= z[k])
+			{
+				k--;
+				s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+			}
+			k++;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = INF;
+		}
+
+		// sample the envelope
+		k = 0;
+		for (int q = 0; q < n; q++)
+		{
+			while (z[k + 1] < q)
+				k++;
+			d[q] = (float)((q - v[k]) * (q - v[k])) + f[v[k]];
+		}
+	}
+
+	// Replace every value of a grid with the squared distance to the nearest 0 value, other values should be 1e20
+	static void DistanceTransform2D(std::vector<float>& grid, int width, int height)
+	{
+		int n = std::max(width, height);
+		std::vector<float> f(n), d(n), z(n + 1);
+		std::vector<int> v(n);
+
+		// columns, then rows of the column result
+		for (int x = 0; x < width; x++)
+		{
+			for (int y = 0; y < height; y++)
+				f[y] = grid[y * width + x];
+			DistanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+			for (int y = 0; y < height; y++)
+				grid[y * width + x] = d[y];
+		}
+
+		for (int y = 0; y < height; y++)
+		{
+			DistanceTransform1D(&grid[y * width], d.data(), width, v.data(), z.data());
+			std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+		}
+	}
+
+	// Convert an RGBA glyph atlas into a single channel signed distance field
+	// The field is 0.5 on glyph edges, rising to 1 at spread pixels inside, each cell is transformed alone so glyphs never bleed into their neighbours
+	static std::vector<unsigned char> BuildDistanceField(const unsigned char* pixels, int width, int height, int cellWidth, int cellHeight, int spread)
+	{
+		// glyphs are the opaque pixels when the image has transparency, the bright pixels otherwise
+		bool useAlpha = false;
+		for (int i = 0; i < width * height && !useAlpha; i++)
+			useAlpha = pixels[i * 4 + 3] < 255;
+
+		std::vector<unsigned char> field(width * height, 0);
+		std::vector<float> toGlyph(cellWidth * cellHeight);
+		std::vector<float> toBackground(cellWidth * cellHeight);
+
+		for (int cellY = 0; cellY + cellHeight <= height; cellY += cellHeight)
+		{
+			for (int cellX = 0; cellX + cellWidth <= width; cellX += cellWidth)
+			{
+				for (int y = 0; y < cellHeight; y++)
+				{
+					for (int x = 0; x < cellWidth; x++)
+					{
+						const unsigned char* pixel = pixels + ((cellY + y) * width + cellX + x) * 4;
+						int coverage = useAlpha ? pixel[3] : (pixel[0] + pixel[1] + pixel[2]) / 3;
+
+						bool inside = coverage >= 128;
+						toGlyph[y * cellWidth + x] = inside ? 0.f : 1e20f;
+						toBackground[y * cellWidth + x] = inside ? 1e20f : 0.f;
+					}
+				}
+
+				DistanceTransform2D(toGlyph, cellWidth, cellHeight);
+				DistanceTransform2D(toBackground, cellWidth, cellHeight);
+
+				for (int y = 0; y < cellHeight; y++)
+				{
+					for (int x = 0; x < cellWidth; x++)
+					{
+						// positive inside the glyph
+						float distance = sqrtf(toBackground[y * cellWidth + x]) - sqrtf(toGlyph[y * cellWidth + x]);
+						float value = std::min(std::max(0.5f + distance / (2.f * spread), 0.f), 1.f);
+						field[(cellY + y) * width + cellX + x] = (unsigned char)(value * 255.f + 0.5f);
+					}
+				}
+			}
+		}
+
+		return field;
+	}
+
+	bool LoadFont(std::string fontImagePath, std::string fontDataPath)
+	{
+		TRACE_ZONE("Graphics::LoadFont");
+		CaptureScope capture(Data->Recorder, CAPTURE_LOAD_FONT);
+		if (capture)
+			capture->Record(fontImagePath, fontDataPath);
+
+		FontMetrics metrics;
+		if (!metrics.Load(fontDataPath))
+			return false;
+
+		TextureAtlas* atlas = new TextureAtlas(fontImagePath, metrics.ImageWidth / metrics.CellWidth, metrics.ImageHeight / metrics.CellHeight);
+		if (atlas->GetTextureWidth() == 0)
+		{	// Texture already printed the error, the previous font stays loaded
+			atlas->GetTexture().Clean();
+			delete atlas;
+
+			// hand back the texture unit the atlas claimed
+			TextureAtlas::GetAtlasCount()--;
+			return false;
+		}
+
+		SetFontAtlas(atlas, false);
+		ApplyFontMetrics(metrics);
+
+		return true;
+	}
+
+	bool ConvertFontData(std::string csvPath, std::string binaryPath)
+	{
+		FontMetrics metrics;
+		return metrics.Load(csvPath) && metrics.Save(binaryPath);
+	}
+
+	void InitSDFText(Shader* sdfTextShader)
+	{
+		Data->SDFTextShader = sdfTextShader;
+		Data->SDFTextRenderer = new TextureRenderer(sdfTextShader);
+	}
+
+	bool LoadSDFFont(std::string fontImagePath, std::string fontDataPath, int spread)
+	{
+		TRACE_ZONE("Graphics::LoadSDFFont");
+		CaptureScope capture(Data->Recorder, CAPTURE_LOAD_SDF_FONT);
+		if (capture)
+			capture->Record(fontImagePath, fontDataPath, spread);
+
+		// Distance field fonts need their own renderer, see InitSDFText()
+		assert(Data->SDFTextRenderer != nullptr);
+
+		FontMetrics metrics;
+		if (!metrics.Load(fontDataPath))
+			return false;
+
+		// always read as RGBA, the coverage is taken from alpha or brightness
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		unsigned char* pixels = stbi_load(fontImagePath.c_str(), &width, &height, &channels, 4);
+		if (!pixels)
+		{
+			std::cout << "Error: Font image path at " << fontImagePath << " not found!" << std::endl;
+			return false;
+		}
+
+		std::vector<unsigned char> field = BuildDistanceField(pixels, width, height, metrics.CellWidth, metrics.CellHeight, spread);
+		stbi_image_free(pixels);
+
+		SetFontAtlas(new TextureAtlas(field.data(), width, height, 1, metrics.ImageWidth / metrics.CellWidth, metrics.ImageHeight / metrics.CellHeight), true);
+		ApplyFontMetrics(metrics);
+
+		return true;
+	}
+
+	void InitGlyphCache(int pageSize, int maxPages)
+	{
+		if (Data->Glyphs)
+		{
+			Data->Glyphs->Clean();
+			delete Data->Glyphs;
+		}
+
+		Data->Glyphs = new GlyphCache(pageSize, maxPages);
+
+		// quads of a page have to be drawn before the page is reused
+		Data->Glyphs->SetEvictCallback([]() { Data->Renderer->Flush(); });
+	}
+
+	int LoadTrueTypeFont(std::string fontPath)
+	{
+		TRACE_ZONE("Graphics::LoadTrueTypeFont");
+		CaptureScope capture(Data->Recorder, CAPTURE_LOAD_TRUETYPE_FONT);
+		if (capture)
+			capture->Record(fontPath);
+
+		if (!Data->Glyphs)
+			InitGlyphCache();
+
+		return Data->Glyphs->LoadFont(fontPath);
+	}
+
+	void SetFont(int font, float pixelHeight)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_SET_FONT);
+		if (capture)
+			capture->Record(font, pixelHeight);
+
+		// TrueType fonts come from LoadTrueTypeFont()
+		assert(font < 0 || Data->Glyphs != nullptr);
+
+		Data->ActiveFont = font;
+		Data->ActiveFontSize = pixelHeight;
+	}
+
+	int GetFont()
+	{
+		return Data->ActiveFont;
+	}
+
+	float GetFontSize()
+	{
+		return Data->ActiveFontSize;
+	}
+
+	float GetLineHeight(float scale)
+	{
+		if (Data->ActiveFont < 0)
+			return std::max(Data->FontCellHeight, 0) * scale;
+
+		// same rounding as the layout, every pixel height is rasterized on its own
+		int pixelHeight = std::max((int)(Data->ActiveFontSize * scale + 0.5f), 1);
+		return Data->Glyphs->GetLineHeight(Data->ActiveFont, pixelHeight);
+	}
+
+	TextureRenderer* GetRenderer()
+	{
+		return Data->Renderer;
+	}
+
+	void Polygon(DrawMode mode, float *vertices, unsigned int vertexCount, float red, float green, float blue)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_POLYGON);
+		if (capture)
+		{
+			capture->Record(mode, vertexCount);
+			capture->Write(vertices, vertexCount * 2);
+			capture->Record(red, green, blue);
+		}
+
+		if (mode == FILL)
+		{	// FILL mode fan triangulates the polygon straight into the fill stream
+			if (vertexCount < 3)
+				return;
+
+			unsigned int first = (unsigned int)Data->ShapeFillVertices.size() / 5;
+			for (unsigned int i = 1; i <= vertexCount - 2; i++)
+			{
+				PushShapeVertex(Data->ShapeFillVertices, vertices[0], vertices[1], red, green, blue);				// core point
+				PushShapeVertex(Data->ShapeFillVertices, vertices[i * 2], vertices[i * 2 + 1], red, green, blue);	// next point according to the triangle index i
+				PushShapeVertex(Data->ShapeFillVertices, vertices[i * 2 + 2], vertices[i * 2 + 3], red, green, blue);	// next clockwise point from index i
+			}
+
+			AddShapeRun(SHAPE_RUN_FILL, first, (vertexCount - 2) * 3);
+		}
+		else
+		{ // LINE mode emits every edge as a line pair, including the closing edge
+			if (vertexCount < 2)
+				return;
+
+			unsigned int first = (unsigned int)Data->ShapeLineVertices.size() / 5;
+			for (unsigned int i = 0; i < vertexCount; i++)
+			{
+				unsigned int next = (i + 1) % vertexCount;
+				PushShapeVertex(Data->ShapeLineVertices, vertices[i * 2], vertices[i * 2 + 1], red, green, blue);
+				PushShapeVertex(Data->ShapeLineVertices, vertices[next * 2], vertices[next * 2 + 1], red, green, blue);
+			}
+
+			AddShapeRun(SHAPE_RUN_LINE, first, vertexCount * 2);
+		}
 	}
 
-	void LoadFont(std::string fontImagePath, std::string fontDataPath)
+	void Circle(DrawMode mode, float x, float y, float radius, float red, float green, float blue, unsigned int precision)
 	{
-		int ImageWidth = 0;
-		int ImageHeight = 0;
+		CaptureScope capture(Data->Recorder, CAPTURE_CIRCLE);
+		if (capture)
+			capture->Record(mode, x, y, radius, red, green, blue, precision);
+
+		// Create needed array of floats with correct size, it only lives for this call
+		float* vertices = Data->Arena.Allocate<float>(precision * 2);
+		
+		// Initialize needed variables
+		unsigned int count = 0;
+		float dx = 0.f;
+		float dy = 0.f;
+		float angle = 0.f;
+		// angle increment calculated through number of degrees per side
+		float angleInc = glm::radians(360.f / (float)precision);
 
-		// read from font files and assemble Data values
-		std::ifstream fin;
-		fin.open(fontDataPath);
-		if (fin.fail())
+		// Loop through all points needed to be created
+		for (unsigned int i = 0; i < precision; i++)
 		{
-			std::cout << "Error: Font data path at " << fontDataPath << " not found!" << std::endl;
-			__debugbreak();
+			// increase the angle
+			angle += angleInc;
+			// find the value of x and y
+			dx = cos(angle) * radius + x;
+			dy = sin(angle) * radius + y;
+
+			// add x and y to the vertex array at the correct place
+			vertices[count] = dx;
+			count++;
+			vertices[count] = dy;
+			count++;
 		}
 
-		std::string line;
-		std::string output[5];
-		std::string suboutput[5];
+		// use polygon to draw
+		Polygon(mode, vertices, precision, red, green, blue);
+	}
+
+	void Rectangle(DrawMode mode, float x, float y, float width, float height, float rotation, float rotOffsetX, float rotOffsetY, float red, float green, float blue)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_RECTANGLE);
+		if (capture)
+			capture->Record(mode, x, y, width, height, rotation, rotOffsetX, rotOffsetY, red, green, blue);
+
+		// Assemble vertex positions
+		float Vertices[8] = {
+			x			, y,			  // top left
+			x + width, y,			  // top right
+			x + width, y + height, // bottom right
+			x			, y + height  // bottom left
+		};
+
+		// Rotate vertex positions
+		if (rotation != 0)
+		{
+			// initialize sin, cos values for performace
+			float sinX = sin(rotation);
+			float cosX = cos(rotation);
+			
+			for (int i = 0; i < 8; i+=2)
+			{
+				float origX = Vertices[i];
+				float origY = Vertices[i + 1];
+				// rotate vertices
+				Vertices[i] = cosX * (origX - x - rotOffsetX) - sinX * (origY - y - rotOffsetY) + x + rotOffsetX;
+				Vertices[i + 1] = sinX * (origX - x - rotOffsetX) + cosX * (origY - y - rotOffsetY) + y + rotOffsetY;
+			}
+		}
+
+		// use polygon to draw
+		Polygon(mode, Vertices, 4, red, green, blue);
+	}
+
+	void InitAnalyticShapes(Shader* analyticShader)
+	{
+		Data->AnalyticShader = analyticShader;
+
+		// corners of the unit quad, drawn as a triangle strip
+		float corners[8] = {
+			-1.f, -1.f,
+			 1.f, -1.f,
+			-1.f,  1.f,
+			 1.f,  1.f
+		};
+
+		glGenVertexArrays(1, &Data->AnalyticVAO);
+		glGenBuffers(1, &Data->AnalyticQuadVBO);
+		Data->AnalyticBuffer = StreamBuffer(GL_ARRAY_BUFFER);
+
+		glBindVertexArray(Data->AnalyticVAO);
+
+		// bind and fill the quad vbo
+		glBindBuffer(GL_ARRAY_BUFFER, Data->AnalyticQuadVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 2, (void*)0);
+		glEnableVertexAttribArray(0);
+
+		// per-instance attributes, pointers are set per run in FlushShapes()
+		glBindBuffer(GL_ARRAY_BUFFER, Data->AnalyticBuffer.GetID());
+		for (unsigned int i = 1; i <= 4; i++)
+		{
+			glEnableVertexAttribArray(i);
+			glVertexAttribDivisor(i, 1);
+		}
+
+		glBindVertexArray(0);
+	}
+
+	void AnalyticCircle(DrawMode mode, float x, float y, float radius, float red, float green, float blue, float lineWidth)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_ANALYTIC_CIRCLE);
+		if (capture)
+			capture->Record(mode, x, y, radius, red, green, blue, lineWidth);
+
+		PushAnalyticShape(x, y, radius, radius, radius, mode == LINE ? lineWidth : 0.f, 0.f, red, green, blue);
+	}
+
+	void AnalyticRing(float x, float y, float radius, float thickness, float red, float green, float blue)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_ANALYTIC_RING);
+		if (capture)
+			capture->Record(x, y, radius, thickness, red, green, blue);
+
+		PushAnalyticShape(x, y, radius, radius, radius, thickness, 0.f, red, green, blue);
+	}
+
+	void AnalyticRoundedRectangle(DrawMode mode, float x, float y, float width, float height, float cornerRadius, float rotation, float rotOffsetX, float rotOffsetY, float red, float green, float blue, float lineWidth)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_ANALYTIC_ROUNDED_RECTANGLE);
+		if (capture)
+			capture->Record(mode, x, y, width, height, cornerRadius, rotation, rotOffsetX, rotOffsetY, red, green, blue, lineWidth);
+
+		// the shape itself rotates around its center, so rotate the center around the rotation origin
+		float centerX = x + width / 2.f;
+		float centerY = y + height / 2.f;
+		if (rotation != 0.f)
+		{
+			float sinX = sin(rotation);
+			float cosX = cos(rotation);
+			float origX = centerX - x - rotOffsetX;
+			float origY = centerY - y - rotOffsetY;
+			centerX = cosX * origX - sinX * origY + x + rotOffsetX;
+			centerY = sinX * origX + cosX * origY + y + rotOffsetY;
+		}
+
+		// corners can't be rounder than half the shortest side
+		float maxRadius = (width < height ? width : height) / 2.f;
+		if (cornerRadius > maxRadius)
+			cornerRadius = maxRadius;
+
+		PushAnalyticShape(centerX, centerY, width / 2.f, height / 2.f, cornerRadius, mode == LINE ? lineWidth : 0.f, rotation, red, green, blue);
+	}
+
+	void AnalyticCapsule(DrawMode mode, float x1, float y1, float x2, float y2, float radius, float red, float green, float blue, float lineWidth)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_ANALYTIC_CAPSULE);
+		if (capture)
+			capture->Record(mode, x1, y1, x2, y2, radius, red, green, blue, lineWidth);
+
+		// a capsule is a rounded box along the segment, with the corner radius at half its height
+		float dx = x2 - x1;
+		float dy = y2 - y1;
+		float length = sqrt(dx * dx + dy * dy);
+
+		PushAnalyticShape((x1 + x2) / 2.f, (y1 + y2) / 2.f, length / 2.f + radius, radius, radius, mode == LINE ? lineWidth : 0.f, atan2(dy, dx), red, green, blue);
+	}
+
+	void InitPolygonMeshes(Shader* meshShader)
+	{
+		Data->MeshShader = meshShader;
+
+		// cache uniform locations, meshes are drawn far too often to look them up every time
+		Data->MeshTransformLocation = glGetUniformLocation(meshShader->getID(), "u_Transform");
+		Data->MeshColorLocation = glGetUniformLocation(meshShader->getID(), "u_Color");
+	}
+
+	void Draw(PolygonMesh& mesh, DrawMode mode, float x, float y, float rotation, float scale, float red, float green, float blue)
+	{
+		// Polygon meshes need their shader, see InitPolygonMeshes()
+		assert(Data->MeshShader != nullptr);
+
+		// draw queued shapes first to keep submission order
+		FlushShapes();
+
+		Data->MeshShader->use();
+		glUniform4f(Data->MeshTransformLocation, x, y, rotation, scale);
+		glUniform3f(Data->MeshColorLocation, red, green, blue);
+
+		mesh.Bind();
+		if (mode == FILL)
+			glDrawElements(GL_TRIANGLES, mesh.GetFillIndexCount(), GL_UNSIGNED_INT, 0);
+		else	// outline indices are stored after the fill indices
+			glDrawElements(GL_LINES, mesh.GetLineIndexCount(), GL_UNSIGNED_INT, (void*)(sizeof(GL_UNSIGNED_INT) * mesh.GetFillIndexCount()));
+	}
+
+	// Upload the queued shape streams and analytic instances
+	static void UploadShapes()
+	{
+		unsigned int fillSize = sizeof(GL_FLOAT) * (unsigned int)Data->ShapeFillVertices.size();
+		unsigned int lineSize = sizeof(GL_FLOAT) * (unsigned int)Data->ShapeLineVertices.size();
+		unsigned int analyticSize = sizeof(GL_FLOAT) * (unsigned int)Data->AnalyticInstances.size();
+
+		if (fillSize + lineSize > 0)
+		{
+			glBindVertexArray(Data->ShapeVAO);
+			glBindBuffer(GL_ARRAY_BUFFER, Data->ShapeBuffer.GetID());
+			char* mapped = (char*)Data->ShapeBuffer.Map(fillSize + lineSize, Data->ShapeBufferOffset, sizeof(GL_FLOAT) * 5);
+			if (mapped)
+			{	// fill stream first, line stream directly after it
+				memcpy(mapped, Data->ShapeFillVertices.data(), fillSize);
+				memcpy(mapped + fillSize, Data->ShapeLineVertices.data(), lineSize);
+				Data->ShapeBuffer.Unmap();
+			}
+		}
+
+		if (analyticSize > 0)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, Data->AnalyticBuffer.GetID());
+			Data->AnalyticBufferOffset = Data->AnalyticBuffer.Upload(Data->AnalyticInstances.data(), analyticSize, sizeof(GL_FLOAT) * 10);
+		}
+	}
+
+	// Draw the uploaded shape runs in submission order
+	static void DrawShapeRuns()
+	{
+		// layers are drawn with the Matrices projection, never into the views
+		unsigned int views = Data->ActiveLayer ? 0 : Data->ViewCount;
+		if (views > 0)
+			TextureRenderer::SetViewClipping(true);
+
+		// runs start at the uploaded streams, line runs are offset by the whole fill stream as well
+		unsigned int fillOffset = Data->ShapeBufferOffset / (sizeof(GL_FLOAT) * 5);
+		unsigned int lineOffset = fillOffset + (unsigned int)Data->ShapeFillVertices.size() / 5;
+		for (const ShapeRun& run : Data->ShapeRuns)
+		{
+			// runs alternate types, so every run rebinds its own vao and shader
+			if (run.Type == SHAPE_RUN_ANALYTIC)
+			{
+				glBindVertexArray(Data->AnalyticVAO);
+				glBindBuffer(GL_ARRAY_BUFFER, Data->AnalyticBuffer.GetID());
+
+				// point the instance attributes at the first instance of the run
+				unsigned int stride = sizeof(GL_FLOAT) * 10;
+				unsigned int offset = Data->AnalyticBufferOffset + run.First * stride;
+				glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(size_t)(offset));							// center
+				glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(size_t)(offset + 2 * sizeof(GL_FLOAT)));	// half size
+				glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(size_t)(offset + 4 * sizeof(GL_FLOAT)));	// corner, thickness, rotation
+				glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, stride, (void*)(size_t)(offset + 7 * sizeof(GL_FLOAT)));	// color
+
+				if (views == 0)
+				{
+					Data->AnalyticShader->use();
+					glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, run.Count);
+					continue;
+				}
+
+				// every shape is repeated once per view, consecutive instances read the same shape
+				for (unsigned int i = 1; i <= 4; i++)
+					glVertexAttribDivisor(i, views);
+
+				Data->AnalyticViewShader->use();
+				glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, run.Count * views);
+
+				for (unsigned int i = 1; i <= 4; i++)
+					glVertexAttribDivisor(i, 1);
+				continue;
+			}
+
+			glBindVertexArray(Data->ShapeVAO);
+
+			GLenum mode = run.Type == SHAPE_RUN_FILL ? GL_TRIANGLES : GL_LINES;
+			unsigned int first = (run.Type == SHAPE_RUN_FILL ? fillOffset : lineOffset) + run.First;
+			if (views > 0)
+			{	// one instance per view
+				Data->ShapeViewShader->use();
+				glDrawArraysInstanced(mode, first, run.Count, views);
+			}
+			else
+			{
+				Data->ShapeShader->use();
+				glDrawArrays(mode, first, run.Count);
+			}
+		}
+
+		if (views > 0)
+			TextureRenderer::SetViewClipping(false);
+	}
+
+	// Clear the shape streams, keeping their capacity for the next frame
+	static void ClearShapes()
+	{
+		Data->ShapeFillVertices.clear();
+		Data->ShapeLineVertices.clear();
+		Data->AnalyticInstances.clear();
+		Data->ShapeRuns.clear();
+	}
+
+	// Queue the shape runs into the software renderer, in submission order
+	static void SubmitSoftwareShapes()
+	{
+		for (const ShapeRun& run : Data->ShapeRuns)
+		{
+			if (run.Type == SHAPE_RUN_ANALYTIC)
+				Data->Software->AddAnalyticShapes(&Data->AnalyticInstances[(size_t)run.First * 10], run.Count);
+			else if (run.Type == SHAPE_RUN_FILL)
+				Data->Software->AddTriangles(&Data->ShapeFillVertices[(size_t)run.First * 5], run.Count);
+			else
+				Data->Software->AddLines(&Data->ShapeLineVertices[(size_t)run.First * 5], run.Count);
+		}
+	}
+
+	void FlushShapes()
+	{
+		TRACE_ZONE("Graphics::FlushShapes");
+		CaptureScope capture(Data->Recorder, CAPTURE_FLUSH_SHAPES);
+
+		// layers are GL textures, so their shapes are always drawn with GL
+		if (Data->Software && !Data->ActiveLayer)
+		{
+			SubmitSoftwareShapes();
+			ClearShapes();
+			return;
+		}
+
+		// damage tracked frames draw shapes on Render(), into the tracked target, unless they belong to a layer
+		if (Data->ShapeRuns.empty() || (Data->Damage && !Data->ActiveLayer))
+			return;
+
+		UploadShapes();
+		DrawShapeRuns();
+		ClearShapes();
+	}
+
+	void BatchLinesPush()
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_BATCH_LINES_PUSH);
+
+		// reset Batch state
+		// recording only touches cpu memory, nothing reaches OpenGL until BatchLinesPop()
+		Data->LineVertices.clear();
+		Data->isLineBatched = true;
+	}
+
+	void Line(float x1, float y1, float x2, float y2, float red, float green, float blue)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_LINE);
+		if (capture)
+			capture->Record(x1, y1, x2, y2, red, green, blue);
+
+		PushShapeVertex(Data->LineVertices, x1, y1, red, green, blue);
+		PushShapeVertex(Data->LineVertices, x2, y2, red, green, blue);
+
+		// draw right away when not batched
+		if (!Data->isLineBatched)
+		{
+			DrawLineVertices();
+		}
+	}
+
+	void BatchLinesPop()
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_BATCH_LINES_POP);
+
+		if (Data->isLineBatched)
+		{
+			// issue draw call for every line since the push
+			DrawLineVertices();
+		}
+		else
+		{
+			// Push was not called before this
+			assert(false);
+		}
+
+		Data->isLineBatched = false;
+	}
+
+	void InitPoints(Shader* pointShader)
+	{
+		Data->PointShader = pointShader;
+	}
+
+	void BatchPointsPush()
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_BATCH_POINTS_PUSH);
+
+		// reset Batch state
+		// recording only touches cpu memory, nothing reaches OpenGL until BatchPointsPop()
+		Data->PointVertices.clear();
+		Data->isPointBatched = true;
+	}
+
+	void Point(float x, float y, unsigned int size, float red, float green, float blue, PointShape shape)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_POINT);
+		if (capture)
+			capture->Record(x, y, size, red, green, blue, shape);
+
+		PushShapeVertex(Data->PointVertices, x, y, red, green, blue);
+		Data->PointVertices.push_back((float)size);
+		Data->PointVertices.push_back((float)shape);
+
+		// draw right away when not batched
+		if (!Data->isPointBatched)
+		{
+			DrawPointVertices(size);
+		}
+	}
+
+	void BatchPointsPop(unsigned int pointSize)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_BATCH_POINTS_POP);
+		if (capture)
+			capture->Record(pointSize);
+
+		if (Data->isPointBatched)
+		{
+			// issue draw call for every point since the push
+			DrawPointVertices(pointSize);
+		}
+		else
+		{
+			// Push was not called before this
+			assert(false);
+		}
+
+		Data->isPointBatched = false;
+	}
+
+	void Draw(TimeSeries& series, float viewLeft, float viewRight, unsigned int pixelWidth, float red, float green, float blue)
+	{
+		if (pixelWidth == 0 || viewRight <= viewLeft)
+			return;
+
+		// draw queued shapes first to keep submission order
+		FlushShapes();
+
+		series.Decimate(viewLeft, viewRight, pixelWidth);
+		if (series.GetVertexCount() < 2)
+			return;
+
+		series.Bind();
+		// the series vao has no color array, so the color is a constant attribute value
+		glVertexAttrib3f(1, red, green, blue);
+
+		// bind shader
+		Data->ShapeShader->use();
+
+		// issue draw call
+		glDrawArrays(GL_LINE_STRIP, 0, series.GetVertexCount());
+	}
+
+	void Draw(DensityRenderer& density, float maxDensity)
+	{
+		// draw queued shapes first to keep submission order
+		FlushShapes();
+
+		density.Render(maxDensity);
+	}
+
+	// Lay out text into a blob with the given font, see CompileTextBlob()
+	static void CompileGlyphs(TextBlob& blob, std::string_view text, float scale, float rotation, int font, float fontSize)
+	{
+		// the blob's own text is passed back in when a stale layout is redone
+		if (text.data() != blob.Text.data())
+			blob.Text.assign(text.data(), text.size());
+		blob.Scale = scale;
+		blob.Rotation = rotation;
+		blob.Font = font;
+		blob.FontSize = fontSize;
+
+		// reuse the blob's existing storage, sized to the text so short labels stay small
+		blob.Glyphs.Count = 0;
+		if (blob.Glyphs.Capacity < text.size())
+		{
+			blob.Glyphs.Capacity = (unsigned int)text.size();
+			blob.Glyphs.Vertices.resize(blob.Glyphs.Capacity * VERTEX_FLOAT_COUNT);
+			blob.Glyphs.Indices.resize(blob.Glyphs.Capacity * INDEX_UINT_COUNT);
+		}
+
+		if (font >= 0)
+		{
+			// one retry, in case a page this text already used was reused while laying it out
+			for (int attempt = 0; attempt < 2; attempt++)
+			{
+				blob.Generation = Data->Glyphs->GetGeneration();
+				blob.Glyphs.Count = 0;
+
+				LayoutTrueType(blob.Text, font, fontSize, scale, [&](const CachedGlyph& glyph, float x, float y, float rotationOffsetX, float rotationOffsetY)
+				{
+					Data->Renderer->CompileStatic(blob.Glyphs, glyph.Page, glyph.Quad, x, y, glyph.Quad.z, glyph.Quad.w, rotation, rotationOffsetX, rotationOffsetY);
+				});
+
+				if (blob.Generation == Data->Glyphs->GetGeneration())
+					break;
+			}
+			return;
+		}
+
+		float offsetX = Data->FontCellWidth / 2.f * scale;
+		float offsetY = Data->FontCellHeight / 2.f * scale;
+
+		for (int i = 0; i < text.size(); i++)
+		{
+			unsigned char ch = text[i];
+			if (i > 0)
+				offsetX += FontMetrics::FindKerning(Data->FontKerning, text[i - 1], ch) * scale;
+			float glyphX = offsetX + Data->FontBearings[ch] * scale;
+
+			// white glyphs around the origin, Draw() moves and colors them
+			FontRenderer(font)->CompileStatic(
+				blob.Glyphs, Data->FontAtlas, ch - Data->FontStartingChar,
+				glyphX, offsetY,
+				Data->FontCellWidth * scale, Data->FontCellHeight * scale,
+				rotation, -glyphX, 0.f
+			);
+
+			offsetX += Data->FontWidths[ch] * scale;
+		}
+	}
+
+	void CompileTextBlob(TextBlob& blob, std::string_view text, float scale, float rotation)
+	{
+		CompileGlyphs(blob, text, scale, rotation, Data->ActiveFont, Data->ActiveFontSize);
+	}
+
+	void Draw(TextBlob& blob, float x, float y, float red, float green, float blue)
+	{
+		// glyph cache pages were reused since the blob was laid out
+		if (blob.Font >= 0 && blob.Generation != Data->Glyphs->GetGeneration())
+			CompileGlyphs(blob, blob.Text, blob.Scale, blob.Rotation, blob.Font, blob.FontSize);
+
+		FontRenderer(blob.Font)->Draw(blob.Glyphs, x, y, red, green, blue);
+	}
+
+	// Fill the bulk text metrics with the atlas cell and bearing of every char of the loaded font
+	static void UpdateBulkTextMetrics()
+	{
+		TextureAtlas* atlas = Data->FontAtlas;
+		float textureWidth = (float)atlas->GetTextureWidth();
+		float textureHeight = (float)atlas->GetTextureHeight();
+		int cellCount = atlas->GetAtlasWidth() * atlas->GetAtlasHeight();
+
+		float metrics[256 * 4] = {};
+		for (int ch = 0; ch < 256; ch++)
+		{
+			int cell = ch - Data->FontStartingChar;
+			if (cell >= 0 && cell < cellCount)
+			{
+				glm::vec4 quad = atlas->GetQuad(cell);
+				metrics[ch * 4] = quad.x / textureWidth;
+				metrics[ch * 4 + 1] = quad.y / textureHeight;
+			}
+			metrics[ch * 4 + 2] = (float)Data->FontBearings[ch];
+		}
+		Data->BulkTextMetrics->SetData(metrics);
+
+		Data->BulkTextShader->use();
+		glUniform2f(Data->BulkTextCellSizeLocation, (float)Data->FontCellWidth, (float)Data->FontCellHeight);
+		glUniform2f(Data->BulkTextCellUVLocation, Data->FontCellWidth / textureWidth, Data->FontCellHeight / textureHeight);
+
+		Data->BulkTextFontGeneration = Data->FontGeneration;
+	}
+
+	void InitBulkText(Shader* bulkTextShader, unsigned int metricsBinding)
+	{
+		Data->BulkTextShader = bulkTextShader;
+		Data->BulkTextMetrics = new UBO(sizeof(float) * 256 * 4, metricsBinding, "GlyphMetrics");
+		bulkTextShader->setUBO(*Data->BulkTextMetrics);
+
+		// claim a texture unit the same way atlases do, so run tables never displace one
+		Data->BulkTextRunUnit = TextureAtlas::GetAtlasCount();
+		TextureAtlas::GetAtlasCount()++;
+
+		// cache uniform locations, the run table unit never changes
+		unsigned int id = bulkTextShader->getID();
+		Data->BulkTextCellSizeLocation = glGetUniformLocation(id, "u_CellSize");
+		Data->BulkTextCellUVLocation = glGetUniformLocation(id, "u_CellUV");
+		Data->BulkTextFontLocation = glGetUniformLocation(id, "u_Font");
+		Data->BulkTextDistanceFieldLocation = glGetUniformLocation(id, "u_DistanceField");
+
+		bulkTextShader->use();
+		glUniform1i(glGetUniformLocation(id, "u_Runs"), Data->BulkTextRunUnit);
+	}
+
+	void BatchText(TextBatch& batch, std::string_view text, float x, float y, float scale, float rotation, float red, float green, float blue)
+	{
+		if (!batch.AddRun(x, y, scale, rotation, red, green, blue))
+			return;
+
+		// pen offsets are unscaled, the shader scales them with the run
+		int pen = 0;
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			unsigned char ch = text[i];
+			if (i > 0)
+				pen = std::max(pen + FontMetrics::FindKerning(Data->FontKerning, text[i - 1], ch), 0);
+
+			// glyphs past the packing limit are dropped
+			if (pen > (int)TextBatch::MAX_PEN_OFFSET)
+				break;
+
+			batch.AddGlyph(ch, (unsigned int)pen);
+			pen += Data->FontWidths[ch];
+		}
+	}
+
+	void Draw(TextBatch& batch)
+	{
+		// Bulk text needs its shader and a bitmap font, see InitBulkText() and LoadFont()
+		assert(Data->BulkTextShader != nullptr && Data->FontAtlas != nullptr);
+
+		if (batch.GetGlyphCount() == 0)
+			return;
+
+		// draw queued shapes first to keep submission order
+		FlushShapes();
+
+		// every font load creates a new atlas
+		if (Data->BulkTextFontGeneration != Data->FontGeneration)
+			UpdateBulkTextMetrics();
+
+		batch.Upload();
+
+		Data->BulkTextShader->use();
+		glUniform1i(Data->BulkTextFontLocation, Data->FontAtlas->GetID());
+		glUniform1i(Data->BulkTextDistanceFieldLocation, Data->isFontSDF ? 1 : 0);
+
+		Data->FontAtlas->Bind();
+		batch.Bind(Data->BulkTextRunUnit);
+
+		// 4 strip vertices per glyph instance
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, batch.GetGlyphCount());
+		glBindVertexArray(0);
+	}
+
+	void SetTextCacheCapacity(unsigned int capacity)
+	{
+		Data->TextCacheCapacity = capacity;
+
+		// drop the least recently used blobs that no longer fit
+		while (Data->TextCache.size() > capacity)
+			Data->TextCache.pop_back();
+
+		RebuildTextCacheLookup();
+	}
+
+	// Print text, cached is false for text that changes every frame, like numbers, so it never churns the text cache
+	static void PrintText(std::string_view text, float x, float y, float scale, float rotation, int digitTruncate, float red, float green, float blue, bool cached)
+	{
+		TRACE_ZONE("Graphics::PrintInternal");
+		CaptureScope capture(Data->Recorder, CAPTURE_PRINT);
+		if (capture)
+			capture->Record(text, x, y, scale, rotation, digitTruncate, red, green, blue);
+
+		TruncateDigits(text, digitTruncate);
+
+		cached = cached && Data->TextCacheCapacity > 0;
+
+		if (!cached && Data->ActiveFont >= 0)
+		{	// no cache, lay the text out straight into the renderer
+			LayoutTrueType(text, Data->ActiveFont, Data->ActiveFontSize, scale, [&](const CachedGlyph& glyph, float centerX, float centerY, float rotationOffsetX, float rotationOffsetY)
+			{
+				Data->Renderer->Draw(
+					glyph.Page, glyph.Quad,
+					x + centerX, y + centerY,
+					glyph.Quad.z, glyph.Quad.w,
+					rotation, rotationOffsetX, rotationOffsetY,
+					red, green, blue
+				);
+			});
+			return;
+		}
+
+		if (!cached)
+		{	// no cache, lay the text out straight into the renderer
+			float offsetX = Data->FontCellWidth / 2.f * scale;
+			float offsetY = Data->FontCellHeight / 2.f * scale;
+
+			for (int i = 0; i < text.size(); i++)
+			{
+				unsigned char ch = text[i];
+				if (i > 0)
+					offsetX += FontMetrics::FindKerning(Data->FontKerning, text[i - 1], ch) * scale;
+				float glyphX = offsetX + Data->FontBearings[ch] * scale;
+
+				FontRenderer(-1)->Draw(
+					Data->FontAtlas, ch - Data->FontStartingChar,
+					x + glyphX, y + offsetY,
+					Data->FontCellWidth * scale, Data->FontCellHeight * scale, 
+					rotation, -glyphX, 0.f, 
+					red, green, blue
+				);
+
+				offsetX += Data->FontWidths[ch] * scale;
+			}
+			return;
+		}
+
+		if (Data->TextCacheLookup.empty())
+			RebuildTextCacheLookup();
+
+		auto found = FindTextCacheBlob(text, scale, rotation);
+		if (found != Data->TextCache.end())
+		{	// hit, move the blob to the front
+			Data->TextCache.splice(Data->TextCache.begin(), Data->TextCache, found);
+		}
+		else
+		{
+			if (Data->TextCache.size() >= Data->TextCacheCapacity)
+			{	// full, recycle the least recently used blob and its storage
+				EraseTextCacheBlob(std::prev(Data->TextCache.end()));
+				Data->TextCache.splice(Data->TextCache.begin(), Data->TextCache, std::prev(Data->TextCache.end()));
+			}
+			else
+				Data->TextCache.emplace_front();
+
+			CompileTextBlob(Data->TextCache.front(), text, scale, rotation);
+			InsertTextCacheBlob(Data->TextCache.begin());
+		}
+
+		Draw(Data->TextCache.front(), x, y, red, green, blue);
+	}
+
+	void PrintInternal(std::string_view text, float x, float y, float scale, float rotation, int digitTruncate, float red, float green, float blue)
+	{
+		PrintText(text, x, y, scale, rotation, digitTruncate, red, green, blue, true);
+	}
+
+	void Print(short value, float x, float y, float scale, float rotation, float red, float green, float blue)
+	{
+		char buffer[32];
+		PrintText(FormatNumber(buffer, sizeof(buffer), (long long)value), x, y, scale, rotation, -1, red, green, blue, false);
+	}
+
+	void Print(bool value, float x, float y, float scale, float rotation, float red, float green, float blue)
+	{
+		if (value)
+			PrintInternal("True", x, y, scale, rotation, -1, red, green, blue);
+		else
+			PrintInternal("False", x, y, scale, rotation, -1, red, green, blue);
+	}
+
+	void Print(int value, float x, float y, float scale, float rotation, float red, float green, float blue)
+	{
+		char buffer[32];
+		PrintText(FormatNumber(buffer, sizeof(buffer), (long long)value), x, y, scale, rotation, -1, red, green, blue, false);
+	}
+
+	void Print(long value, float x, float y, float scale, float rotation, float red, float green, float blue)
+	{
+		char buffer[32];
+		PrintText(FormatNumber(buffer, sizeof(buffer), (long long)value), x, y, scale, rotation, -1, red, green, blue, false);
+	}
+
+	void Print(float value, float x, float y, float scale, float rotation, int digitTruncate, float red, float green, float blue)
+	{
+		// formatted straight to the requested digits, instead of 6 digits cut down afterwards
+		char buffer[320];
+		PrintText(FormatNumber(buffer, sizeof(buffer), (double)value, digitTruncate), x, y, scale, rotation, -1, red, green, blue, false);
+	}
+
+	void Print(double value, float x, float y, float scale, float rotation, int digitTruncate, float red, float green, float blue)
+	{
+		char buffer[320];
+		PrintText(FormatNumber(buffer, sizeof(buffer), value, digitTruncate), x, y, scale, rotation, -1, red, green, blue, false);
+	}
+
+	void Print(const char* text, float x, float y, float scale, float rotation, float red, float green, float blue)
+	{
+		PrintInternal(std::string_view(text), x, y, scale, rotation, -1, red, green, blue);
+	}
+
+	void Print(const std::string& text, float x, float y, float scale, float rotation, float red, float green, float blue)
+	{
+		PrintInternal(std::string_view(text), x, y, scale, rotation, -1, red, green, blue);
+	}
+
+	void Print(std::string_view text, float x, float y, float scale, float rotation, float red, float green, float blue)
+	{
+		PrintInternal(text, x, y, scale, rotation, -1, red, green, blue);
+	}
+
+	std::string_view FormatInternal(char* buffer, size_t size, std::string_view format, const FormatValue* values, size_t valueCount)
+	{
+		size_t length = 0;
+		size_t nextValue = 0;
+
+		// copy as much of the given text as still fits
+		auto append = [&](std::string_view text)
+		{
+			size_t count = std::min(text.size(), size - length);
+			text.copy(buffer + length, count);
+			length += count;
+		};
 
-		while (std::getline(fin, line)) // read through whole file
+		for (size_t i = 0; i < format.size() && length < size; i++)
 		{
-			split(line, ',', output, 5); // process line
+			char ch = format[i];
 
-			// assign the result to the correct Data value
-			if (output[0] == "Cell Width")
-			{
-				Data.FontCellWidth = std::stoi(output[1]);
-				continue;
-			}
-			else if (output[0] == "Cell Height")
-			{
-				Data.FontCellHeight = std::stoi(output[1]);
-				continue;
-			}
-			else if (output[0] == "Start Char")
+			// escaped braces
+			if ((ch == '{' || ch == '}') && i + 1 < format.size() && format[i + 1] == ch)
 			{
-				Data.FontStartingChar = std::stoi(output[1]);
+				append(std::string_view(&format[i], 1));
+				i++;
 				continue;
 			}
-			else if (output[0] == "Image Width")
-			{
-				ImageWidth = std::stoi(output[1]);
-				continue;
-			}
-			else if (output[0] == "Image Height")
+
+			size_t close = format.find('}', i);
+			if (ch != '{' || close == std::string_view::npos)
 			{
-				ImageHeight = std::stoi(output[1]);
+				append(std::string_view(&format[i], 1));
 				continue;
 			}
-			// if this line is a char width field, process again
-			split(output[0], ' ', suboutput, 5);
-			if (suboutput[0] == "Char" && suboutput[2] == "Base")
+
+			// parse an optional ":.N" precision
+			std::string_view spec = format.substr(i + 1, close - i - 1);
+			int precision = -1;
+			if (spec.size() > 2 && spec[0] == ':' && spec[1] == '.')
+				std::from_chars(spec.data() + 2, spec.data() + spec.size(), precision);
+			i = close;
+
+			if (nextValue >= valueCount)
+				continue; // more placeholders than arguments, leave them empty
+
+			const FormatValue& value = values[nextValue++];
+			char number[320];
+			switch (value.Type)
 			{
-				Data.FontWidths[std::stoi(suboutput[1])] = std::stoi(output[1]);
+			case FormatValue::SIGNED:
+				append(FormatNumber(number, sizeof(number), value.Signed));
+				break;
+			case FormatValue::UNSIGNED:
+				append(std::string_view(number, std::to_chars(number, number + sizeof(number), value.Unsigned).ptr - number));
+				break;
+			case FormatValue::FLOATING:
+				append(FormatNumber(number, sizeof(number), value.Floating, precision));
+				break;
+			case FormatValue::BOOLEAN:
+				append(value.Boolean ? "True" : "False");
+				break;
+			case FormatValue::CHARACTER:
+				append(std::string_view(&value.Character, 1));
+				break;
+			case FormatValue::TEXT:
+				append(value.Text);
+				break;
 			}
 		}
 
-		Data.FontAtlas = new TextureAtlas(fontImagePath, ImageWidth / Data.FontCellWidth, ImageHeight / Data.FontCellHeight);
+		return std::string_view(buffer, length);
 	}
 
-	TextureRenderer* GetRenderer()
+	void Draw(TextureAtlas* atlas, unsigned int index, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
 	{
-		return Data.Renderer;
+		CaptureScope capture(Data->Recorder, CAPTURE_DRAW_INDEX);
+		if (capture)
+			capture->Record(atlas, index, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
+
+		Data->Renderer->Draw(atlas, index, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
 	}
 
-	void Polygon(DrawMode mode, float *vertices, unsigned int vertexCount, float red, float green, float blue)
+	void Draw(TextureAtlas* atlas, glm::vec4 calculatedQuad, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
 	{
-		unsigned int triangleCount;
-		// Bind vao
-		glBindVertexArray(Data.VAO);
+		CaptureScope capture(Data->Recorder, CAPTURE_DRAW_QUAD);
+		if (capture)
+			capture->Record(atlas, calculatedQuad.x, calculatedQuad.y, calculatedQuad.z, calculatedQuad.w, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
 
-		// Fill vbo with vertex data
-		glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-		if (mode == FILL)
-		{	// FILL mode needs to triangulate the polygon
-			// get vertex data from given polygon by triangulating it
-			std::vector<float> vertexData = TriangulatePolygon(vertices, vertexCount);
-			triangleCount = (unsigned int)vertexData.size() / 6;
-			// resize and fill vert buffer with triangulated vertex data
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * vertexData.size(), vertexData.data(), GL_DYNAMIC_DRAW);
-			// bind and turn on vertex attrib divisor
-			glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-			glVertexAttribDivisor(1, 1);
-
-			// assign and fill color buffer
-			float color[3] = { red, green, blue };
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3, color, GL_DYNAMIC_DRAW);
-		}
-		else
-		{ // LINE mode only plugs in the vertex data as is
-			// bind vbo and fill data
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * vertexCount * 2, vertices, GL_DYNAMIC_DRAW);
-			// bind and turn on vertex attrib divisor
-			glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-			glVertexAttribDivisor(1, 1);
+		Data->Renderer->Draw(atlas, calculatedQuad, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
+	}
 
-			float color[3] = { red, green, blue };
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3, color, GL_DYNAMIC_DRAW);
-		}
+	void Draw(CompiledRenderData& container)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_DRAW_COMPILED);
+		if (capture)
+			capture->Record(container);
 
-		// Bind shader
-		Data.ShapeShader->use();
+		Data->Renderer->Draw(container);
+	}
 
-		// Call draw command
-		if (mode == FILL)
-		{
-			glDrawArrays(GL_TRIANGLES, 0, triangleCount*3);
-		}
-		else 
-			glDrawArrays(GL_LINE_LOOP, 0, vertexCount);
+	void Draw(VirtualTexture& texture, float x, float y, float width, float height, glm::vec4 view, unsigned int pixelWidth, float red, float green, float blue)
+	{	// not captured, tiles stream from the texture's own source, see the Capture section
+		texture.Draw(Data->Renderer, x, y, width, height, view, pixelWidth, red, green, blue);
 	}
 
-	void Circle(DrawMode mode, float x, float y, float radius, float red, float green, float blue, unsigned int precision)
+	// Hash the quads of a renderer into the damage tiles, 4 vertices of 8 floats per quad
+	static void TrackQuadDamage(TextureRenderer* renderer, uint64_t seed)
 	{
-		// Create needed array of floats with correct size
-		float* vertices = new float[precision * 2];
-		
-		// Initialize needed variables
-		unsigned int count = 0;
-		float dx = 0.f;
-		float dy = 0.f;
-		float angle = 0.f;
-		// angle increment calculated through number of degrees per side
-		float angleInc = glm::radians(360.f / (float)precision);
-
-		// Loop through all points needed to be created
-		for (unsigned int i = 0; i < precision; i++)
+		const float* quads = renderer->GetQuadData();
+		for (int i = 0; i < renderer->GetQuadCount(); i++)
 		{
-			// increase the angle
-			angle += angleInc;
-			// find the value of x and y
-			dx = cos(angle) * radius + x;
-			dy = sin(angle) * radius + y;
+			const float* quad = quads + (size_t)i * VERTEX_FLOAT_COUNT;
+			float minX = quad[0], minY = quad[1], maxX = quad[0], maxY = quad[1];
+			for (int j = 8; j < VERTEX_FLOAT_COUNT; j += 8)
+			{
+				minX = std::min(minX, quad[j]);
+				minY = std::min(minY, quad[j + 1]);
+				maxX = std::max(maxX, quad[j]);
+				maxY = std::max(maxY, quad[j + 1]);
+			}
 
-			// add x and y to the vertex array at the correct place
-			vertices[count] = dx;
-			count++;
-			vertices[count] = dy;
-			count++;
+			Data->Damage->Add(minX, minY, maxX, maxY, DamageTracker::Hash(quad, VERTEX_FLOAT_COUNT, seed));
 		}
-
-		// use polygon to draw
-		Polygon(mode, vertices, precision, red, green, blue);
-
-		// clean up new allocated vertex array
-		delete[] vertices;
 	}
 
-	void Rectangle(DrawMode mode, float x, float y, float width, float height, float rotation, float rotOffsetX, float rotOffsetY, float red, float green, float blue)
+	// Hash every primitive Render() is about to draw into the damage tiles, in drawing order
+	static void TrackDamage()
 	{
-		// Assemble vertex positions
-		float Vertices[8] = {
-			x			, y,			  // top left
-			x + width, y,			  // top right
-			x + width, y + height, // bottom right
-			x			, y + height  // bottom left
-		};
-
-		// Rotate vertex positions
-		if (rotation != 0)
+		for (const ShapeRun& run : Data->ShapeRuns)
 		{
-			// initialize sin, cos values for performace
-			float sinX = sin(rotation);
-			float cosX = cos(rotation);
-			
-			for (int i = 0; i < 8; i+=2)
+			if (run.Type == SHAPE_RUN_ANALYTIC)
 			{
-				float origX = Vertices[i];
-				float origY = Vertices[i + 1];
-				// rotate vertices
-				Vertices[i] = cosX * (origX - x - rotOffsetX) - sinX * (origY - y - rotOffsetY) + x + rotOffsetX;
-				Vertices[i + 1] = sinX * (origX - x - rotOffsetX) + cosX * (origY - y - rotOffsetY) + y + rotOffsetY;
+				for (unsigned int i = run.First; i < run.First + run.Count; i++)
+				{
+					// rotation is covered by the circle around the half size, plus the quad's anti-aliasing margin
+					const float* instance = &Data->AnalyticInstances[(size_t)i * 10];
+					float radius = sqrtf(instance[2] * instance[2] + instance[3] * instance[3]) + 2.f;
+					Data->Damage->Add(instance[0] - radius, instance[1] - radius, instance[0] + radius, instance[1] + radius, DamageTracker::Hash(instance, 10));
+				}
+				continue;
+			}
+
+			// fill runs are triangles, line runs are vertex pairs
+			const std::vector<float>& stream = run.Type == SHAPE_RUN_FILL ? Data->ShapeFillVertices : Data->ShapeLineVertices;
+			unsigned int verticesPerPrimitive = run.Type == SHAPE_RUN_FILL ? 3 : 2;
+			for (unsigned int i = run.First; i + verticesPerPrimitive <= run.First + run.Count; i += verticesPerPrimitive)
+			{
+				const float* vertices = &stream[(size_t)i * 5];
+				float minX = vertices[0], minY = vertices[1], maxX = vertices[0], maxY = vertices[1];
+				for (unsigned int j = 1; j < verticesPerPrimitive; j++)
+				{
+					minX = std::min(minX, vertices[j * 5]);
+					minY = std::min(minY, vertices[j * 5 + 1]);
+					maxX = std::max(maxX, vertices[j * 5]);
+					maxY = std::max(maxY, vertices[j * 5 + 1]);
+				}
+
+				Data->Damage->Add(minX, minY, maxX, maxY, DamageTracker::Hash(vertices, verticesPerPrimitive * 5, DamageTracker::HASH_SEED + run.Type));
 			}
 		}
 
-		// use polygon to draw
-		Polygon(mode, Vertices, 4, red, green, blue);
+		// text of a distance field font samples the same atlas through another shader
+		TrackQuadDamage(Data->Renderer, DamageTracker::HASH_SEED);
+		if (Data->SDFTextRenderer)
+			TrackQuadDamage(Data->SDFTextRenderer, DamageTracker::HASH_SEED + 1);
 	}
 
-	void BatchLinesPush()
+	// Render() of a damage tracked frame, only the damaged rects of the target are cleared and drawn again
+	static void RenderDamage()
 	{
-		// reset Batch state
-		Data.BatchSize = 0;
-		Data.isBatched = true;
-
-		glBindVertexArray(Data.VAO);
-		// bind color vbo
-		glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-		glVertexAttribDivisor(1, 1);
+		TrackDamage();
+		const std::vector<DamageRect>& rects = Data->Damage->Update();
 
-		if (Data.BatchCapacity == 0)
+		Data->Damage->BindTarget();
+		if (!rects.empty())
 		{
-			// resize batch capacity and vector size
-			Data.BatchCapacity += 10;
-			Data.BatchVector.resize(Data.BatchCapacity * 4);
-			Data.ColorVector.resize(Data.BatchCapacity * 3);
+			UploadShapes();
+
+			// every rect redraws the whole frame, the scissor keeps the fill inside the rect
+			glEnable(GL_SCISSOR_TEST);
+			for (const DamageRect& rect : rects)
+			{
+				glScissor(rect.X, rect.Y, rect.Width, rect.Height);
+				glClear(GL_COLOR_BUFFER_BIT);
 
-			// resize vertex buffer
-			glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * Data.BatchCapacity * 4, NULL, GL_DYNAMIC_DRAW);
-			// resize color buffer
-			glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * Data.BatchCapacity * 3, NULL, GL_DYNAMIC_DRAW);
+				DrawShapeRuns();
+				Data->Renderer->RenderPass();
+				if (Data->SDFTextRenderer)
+					Data->SDFTextRenderer->RenderPass();
+			}
+			glDisable(GL_SCISSOR_TEST);
 		}
 
-		// reset vert vector
-		Data.BatchVector.clear();
-		Data.BatchVector.resize(Data.BatchCapacity * 4);
+		ClearShapes();
+		Data->Renderer->Clear();
+		if (Data->SDFTextRenderer)
+			Data->SDFTextRenderer->Clear();
 
-		// reset color vector
-		Data.ColorVector.clear();
-		Data.ColorVector.resize(Data.BatchCapacity * 3);
+		// the back buffer is undefined after a swap, so the whole target is copied every frame
+		Data->Damage->Present();
 	}
 
-	void Line(float x1, float y1, float x2, float y2, float red, float green, float blue)
+	// Render() of a software rendered frame, every queued primitive is rasterized on the CPU
+	static void RenderSoftware()
 	{
-		float verData[4] = {
-			x1, y1, x2, y2
-		};
-
-		float color[3] = {
-			red, green, blue
-		};
+		FlushShapes();
 
-		if (Data.isBatched)
-		{
-			if (Data.BatchSize >= Data.BatchCapacity)
-			{	// resize vector/buffer
-				Data.BatchCapacity += 10;
-				// vector resize
-				Data.BatchVector.resize(Data.BatchCapacity * 4);
-				Data.ColorVector.resize(Data.BatchCapacity * 3);
-
-				// vbo resize
-				glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-				glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 4 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-				// color vbo resize
-				glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-				glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-			}
+		Data->Software->AddQuads(Data->Renderer->GetQuadData(), Data->Renderer->GetQuadCount());
+		Data->Renderer->Clear();
+		if (Data->SDFTextRenderer)
+		{
+			Data->Software->AddQuads(Data->SDFTextRenderer->GetQuadData(), Data->SDFTextRenderer->GetQuadCount(), true);
+			Data->SDFTextRenderer->Clear();
+		}
 
-			// verify that the buffer size is still valid
-			// multiple other Graphics calls use the same vertex and color buffer, resizing it
-			// check the actual size of the buffer, if it's too small than expected
-			// full resize both buffers
-			int bufferSize = 0;
-			glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-			// get buffer size
-			glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &bufferSize);
-			if (bufferSize < sizeof(GL_FLOAT) * 4 * Data.BatchCapacity)
-			{	// resize
-				glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 4 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-
-				glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-				glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-			}
+		Data->Software->Render();
+	}
 
-			// add vertex data
-			for (int i = 0; i < 4; i++)
-			{
-				Data.BatchVector[Data.BatchSize * 4 + i] = verData[i];
-			}
-			// add color data
-			for (int i = 0; i < 3; i++)
-			{
-				Data.ColorVector[Data.BatchSize * 3 + i] = color[i];
-			}
+	void Render()
+	{
+		TRACE_ZONE("Graphics::Render");
+		CaptureScope capture(Data->Recorder, CAPTURE_RENDER);
 
-			Data.BatchSize++;
-		}
+		if (Data->Software)
+			RenderSoftware();
+		else if (Data->Damage)
+			RenderDamage();
 		else
 		{
-			glBindVertexArray(Data.VAO);
-			// bind and fill vert data
-			glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 4, verData, GL_DYNAMIC_DRAW);
-
-			// bind and fill color data
-			glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3, color, GL_DYNAMIC_DRAW);
-			glVertexAttribDivisor(1, 1);
+			FlushShapes();
+			Data->Renderer->Render();
 
-			// bind shader
-			Data.ShapeShader->use();
+			// distance field text is drawn over the images
+			if (Data->SDFTextRenderer)
+				Data->SDFTextRenderer->Render();
+		}
 
-			// issue draw call
-			glDrawArrays(GL_LINES, 0, 2);
+		// nothing transient outlives the frame
+		Data->Arena.Reset();
 
-		}
+		// count the heap allocations of the frame, see GetFrameAllocationCount()
+		unsigned long long allocations = FrameArena::GetHeapAllocationCount();
+		Data->FrameAllocations = allocations - Data->FrameAllocationStart;
+		Data->FrameAllocationStart = allocations;
+		TRACE_FRAME();
 	}
 
-	void BatchLinesPop()
+	void CompileStaticDrawData(CompiledRenderData& container, TextureAtlas* atlas, glm::vec4 calculatedQuad, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
 	{
-		if (Data.isBatched)
-		{
-			// bind vbo and fill data
-			glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GL_FLOAT) * 4 * Data.BatchSize, Data.BatchVector.data());
+		Data->Renderer->CompileStatic(container, atlas, calculatedQuad, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
+	}
 
-			// bind color vbo and fill data
-			glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GL_FLOAT) * 3 * Data.BatchSize, Data.ColorVector.data());
-			glVertexAttribDivisor(1, 1);
+	void CompileStaticDrawData(CompiledRenderData& container, TextureAtlas* atlas, unsigned int index, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
+	{
+		glm::vec4 calculatedQuad = atlas->GetQuad(index);
+		Data->Renderer->CompileStatic(container, atlas, calculatedQuad, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
+	}
 
-			// bind shader
-			Data.ShapeShader->use();
+	void LoadStaticDrawData(CompiledRenderData& container)
+	{
+		CaptureScope capture(Data->Recorder, CAPTURE_LOAD_STATIC);
+		if (capture)
+			capture->Record(container);
 
-			// issue draw call for BatchSize points
-			glDrawArrays(GL_LINES, 0, Data.BatchSize * 2);
-		}
-		else
-		{
-			// Push was not called before this
-			assert(false);
-		}
+		Data->Renderer->LoadStaticData(container);
 
-		Data.isBatched = false;
+		// static quads are not hashed, any change redraws everything
+		if (Data->Damage)
+			Data->Damage->Invalidate();
 	}
 
-	void BatchPointsPush()
+	void ClearStaticDrawData()
 	{
-		// reset Batch state
-		Data.BatchSize = 0;
-		Data.isBatched = true;
-
-		glBindVertexArray(Data.VAO);
-		// bind color vbo and set it to not use vertex attrib division
-		// vertex attrib division doesn't seem to play nice with batched points
-		glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-		glVertexAttribDivisor(1, 0);
+		CaptureScope capture(Data->Recorder, CAPTURE_CLEAR_STATIC);
 
-		if (Data.BatchCapacity == 0)
-		{
-			// resize batch capacity and vector size
-			Data.BatchCapacity += 10;
-			Data.BatchVector.resize(Data.BatchCapacity * 2);
-			Data.ColorVector.resize(Data.BatchCapacity * 3);
+		Data->Renderer->ClearStaticData();
 
-			// resize vertex buffer
-			glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * Data.BatchCapacity * 2, NULL, GL_DYNAMIC_DRAW);
-			// resize color buffer
-			glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-		}
-		
-		// reset vert vector
-		Data.BatchVector.clear();
-		Data.BatchVector.resize(Data.BatchCapacity * 2);
-		// reset color vector
-		Data.ColorVector.clear();
-		Data.ColorVector.resize(Data.BatchCapacity * 3);
-	}
-
-	void Point(float x, float y, unsigned int size, float red, float green, float blue)
-	{
-		// bind vao
-		glBindVertexArray(Data.VAO);
-
-		if (Data.isBatched)
-		{
-			if (Data.BatchSize >= Data.BatchCapacity)
-			{	// resize vector/buffer
-				Data.BatchCapacity += 10;
-				// vector resize
-				Data.BatchVector.resize(Data.BatchCapacity * 2);
-				Data.ColorVector.resize(Data.BatchCapacity * 3);
-
-				// vbo resize
-				glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-				glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 2 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-				// color vbo resize
-				glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-				glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-			}
+		if (Data->Damage)
+			Data->Damage->Invalidate();
+	}
 
-			// verify that the buffer size is still valid
-			// multiple other Graphics calls use the same vertex and color buffer, resizing it
-			// check the actual size of the buffer, if it's too small than expected
-			// full resize both buffers
-			int size = 0;
-			glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-			// get buffer size
-			glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
-			if (size < sizeof(GL_FLOAT) * 2 * Data.BatchCapacity)
-			{	// resize
-				glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 2 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-				
-				glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-				glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3 * Data.BatchCapacity, NULL, GL_DYNAMIC_DRAW);
-			}
+	// Swap the screen's renderers and shape streams with the set aside ones
+	static void SwapLayerQueues()
+	{
+		std::swap(Data->Renderer, Data->LayerRenderer);
+		std::swap(Data->SDFTextRenderer, Data->LayerSDFTextRenderer);
+		Data->ShapeFillVertices.swap(Data->LayerFillVertices);
+		Data->ShapeLineVertices.swap(Data->LayerLineVertices);
+		Data->AnalyticInstances.swap(Data->LayerAnalyticInstances);
+		Data->ShapeRuns.swap(Data->LayerShapeRuns);
+	}
 
-			// add vertex data
-			Data.BatchVector[Data.BatchSize * 2] = x;
-			Data.BatchVector[Data.BatchSize * 2 + 1] = y;
-			// add color data
-			Data.ColorVector[Data.BatchSize * 3] = red;
-			Data.ColorVector[Data.BatchSize * 3 + 1] = green;
-			Data.ColorVector[Data.BatchSize * 3 + 2] = blue;
+	bool BeginLayer(Layer& layer)
+	{
+		// layers don't nest
+		assert(Data->ActiveLayer == nullptr);
+
+		if (!layer.IsDirty())
+			return false;
+
+		// layers get their own renderers, so quads queued for the screen wait for Render()
+		if (!Data->LayerRenderer)
+			Data->LayerRenderer = new TextureRenderer(Data->RenderShader);
+		if (Data->SDFTextRenderer && !Data->LayerSDFTextRenderer)
+			Data->LayerSDFTextRenderer = new TextureRenderer(Data->SDFTextShader);
+
+		SwapLayerQueues();
+		Data->ActiveLayer = &layer;
+		layer.Begin();
+		return true;
+	}
 
-			Data.BatchSize++;
-		}
-		else
-		{
-			float point[2] = { x, y };
-			// bind and fill vert data
-			glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 2, point, GL_DYNAMIC_DRAW);
+	void EndLayer()
+	{
+		assert(Data->ActiveLayer != nullptr);
 
-			float color[3] = { red, green, blue };
-			// bind and fill color data
-			glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * 3, color, GL_DYNAMIC_DRAW);
+		// same order as Render(), layer renderers never hold static data
+		FlushShapes();
+		Data->Renderer->Flush();
+		if (Data->SDFTextRenderer)
+			Data->SDFTextRenderer->Flush();
 
-			// set point size
-			glPointSize((float)size);
-			// bind shader
-			Data.ShapeShader->use();
-			// issue draw call
-			glDrawArrays(GL_POINTS, 0, 1);
-		}
+		Data->ActiveLayer->End();
+		Data->ActiveLayer = nullptr;
+		SwapLayerQueues();
 	}
 
-	void BatchPointsPop(unsigned int pointSize)
+	void Draw(Layer& layer, float x, float y, float red, float green, float blue)
 	{
-		// bind vao
-		glBindVertexArray(Data.VAO);
+		float width = (float)layer.GetWidth();
+		float height = (float)layer.GetHeight();
 
-		if (Data.isBatched)
-		{
-			// bind vbo and fill data
-			glBindBuffer(GL_ARRAY_BUFFER, Data.VBO);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GL_FLOAT) * 2 * Data.BatchSize, Data.BatchVector.data());
+		// framebuffer rows start at the bottom, so the texture is read upside down to show the layer upright
+		Data->Renderer->Draw(layer.GetAtlas(), glm::vec4(0.f, height, width, -height), x + width / 2.f, y + height / 2.f, width, height, 0.f, 0.f, 0.f, red, green, blue);
 
-			// bind color vbo and fill data
-			glBindBuffer(GL_ARRAY_BUFFER, Data.ColorVBO);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GL_FLOAT) * 3 * Data.BatchSize, Data.ColorVector.data());
+		// the quad looks the same to damage tracking, so new layer pixels are damaged by hand
+		if (layer.ConsumeRedraw())
+			Damage(x, y, width, height);
+	}
 
-			// set point size
-			glPointSize((float)pointSize);
-			// bind shader
-			Data.ShapeShader->use();
-			// issue draw call for BatchSize points
-			glDrawArrays(GL_POINTS, 0, Data.BatchSize);
-		}
-		else
-		{
-			// Push was not called before this
-			assert(false);
-		}
+	void EnableDamageTracking(int width, int height, glm::mat4 viewProjection, int tileSize)
+	{
+		DisableDamageTracking();
 
-		Data.isBatched = false;
+		Data->Damage = new DamageTracker(width, height, tileSize);
+		Data->Damage->SetViewProjection(viewProjection);
 	}
 
-	void PrintInternal(std::string text, float x, float y, float scale, float rotation, int digitTruncate, float red, float green, float blue)
+	void DisableDamageTracking()
 	{
-		TruncateDigits(text, digitTruncate);
+		if (Data->Damage)
+		{
+			Data->Damage->Clean();
+			delete Data->Damage;
+			Data->Damage = nullptr;
+		}
+	}
 
-		float offsetX = Data.FontCellWidth / 2.f * scale;
-		float offsetY = Data.FontCellHeight / 2.f * scale;
+	void SetDamageViewport(int width, int height, glm::mat4 viewProjection)
+	{
+		assert(Data->Damage != nullptr);
 
-		for (int i = 0; i < text.size(); i++)
-		{
-			unsigned char ch = text[i];
+		Data->Damage->Resize(width, height);
+		Data->Damage->SetViewProjection(viewProjection);
+	}
 
-			Data.Renderer->Draw(
-				Data.FontAtlas, ch - Data.FontStartingChar,
-				x + offsetX, y + offsetY,
-				Data.FontCellWidth * scale, Data.FontCellHeight * scale, 
-				rotation, -offsetX, 0.f, 
-				red, green, blue
-			);
+	void Damage(float x, float y, float width, float height)
+	{
+		if (Data->Damage)
+			Data->Damage->Damage(x, y, x + width, y + height);
+	}
 
-			offsetX += Data.FontWidths[ch] * scale;
-		}
+	const std::vector<DamageRect>& GetDamageRects()
+	{
+		// empty when damage tracking is disabled
+		static const std::vector<DamageRect> none;
+		return Data->Damage ? Data->Damage->GetRects() : none;
 	}
 
-	void Print(short value, float x, float y, float scale, float rotation, float red, float green, float blue)
+	void SetSoftwareRenderer(SoftwareRenderer* renderer)
 	{
-		PrintInternal(std::to_string(value), x, y, scale, rotation, -1, red, green, blue);
+		// shapes queued so far belong to the previous target
+		FlushShapes();
+		Data->Software = renderer;
 	}
 
-	void Print(bool value, float x, float y, float scale, float rotation, float red, float green, float blue)
+	// Wait for a frame fence and delete it
+	static void WaitFrameFence(GLsync& fence)
 	{
-		if (value)
-			PrintInternal("True", x, y, scale, rotation, -1, red, green, blue);
-		else
-			PrintInternal("False", x, y, scale, rotation, -1, red, green, blue);
+		if (!fence)
+			return;
+
+		// flushing makes sure the fence is eventually signaled, even with nothing else submitted
+		GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		while (status == GL_TIMEOUT_EXPIRED)
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+
+		glDeleteSync(fence);
+		fence = 0;
 	}
 
-	void Print(int value, float x, float y, float scale, float rotation, float red, float green, float blue)
+	void SetFramesInFlight(unsigned int frames)
 	{
-		PrintInternal(std::to_string(value), x, y, scale, rotation, -1, red, green, blue);
+		// regions are about to be laid out again, so nothing may still read them
+		for (GLsync& fence : Data->FrameFences)
+			WaitFrameFence(fence);
+
+		Data->FrameFences.assign(frames, 0);
+		StreamBuffer::m_Frame->FrameCount = frames;
+		StreamBuffer::m_Frame->FrameSlot = 0;
 	}
 
-	void Print(long value, float x, float y, float scale, float rotation, float red, float green, float blue)
+	void BeginFrame()
 	{
-		PrintInternal(std::to_string(value), x, y, scale, rotation, -1, red, green, blue);
+		CaptureScope capture(Data->Recorder, CAPTURE_BEGIN_FRAME);
+
+		if (Data->FrameFences.empty())
+			return;
+
+		// every stream buffer starts over in the next region
+		StreamBuffer::FrameState& frame = *StreamBuffer::m_Frame;
+		frame.FrameSerial++;
+		frame.FrameSlot = (unsigned int)(frame.FrameSerial % Data->FrameFences.size());
+		WaitFrameFence(Data->FrameFences[frame.FrameSlot]);
 	}
 
-	void Print(float value, float x, float y, float scale, float rotation, int digitTruncate, float red, float green, float blue)
+	void EndFrame()
 	{
-		PrintInternal(std::to_string(value), x, y, scale, rotation, digitTruncate, red, green, blue);
+		CaptureScope capture(Data->Recorder, CAPTURE_END_FRAME);
+
+		if (Data->FrameFences.empty())
+			return;
+
+		GLsync& fence = Data->FrameFences[StreamBuffer::m_Frame->FrameSlot];
+		if (fence)
+			glDeleteSync(fence);
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 	}
 
-	void Print(double value, float x, float y, float scale, float rotation, int digitTruncate, float red, float green, float blue)
+	void InitMultiView(Shader* shapeShader, Shader* renderShader, Shader* analyticShader, Shader* sdfTextShader, unsigned int viewsBinding)
 	{
-		PrintInternal(std::to_string(value), x, y, scale, rotation, digitTruncate, red, green, blue);
+		Data->ShapeViewShader = shapeShader;
+		Data->RenderViewShader = renderShader;
+		Data->AnalyticViewShader = analyticShader;
+		Data->SDFTextViewShader = sdfTextShader;
+
+		// std140 layout: MAX_VIEWS matrices, MAX_VIEWS viewport rects, then the view count padded to a vec4
+		Data->Views = new UBO(sizeof(float) * (MAX_VIEWS * 20 + 4), viewsBinding, "Views");
+		shapeShader->setUBO(*Data->Views);
+		renderShader->setUBO(*Data->Views);
+		if (analyticShader)
+			analyticShader->setUBO(*Data->Views);
+		if (sdfTextShader)
+			sdfTextShader->setUBO(*Data->Views);
 	}
 
-	void Print(const char* text, float x, float y, float scale, float rotation, float red, float green, float blue)
+	void SetViews(const glm::mat4* viewProjections, const glm::vec4* viewports, unsigned int count, int framebufferWidth, int framebufferHeight)
 	{
-		PrintInternal(std::string(text), x, y, scale, rotation, -1, red, green, blue);
+		// Multi-view needs its shaders, see InitMultiView()
+		assert(Data->Views != nullptr);
+		assert(count <= MAX_VIEWS);
+		assert(Data->ActiveLayer == nullptr);
+		// every queued draw type needs a shader drawing into the views
+		assert(count == 0 || !Data->AnalyticShader || Data->AnalyticViewShader);
+		assert(count == 0 || !Data->SDFTextRenderer || Data->SDFTextViewShader);
+		// damage tracking and software rendering only know a single view
+		assert(count == 0 || (!Data->Damage && !Data->Software));
+
+		Data->ViewCount = count;
+		Data->Renderer->SetViews(Data->RenderViewShader, count);
+		if (Data->SDFTextRenderer)
+			Data->SDFTextRenderer->SetViews(Data->SDFTextViewShader, count);
+
+		if (count == 0)
+			return;
+
+		float views[MAX_VIEWS * 20 + 4] = {};
+		for (unsigned int i = 0; i < count; i++)
+		{
+			memcpy(&views[i * 16], glm::value_ptr(viewProjections[i]), sizeof(float) * 16);
+
+			// scale and offset taking clip space of the whole framebuffer to the viewport
+			const glm::vec4& viewport = viewports[i];
+			float* rect = &views[MAX_VIEWS * 16 + i * 4];
+			rect[0] = viewport.z / framebufferWidth;
+			rect[1] = viewport.w / framebufferHeight;
+			rect[2] = (2.f * viewport.x + viewport.z) / framebufferWidth - 1.f;
+			rect[3] = (2.f * viewport.y + viewport.w) / framebufferHeight - 1.f;
+		}
+		views[MAX_VIEWS * 20] = (float)count;
+
+		Data->Views->SetData(views);
 	}
 
-	void Print(std::string text, float x, float y, float scale, float rotation, float red, float green, float blue)
+	unsigned int GetViewCount()
 	{
-		PrintInternal(text, x, y, scale, rotation, -1, red, green, blue);
+		return Data->ViewCount;
 	}
 
-	void Draw(TextureAtlas* atlas, unsigned int index, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
+	bool StartCapture(const std::string& path)
 	{
-		Data.Renderer->Draw(atlas, index, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
+		StopCapture();
+
+		Data->Recorder = new Capture();
+		if (!Data->Recorder->Open(path))
+		{
+			StopCapture();
+			return false;
+		}
+		return true;
 	}
 
-	void Draw(TextureAtlas* atlas, glm::vec4 calculatedQuad, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
+	void StopCapture()
 	{
-		Data.Renderer->Draw(atlas, calculatedQuad, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
+		delete Data->Recorder;
+		Data->Recorder = nullptr;
 	}
 
-	void Draw(CompiledRenderData& container)
+	void MakeCurrent(Context* context)
 	{
-		Data.Renderer->Draw(container);
+		CurrentContext = context;
+		if (context)
+		{
+			Data = &context->Data;
+			TextureAtlas::m_AtlasCount = &context->AtlasCount;
+			StreamBuffer::m_Frame = &context->Frame;
+		}
+		else
+		{
+			Data = &DefaultData;
+			TextureAtlas::m_AtlasCount = &TextureAtlas::m_DefaultAtlasCount;
+			StreamBuffer::m_Frame = &StreamBuffer::m_DefaultFrame;
+		}
 	}
 
-	void Render()
+	Context* GetCurrentContext()
 	{
-		Data.Renderer->Render();
+		return CurrentContext;
 	}
 
-	void CompileStaticDrawData(CompiledRenderData& container, TextureAtlas* atlas, glm::vec4 calculatedQuad, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
+	Context::~Context()
 	{
-		Data.Renderer->CompileStatic(container, atlas, calculatedQuad, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
+		if (CurrentContext == this)
+			MakeCurrent(nullptr);
 	}
 
-	void CompileStaticDrawData(CompiledRenderData& container, TextureAtlas* atlas, unsigned int index, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
+	FrameArena& GetFrameArena()
 	{
-		glm::vec4 calculatedQuad = atlas->GetQuad(index);
-		Data.Renderer->CompileStatic(container, atlas, calculatedQuad, x, y, width, height, rotation, rotationOffsetX, rotationOffsetY, red, green, blue);
+		return Data->Arena;
 	}
 
-	void LoadStaticDrawData(CompiledRenderData& container)
+	unsigned long long GetFrameAllocationCount()
 	{
-		Data.Renderer->LoadStaticData(container);
+		return Data->FrameAllocations;
 	}
 
-	void ClearStaticDrawData()
+	// Fan triangulate a convex polygon into a triangle list of (vertexCount - 2) * 6 floats
+	static void FanTriangulate(const float* vertices, unsigned int vertexCount, float* triangleList)
 	{
-		Data.Renderer->ClearStaticData();
+		for (unsigned int i = 1; i <= vertexCount - 2; i++)
+		{
+			float* triangle = triangleList + (i - 1) * 6;
+			triangle[0] = vertices[0];			// core point
+			triangle[1] = vertices[1];
+			triangle[2] = vertices[i * 2];		// next point according to the triangle index i
+			triangle[3] = vertices[i * 2 + 1];
+			triangle[4] = vertices[i * 2 + 2];	// next clockwise point from index i
+			triangle[5] = vertices[i * 2 + 3];
+		}
 	}
 
 	std::vector<float> TriangulatePolygon(float *vertices, unsigned int vertexCount)
 	{
+		TRACE_ZONE("Graphics::TriangulatePolygon");
 		std::vector<float> triangleList;
 		if (vertexCount < 3)
 			return triangleList;
 
-		if (vertexCount == 3)
-		{
-			triangleList.push_back(vertices[0]); // vertex 0
-			triangleList.push_back(vertices[1]);
-			triangleList.push_back(vertices[2]); // vertex 1
-			triangleList.push_back(vertices[3]);
-			triangleList.push_back(vertices[4]); // vertex 2
-			triangleList.push_back(vertices[5]);
-			return triangleList;
-		}
+		triangleList.resize((vertexCount - 2) * 6);
+		FanTriangulate(vertices, vertexCount, triangleList.data());
+		return triangleList;
+	}
 
-		for (unsigned int i = 1; i <= vertexCount - 2; i++)
-		{
-			triangleList.push_back(vertices[0]);		// core point
-			triangleList.push_back(vertices[1]);
-			triangleList.push_back(vertices[i * 2]);		// next point according to the triangle index i
-			triangleList.push_back(vertices[i * 2 + 1]);
-			triangleList.push_back(vertices[i * 2 + 2]);	// next clockwise point from index i
-			triangleList.push_back(vertices[i * 2 + 3]);
-		}
+	const float* TriangulatePolygon(const float* vertices, unsigned int vertexCount, unsigned int& floatCount)
+	{
+		TRACE_ZONE("Graphics::TriangulatePolygon");
+		floatCount = 0;
+		if (vertexCount < 3)
+			return nullptr;
 
+		floatCount = (vertexCount - 2) * 6;
+		float* triangleList = Data->Arena.Allocate<float>(floatCount);
+		FanTriangulate(vertices, vertexCount, triangleList);
 		return triangleList;
 	}
 
@@ -705,10 +2057,59 @@ namespace Graphics {
 		}
 	}
 
+	void TruncateDigits(std::string_view& text, int digits)
+	{
+		if (digits < 0) // if digits is negative, dont do anything
+			return;
+
+		size_t point = text.find('.');
+		if (point == std::string_view::npos)
+			return;
+
+		// strip the point when no digits are kept, otherwise everything after the (point + digits)
+		size_t length = digits == 0 ? point : point + 1 + digits;
+		if (length < text.size())
+			text = text.substr(0, length);
+	}
+
+	std::string_view FormatNumber(char* buffer, size_t size, long long value)
+	{
+		std::to_chars_result result = std::to_chars(buffer, buffer + size, value);
+		if (result.ec != std::errc())
+			return std::string_view();
+
+		return std::string_view(buffer, result.ptr - buffer);
+	}
+
+	std::string_view FormatNumber(char* buffer, size_t size, double value, int precision)
+	{
+		// std::to_string() prints 6 decimals
+		if (precision < 0)
+			precision = 6;
+
+		std::to_chars_result result = std::to_chars(buffer, buffer + size, value, std::chars_format::fixed, precision);
+		if (result.ec != std::errc())
+			return std::string_view();
+
+		return std::string_view(buffer, result.ptr - buffer);
+	}
+
 	GraphicsData::~GraphicsData()
 	{
 		delete Renderer;
+		delete SDFTextRenderer;
+		delete LayerRenderer;
+		delete LayerSDFTextRenderer;
+		if (Glyphs)
+			Glyphs->Clean();
+		delete Glyphs;
+		delete BulkTextMetrics;
+		if (FontAtlas)
+			FontAtlas->GetTexture().Clean();
 		delete FontAtlas;
+		delete Damage;
+		delete Recorder;
+		delete Views;
 	}
 
 } // end graphics namespace
\ No newline at end of file
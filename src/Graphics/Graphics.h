@@ -2,6 +2,21 @@
 #define SIMPLE_GRAPHICS_H
 
 #include "TextureRenderer.h"
+#include "PolygonMesh.h"
+#include "DensityRenderer.h"
+#include "TimeSeries.h"
+#include "GlyphCache.h"
+#include "FontMetrics.h"
+#include "TextBatch.h"
+#include "DamageTracker.h"
+#include "Layer.h"
+#include "SoftwareRenderer.h"
+#include "FrameArena.h"
+#include "Capture.h"
+#include "VirtualTexture.h"
+#include <cstdint>
+#include <list>
+#include <string_view>
 #include <vector>
 
 // ! Graphics Rendering Framework
@@ -20,6 +35,89 @@ namespace Graphics {
 		LINE
 	};
 
+	// Enum for point shapes - only used with a point shader, see InitPoints()
+	enum PointShape
+	{
+		// Point covers its whole size as a square
+		POINT_SQUARE,
+		// Point is masked to the circle inscribed in its square
+		POINT_ROUND
+	};
+
+	// Enum for the kind of geometry held by a queued shape run
+	enum ShapeRunType
+	{
+		// Run of triangles from the fill stream
+		SHAPE_RUN_FILL,
+		// Run of line pairs from the line stream
+		SHAPE_RUN_LINE,
+		// Run of analytic shape instances
+		SHAPE_RUN_ANALYTIC
+	};
+
+	// A contiguous range of vertices in one of the shape streams
+	// Consecutive shapes of the same type share a run and therefore a single draw call
+	struct ShapeRun
+	{
+		ShapeRunType Type;
+		unsigned int First;	// First vertex of the run, relative to the start of its stream
+		unsigned int Count;	// Vertex count of the run
+	};
+
+	// Text laid out once into glyph quads relative to its origin
+	// Redrawing a blob only moves and recolors its quads, nothing is laid out again
+	struct TextBlob
+	{
+		CompiledRenderData Glyphs;	// Glyph quads with the text's origin at (0, 0)
+		std::string Text;			// Laid out text
+		float Scale = 1.f;			// Scale the text was laid out at
+		float Rotation = 0.f;		// Rotation the text was laid out at
+		int Font = -1;				// TrueType font the text was laid out with, -1 for the bitmap font
+		float FontSize = 0.f;		// Pixel height of the TrueType font at scale 1
+		unsigned int Generation = 0;	// Glyph cache generation of the layout, stale layouts are redone on Draw()
+	};
+
+	// Slot of the text cache lookup table
+	struct TextCacheSlot
+	{
+		uint64_t Hash = 0;						// Hash of the blob's text, scale, rotation, font and font size
+		std::list<TextBlob>::iterator Blob;		// Cached blob, only valid when the slot is used
+		bool Used = false;
+	};
+
+	// Single argument of Format(), holds any printable value without allocating
+	struct FormatValue
+	{
+		enum ValueType { SIGNED, UNSIGNED, FLOATING, BOOLEAN, CHARACTER, TEXT };
+
+		FormatValue(short value) : Type(SIGNED), Signed(value) {}
+		FormatValue(int value) : Type(SIGNED), Signed(value) {}
+		FormatValue(long value) : Type(SIGNED), Signed(value) {}
+		FormatValue(long long value) : Type(SIGNED), Signed(value) {}
+		FormatValue(unsigned short value) : Type(UNSIGNED), Unsigned(value) {}
+		FormatValue(unsigned int value) : Type(UNSIGNED), Unsigned(value) {}
+		FormatValue(unsigned long value) : Type(UNSIGNED), Unsigned(value) {}
+		FormatValue(unsigned long long value) : Type(UNSIGNED), Unsigned(value) {}
+		FormatValue(float value) : Type(FLOATING), Floating(value) {}
+		FormatValue(double value) : Type(FLOATING), Floating(value) {}
+		FormatValue(bool value) : Type(BOOLEAN), Boolean(value) {}
+		FormatValue(char value) : Type(CHARACTER), Character(value) {}
+		FormatValue(const char* value) : Type(TEXT), Text(value) {}
+		FormatValue(std::string_view value) : Type(TEXT), Text(value) {}
+		FormatValue(const std::string& value) : Type(TEXT), Text(value) {}
+
+		ValueType Type;
+		union
+		{
+			long long Signed;
+			unsigned long long Unsigned;
+			double Floating;
+			bool Boolean;
+			char Character;
+		};
+		std::string_view Text;
+	};
+
 	// Wrapper struct for the data used to render
 	struct GraphicsData
 	{
@@ -32,38 +130,174 @@ namespace Graphics {
 		//! Copied Shader objects - used in rendering
 		Shader* ShapeShader = nullptr;		// Shader for shape rendering
 		Shader* RenderShader = nullptr;		// Shader for image/text rendering
+		Shader* PointShader = nullptr;		// Shader for per-point size and shape, optional
+
+		//! Line and point batch data - each batch owns its vao and buffer
+		//! Line vertices are interleaved as (x, y, r, g, b), point vertices as (x, y, r, g, b, size, shape)
+		//! Vertices are only recorded in cpu memory until the batch is popped
+		unsigned int LineVAO = 0;				// VAO for line rendering
+		StreamBuffer LineBuffer;				// Buffer for line vertices
+		unsigned int PointVAO = 0;				// VAO for point rendering
+		StreamBuffer PointBuffer;				// Buffer for point vertices
+		std::vector<float> LineVertices;		// Recorded line vertices, 2 per line
+		std::vector<float> PointVertices;		// Recorded point vertices
+
+		//! Batch state data
+		bool isLineBatched = false;				// Flag whether to batch lines or not
+		bool isPointBatched = false;			// Flag whether to batch points or not
+
+		//! Deferred shape streams - used by polygons, circles and rectangles
+		//! Vertices are interleaved as (x, y, r, g, b) and flushed by FlushShapes()
+		unsigned int ShapeVAO = 0;				// VAO for the deferred shape streams
+		StreamBuffer ShapeBuffer;				// Buffer holding the fill stream followed by the line stream
+		unsigned int ShapeBufferOffset = 0;		// Byte offset of the uploaded fill stream in ShapeBuffer
+		std::vector<float> ShapeFillVertices;	// Triangle list vertices of all FILL shapes
+		std::vector<float> ShapeLineVertices;	// Line pair vertices of all LINE shapes
+		std::vector<ShapeRun> ShapeRuns;		// Submission ordered runs of all streams
+
+		//! Analytic shape data - used by the Analytic* shape functions
+		//! Instances are (center x, y, half width, half height, corner radius, thickness, rotation, r, g, b)
+		Shader* AnalyticShader = nullptr;		// Shader evaluating the shape distance field
+		unsigned int AnalyticVAO = 0;			// VAO for analytic shape instances
+		unsigned int AnalyticQuadVBO = 0;		// Unit quad shared by every instance
+		StreamBuffer AnalyticBuffer;			// Buffer for per-instance data
+		unsigned int AnalyticBufferOffset = 0;	// Byte offset of the uploaded instances in AnalyticBuffer
+		std::vector<float> AnalyticInstances;	// Instance data of all queued analytic shapes
+
+		//! Polygon mesh data - used to draw compiled PolygonMesh objects
+		Shader* MeshShader = nullptr;			// Shader applying the per-draw transform and color
+		int MeshTransformLocation = -1;			// Cached location of the transform uniform
+		int MeshColorLocation = -1;				// Cached location of the color uniform
 
-		//! OpenGL object IDs - used in shape rendering
-		unsigned int VAO = 0;					// VAO for all shape rendering opperations
-		unsigned int VBO = 0;					// Buffer for vertex data
-		unsigned int ColorVBO = 0;				// Buffer for color data
-
-		//! Data vectors for batched drawing - used only for lines and points
-		std::vector<float> BatchVector;
-		std::vector<float> ColorVector;
-
-		//! Batch state data - used only for lines and points
-		bool isBatched = false;					// Flag whether to batch or not
-		unsigned int BatchCapacity = 0;		// Size limit of the batch vectors - in terms of a single batch, not singular vertices/values
-		unsigned int BatchSize = 0;			// Current size count in the vectors - used for correctly indexing the vectors
-		
 		//! Font data - used in text loading and rendering
 		TextureAtlas* FontAtlas = nullptr;	// Constructed atlas that holds the image texture
+		unsigned int FontGeneration = 0;		// Bumped every time FontAtlas is replaced
 		int FontWidths[256] = {};				// Array of all the individual letter widths
+		int FontBearings[256] = {};				// Array of all the individual letter cell offsets
+		std::vector<FontKerningPair> FontKerning;	// Pen adjustments between letter pairs, sorted
 		int FontStartingChar = -1;				// Starting character of the image
 		int FontCellWidth = -1;					// Texture-specific quad width
 		int FontCellHeight = -1;				// Texture-specific quad height
+
+		//! Distance field text - optional, see InitSDFText()
+		Shader* SDFTextShader = nullptr;			// Shader reconstructing glyph edges from the distance field
+		TextureRenderer* SDFTextRenderer = nullptr;	// Renderer for text of a distance field font
+		bool isFontSDF = false;						// Flag whether the loaded font is a distance field
+
+		//! Bulk text data - used to draw TextBatch objects, see InitBulkText()
+		Shader* BulkTextShader = nullptr;		// Shader expanding char codes into glyph quads
+		UBO* BulkTextMetrics = nullptr;			// Atlas cell and bearing of every char of the loaded font
+		unsigned int BulkTextFontGeneration = 0;	// Font generation the metrics were built for
+		int BulkTextRunUnit = -1;				// Texture unit the run table of a batch is bound to
+		int BulkTextCellSizeLocation = -1;		// Cached uniform locations
+		int BulkTextCellUVLocation = -1;
+		int BulkTextFontLocation = -1;
+		int BulkTextDistanceFieldLocation = -1;
+
+		//! TrueType fonts - optional, see LoadTrueTypeFont()
+		GlyphCache* Glyphs = nullptr;			// Cache rasterizing TrueType glyphs on first use
+		int ActiveFont = -1;					// TrueType font used for text, -1 uses the bitmap font
+		float ActiveFontSize = 32.f;			// Pixel height of the active TrueType font at scale 1
+
+		//! Text cache - least recently used blobs of printed strings, so repeated prints skip layout
+		std::list<TextBlob> TextCache;			// Cached blobs, most recently used first
+		std::vector<TextCacheSlot> TextCacheLookup;	// Open addressing table of blobs by text, scale, rotation, active font and font size, sized with the capacity
+		unsigned int TextCacheCapacity = 256;	// Maximum blob count, 0 disables the cache
+
+		//! Layer data - while a layer is drawn, its renderers and shape streams are swapped in for the screen's
+		Layer* ActiveLayer = nullptr;				// Layer between BeginLayer() and EndLayer()
+		TextureRenderer* LayerRenderer = nullptr;	// Set aside renderer, the screen's while a layer is drawn
+		TextureRenderer* LayerSDFTextRenderer = nullptr;
+		std::vector<float> LayerFillVertices;		// Set aside shape streams
+		std::vector<float> LayerLineVertices;
+		std::vector<float> LayerAnalyticInstances;
+		std::vector<ShapeRun> LayerShapeRuns;
+
+		//! Damage tracking - optional, see EnableDamageTracking()
+		DamageTracker* Damage = nullptr;		// Tile hashes and offscreen target of damage tracked frames
+
+		//! Software rendering - optional, see SetSoftwareRenderer()
+		SoftwareRenderer* Software = nullptr;	// Rasterizer receiving queued draws instead of GL, not owned
+
+		//! Transient frame data - shape and text helpers allocate from here instead of the heap, reset by Render()
+		FrameArena Arena;
+		unsigned long long FrameAllocationStart = 0;	// Heap allocation count at the start of the frame
+		unsigned long long FrameAllocations = 0;		// Heap allocations of the last frame, see GetFrameAllocationCount()
+
+		//! Frame pipelining - optional, see SetFramesInFlight()
+		std::vector<GLsync> FrameFences;		// Fence of the last frame built in each stream buffer region, 0 when none
+
+		//! Capture - optional, see StartCapture()
+		Capture* Recorder = nullptr;			// Stream recording every captured call, nullptr while not capturing
+
+		//! Multi-view - optional, see InitMultiView()
+		Shader* ShapeViewShader = nullptr;		// Shaders drawing one instance per view
+		Shader* RenderViewShader = nullptr;
+		Shader* AnalyticViewShader = nullptr;
+		Shader* SDFTextViewShader = nullptr;
+		UBO* Views = nullptr;					// View projection and viewport of every view
+		unsigned int ViewCount = 0;				// Views set by SetViews(), 0 draws a single view with the Matrices projection
+	};
+
+	// Independent set of rendering state: renderers, shape streams, fonts, texture units and frame pipelining
+	// Every free function works on the context current on the calling thread, a default context until MakeCurrent() is called
+	struct Context
+	{
+		//! Cleanup function, makes the default context current again when this one is current on the calling thread
+		~Context();
+
+		GraphicsData Data;					// State used by the free functions while the context is current
+		int AtlasCount = 0;					// Texture units claimed by the context's atlases, see TextureAtlas::GetAtlasCount()
+		StreamBuffer::FrameState Frame;		// Region state of the context's stream buffers
 	};
 
 	// Initialize Graphics rendering data
 	// Constructs a TextureRenderer object given the renderShader
 	void Init(Shader* polygonShader, Shader* renderShader);
 
-	void LoadFont(std::string fontImagePath, std::string fontDataPath);
+	// Load a bitmap font from its atlas image and font data
+	// The font data is either the CSV of the font generator or the binary format from ConvertFontData()
+	// Returns false and prints the error when the font data is missing or malformed or the atlas image can't be loaded, the previous font stays loaded
+	bool LoadFont(std::string fontImagePath, std::string fontDataPath);
+
+	// Convert CSV font data into the binary font metrics format, which loads with a single file read
+	// Besides the generator's fields, "Char N Bearing,x" and "Kerning L R,x" lines fill the bearing and kerning tables
+	bool ConvertFontData(std::string csvPath, std::string binaryPath);
+
+	// Set up distance field text with a shader created from the SDF_TEXT premade type, required by LoadSDFFont()
+	void InitSDFText(Shader* sdfTextShader);
+
+	// Load a bitmap font like LoadFont() and convert its atlas into a signed distance field
+	// The one atlas then draws crisp text at any Print() scale, instead of one atlas per size
+	// spread is the distance in atlas pixels the field covers on each side of a glyph edge, larger values hold up better when scaled down
+	// * text needs alpha blending enabled, and is drawn after all images on Render()
+	bool LoadSDFFont(std::string fontImagePath, std::string fontDataPath, int spread = 4);
+
+	// ! TrueType fonts
+	// Glyphs are rasterized on first use into shared glyph cache pages, each page claims one texture unit
+	// When every page is full the least recently used page is cleared and reused, so memory follows the glyphs actually drawn
+
+	// Set up the glyph cache with pageSize x pageSize pixel pages, optional before the first LoadTrueTypeFont()
+	void InitGlyphCache(int pageSize = 1024, int maxPages = 4);
+
+	// Load a TrueType font, returns its handle or -1 when the file could not be read
+	int LoadTrueTypeFont(std::string fontPath);
+
+	// Select the font used by Print() and CompileTextBlob(), text of a TrueType font is decoded as utf-8
+	// pixelHeight is the font size at scale 1, every scaled size is rasterized on its own so text stays sharp
+	// Pass -1 to go back to the font from LoadFont() or LoadSDFFont()
+	void SetFont(int font, float pixelHeight = 32.f);
+	int GetFont();
+	float GetFontSize();
+
+	// Distance between the tops of two lines of text at the given scale, in the active font
+	float GetLineHeight(float scale = 1.f);
 
 	TextureRenderer* GetRenderer();
 
 	// ! Basic shape functions
+	// Shapes are not drawn immediately, they are queued into a triangle stream (FILL) and a line stream (LINE)
+	// Queued shapes are drawn in submission order on FlushShapes(), Render() or any line/point draw
 
 	// Draw a polygon from an array of vertices and a given vertex count and color
 	void Polygon(DrawMode mode, float *vertices, unsigned int vertexCount, float red = 1.f, float green = 1.f, float blue = 1.f);
@@ -78,6 +312,46 @@ namespace Graphics {
 	// * Rotation in radians
 	void Rectangle(DrawMode mode, float x, float y, float width, float height, float rotation = 0.f, float rotOffsetX = 0.f, float rotOffsetY = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
 
+	// ! Analytic shapes
+	// Each shape is a single quad with a signed distance field evaluated per pixel
+	// Edges are anti-aliased at any size for a constant cost, and they are queued with the other shapes
+	// * output uses alpha for the anti-aliased edge, blending needs to be enabled
+	// * lineWidth is only used in LINE mode
+
+	// Set up analytic shape rendering with a shader created from the ANALYTIC_SHAPE premade type
+	void InitAnalyticShapes(Shader* analyticShader);
+
+	// Draw a circle of a given radius and color
+	void AnalyticCircle(DrawMode mode, float x, float y, float radius, float red = 1.f, float green = 1.f, float blue = 1.f, float lineWidth = 1.f);
+
+	// Draw a ring of a given outer radius and thickness
+	void AnalyticRing(float x, float y, float radius, float thickness, float red = 1.f, float green = 1.f, float blue = 1.f);
+
+	// Draw a rectangle of top left origin with rounded corners
+	// Rotation offset changes the origin of rotation
+	// * Rotation in radians
+	void AnalyticRoundedRectangle(DrawMode mode, float x, float y, float width, float height, float cornerRadius, float rotation = 0.f, float rotOffsetX = 0.f, float rotOffsetY = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f, float lineWidth = 1.f);
+
+	// Draw a capsule, a line from (x1, y1) to (x2, y2) with round caps of a given radius
+	void AnalyticCapsule(DrawMode mode, float x1, float y1, float x2, float y2, float radius, float red = 1.f, float green = 1.f, float blue = 1.f, float lineWidth = 1.f);
+
+	// ! Polygon meshes
+	// Polygons compiled once into a PolygonMesh, so static polygons are never triangulated or uploaded again
+	// * meshes are drawn immediately, after any queued shapes
+
+	// Set up polygon mesh rendering with a shader created from the POLYGON_MESH premade type
+	void InitPolygonMeshes(Shader* meshShader);
+
+	// Draw a compiled polygon mesh, transformed by scale, then rotation, then position
+	// * Rotation in radians, around the polygon's own origin
+	void Draw(PolygonMesh& mesh, DrawMode mode, float x, float y, float rotation = 0.f, float scale = 1.f, float red = 1.f, float green = 1.f, float blue = 1.f);
+
+	// Upload and draw all queued shapes
+	// * issues one draw call per run of same mode shapes, so usually one or two per frame
+	// * does nothing with damage tracking enabled, the shapes are drawn on Render()
+	// * queues the shapes into the software renderer instead when one is set
+	void FlushShapes();
+
 	// ! Lines - able to be batched together
 
 	// Enable line batching.
@@ -91,22 +365,67 @@ namespace Graphics {
 
 	// ! Points - able to be batched together
 
+	// Set up per-point sizes and shapes with a shader created from the POINT_SPRITE premade type
+	// Without it every point of a batch is drawn square with the size given to BatchPointsPop()
+	void InitPoints(Shader* pointShader);
+
 	// Enable point batching.
 	void BatchPointsPush();
 
-	// Draw a point given a size and color
+	// Draw a point given a size, color and shape
 	// * size is basically the radius in pixels, but square
-	// * size is unused if batch, set size in the BatchPointsPop() call
-	void Point(float x, float y, unsigned int size = 1, float red = 1.f, float green = 1.f, float blue = 1.f);
+	// * size and shape are per point with a point shader, otherwise size is unused if batch and set in the BatchPointsPop() call
+	void Point(float x, float y, unsigned int size = 1, float red = 1.f, float green = 1.f, float blue = 1.f, PointShape shape = POINT_SQUARE);
 
 	// Disable point batching and issue the draw call for all Graphics::Point() calls after the last Graphics::BatchPointsPush().
-	// "pointSize" is the pixel size in radius.
+	// "pointSize" is the pixel size in radius, only used without a point shader.
 	void BatchPointsPop(unsigned int pointSize = 1);
 
+	// ! Time series
+
+	// Draw a series as a single line strip, decimated per pixel column for the given view
+	// The view spans viewLeft to viewRight in x units over pixelWidth columns, usually the chart's on screen width
+	// * drawn immediately, after any queued shapes
+	void Draw(TimeSeries& series, float viewLeft, float viewRight, unsigned int pixelWidth, float red = 1.f, float green = 1.f, float blue = 1.f);
+
+	// ! Point clouds
+	// Very large point sets are binned into a DensityRenderer instead of being drawn point by point
+
+	// Color map a density grid to the screen, after any queued shapes
+	// maxDensity is the point count mapped to the top of the color map, 0 uses the grid's maximum
+	void Draw(DensityRenderer& density, float maxDensity = 0.f);
+
 	// ! Text printing
 
+	// Lay out text into a blob, to be drawn any number of times with Draw()
+	void CompileTextBlob(TextBlob& blob, std::string_view text, float scale = 1.f, float rotation = 0.f);
+
+	// Draw a laid out blob starting from (x, y)
+	void Draw(TextBlob& blob, float x, float y, float red = 1.f, float green = 1.f, float blue = 1.f);
+
+	// ! Bulk text
+	// Text added to a TextBatch only uploads its char codes, the BULK_TEXT shader builds the glyph quads on the GPU
+	// Uses the font from LoadFont() or LoadSDFFont()
+
+	// Set up bulk text with a shader created from the BULK_TEXT premade type
+	// metricsBinding is the uniform buffer binding site of the glyph metrics, it must differ from the Matrices binding
+	void InitBulkText(Shader* bulkTextShader, unsigned int metricsBinding = 1);
+
+	// Add text to a batch, laid out like Print()
+	// * text past TextBatch::GetMaxRuns() runs is dropped
+	void BatchText(TextBatch& batch, std::string_view text, float x, float y, float scale = 1.f, float rotation = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
+
+	// Draw every run of a batch with a single draw call
+	// * drawn immediately, after any queued shapes
+	void Draw(TextBatch& batch);
+
+	// Set how many printed strings are kept laid out for the Print() functions, 0 disables the cache
+	// * strings are keyed by text, scale and rotation, so labels that keep changing only churn the cache, printed numbers are never cached
+	void SetTextCacheCapacity(unsigned int capacity);
+
 	// Internal initial overloaded print function. 
-	void PrintInternal(std::string text, float x, float y, float scale = 1.f, float rotation = 0.f, int digitTruncate = -1, float red = 1.f, float green = 1.f, float blue = 1.f);
+	// * text is only copied when it misses the text cache, numbers skip the cache and are laid out straight into the renderer, so printing them never allocates
+	void PrintInternal(std::string_view text, float x, float y, float scale = 1.f, float rotation = 0.f, int digitTruncate = -1, float red = 1.f, float green = 1.f, float blue = 1.f);
 	
 	// ! Print function overloads
 
@@ -124,18 +443,36 @@ namespace Graphics {
 	void Print(long value, float x, float y, float scale = 1.f, float rotation = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
 	// Print to screen, starting from (x, y)
 	// rotation in radians
-	// digitTruncate controls how many digits after the decimal are drawn, set -1 for no truncation
+	// digitTruncate controls how many digits after the decimal are drawn, the last one rounded, set -1 for no truncation
 	void Print(float value, float x, float y, float scale = 1.f, float rotation = 0.f, int digitTruncate = -1, float red = 1.f, float green = 1.f, float blue = 1.f);
 	// Print to screen, starting from (x, y)
 	// rotation in radians
-	// digitTruncate controls how many digits after the decimal are drawn, set -1 for no truncation
+	// digitTruncate controls how many digits after the decimal are drawn, the last one rounded, set -1 for no truncation
 	void Print(double value, float x, float y, float scale = 1.f, float rotation = 0.f, int digitTruncate = -1, float red = 1.f, float green = 1.f, float blue = 1.f);
 	// Print to screen, starting from (x, y)
 	// rotation in radians
 	void Print(const char* text, float x, float y, float scale = 1.f, float rotation = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
 	// Print to screen, starting from (x, y)
 	// rotation in radians
-	void Print(std::string text, float x, float y, float scale = 1.f, float rotation = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
+	void Print(const std::string& text, float x, float y, float scale = 1.f, float rotation = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
+	// Print to screen, starting from (x, y)
+	// rotation in radians
+	void Print(std::string_view text, float x, float y, float scale = 1.f, float rotation = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
+
+	// Non-template core of Format()
+	std::string_view FormatInternal(char* buffer, size_t size, std::string_view format, const FormatValue* values, size_t valueCount);
+
+	// Format a composite label into a caller provided buffer, returns the formatted part of the buffer
+	// "{}" is replaced by the next argument, "{:.N}" prints a floating point argument with N decimals, "{{" and "}}" are literal braces
+	// * output past the end of the buffer is cut off
+	// ex: char buffer[64]; Print(Format(buffer, sizeof(buffer), "{} fps ({:.2} ms)", fps, ms), 10.f, 10.f);
+	template<typename... Args>
+	std::string_view Format(char* buffer, size_t size, std::string_view format, const Args&... args)
+	{
+		// one extra element so an empty argument list is still a valid array
+		const FormatValue values[] = { FormatValue(args)..., FormatValue(0) };
+		return FormatInternal(buffer, size, format, values, sizeof...(Args));
+	}
 
 	// ! Image rendering
 
@@ -146,8 +483,15 @@ namespace Graphics {
 	void Draw(TextureAtlas* atlas, glm::vec4 calculatedQuad, float x, float y, float width, float height, float rotation = 0.f, float rotationOffsetX = 0.f, float rotationOffsetY = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
 	void Draw(CompiledRenderData& container);
 
+	// Draw the visible part of a virtual texture, an image of any size streamed in tiles, see VirtualTexture
+	// The image is centered at (x, y) like other images, view is the visible rect of top left origin (x, y, width, height) spanning pixelWidth pixels on screen
+	// * tiles that are still loading are drawn blurry from a coarser level, call every frame until GetPendingCount() is 0
+	void Draw(VirtualTexture& texture, float x, float y, float width, float height, glm::vec4 view, unsigned int pixelWidth, float red = 1.f, float green = 1.f, float blue = 1.f);
+
 	// Renderer final Draw call
-	// Renders all image 'Draw()' calls since the last Render() call
+	// Flushes queued shapes, then renders all image 'Draw()' calls since the last Render() call
+	// * resets the frame arena, see GetFrameArena()
+	// * with damage tracking enabled only the damaged rects are redrawn, see EnableDamageTracking()
 	void Render();
 
 	// Compile a static image to be drawn, loads the quad into a CompiledRenderData
@@ -160,20 +504,152 @@ namespace Graphics {
 	// Clear any static data stored in the TextureRenderer
 	void ClearStaticDrawData();
 
+	// ! Layers
+	// Rarely changing content is drawn once into a Layer, then composited as a single quad every frame
+	// * layer content uses the Matrices projection as it is, so a screen sized layer lines up with the screen
+	// * nothing drawn on the screen before BeginLayer() ends up in the layer, queued screen draws are set aside
+
+	// Start drawing into a layer, returns false when the layer is clean and there is nothing to draw
+	// ex: if (Graphics::BeginLayer(background)) { ...draw calls...; Graphics::EndLayer(); }
+	bool BeginLayer(Layer& layer);
+
+	// Draw everything queued since BeginLayer() into the layer, and go back to drawing on the screen
+	void EndLayer();
+
+	// Composite a layer with its top left at (x, y), the color multiplies the layer's pixels
+	void Draw(Layer& layer, float x, float y, float red = 1.f, float green = 1.f, float blue = 1.f);
+
+	// ! Multi-view
+	// Minimaps and split screens draw the same frame into several viewports, each with its own view projection
+	// Shapes, images and text queued for Render() are uploaded once and drawn as one instance per view, so vertex generation and upload don't grow with the view count
+	// * views are carved out of the framebuffer and clipped in the vertex shader, so the GL viewport has to cover the whole framebuffer
+	// * anything drawn immediately (meshes, time series, density grids, text batches, lines and points) and layer content use the Matrices projection
+	// * not combined with damage tracking or software rendering
+
+	// Maximum number of views drawn at once
+	const unsigned int MAX_VIEWS = 8;
+
+	// Set up multi-view drawing with shaders created from the SHAPE_MULTI_VIEW, TEXTURE_RENDERER_MULTI_VIEW, ANALYTIC_SHAPE_MULTI_VIEW and SDF_TEXT_MULTI_VIEW premade types
+	// the analytic and distance field shaders are required once InitAnalyticShapes() and InitSDFText() are used, nullptr otherwise
+	// viewsBinding is the uniform buffer binding site of the views, it must differ from the Matrices and glyph metrics bindings
+	void InitMultiView(Shader* shapeShader, Shader* renderShader, Shader* analyticShader = nullptr, Shader* sdfTextShader = nullptr, unsigned int viewsBinding = 2);
+
+	// Draw the following frames into count views, up to MAX_VIEWS, pass a count of 0 to draw a single view with the Matrices projection again
+	// viewports are (x, y, width, height) in pixels with a bottom left origin, like glViewport(), of a framebuffer of framebufferWidth x framebufferHeight
+	// * set between frames, outside of layers
+	void SetViews(const glm::mat4* viewProjections, const glm::vec4* viewports, unsigned int count, int framebufferWidth, int framebufferHeight);
+
+	// Number of views set by SetViews(), 0 when drawing a single view
+	unsigned int GetViewCount();
+
+	// ! Damage tracking
+	// Frames are kept in an offscreen target, and Render() only redraws the screen tiles whose shapes, images or text changed
+	// Changed tiles are merged into rects, each cleared and redrawn with glScissor, then the target is copied to the screen
+	// * only what Render() draws is tracked, shapes are no longer flushed early by other draws
+	// * meshes, time series, density grids, text batches, lines and points draw immediately, draw them after Render() so they land on the copied frame
+	// * texture contents are not hashed, use Damage() after changing a texture that is on screen
+
+	// Enable damage tracking for a width x height framebuffer
+	// viewProjection is the matrix of the Matrices uniform buffer, used to find the tiles a primitive covers
+	void EnableDamageTracking(int width, int height, glm::mat4 viewProjection, int tileSize = 32);
+	void DisableDamageTracking();
+
+	// Update the framebuffer size or view projection, the next frame is redrawn whole
+	void SetDamageViewport(int width, int height, glm::mat4 viewProjection);
+
+	// Redraw a region on the next Render() even if nothing drawn there changed
+	void Damage(float x, float y, float width, float height);
+
+	// Rects redrawn by the last Render(), in framebuffer pixels with a bottom left origin
+	const std::vector<DamageRect>& GetDamageRects();
+
+	// ! Software rendering
+	// Queued shapes, images and text are rasterized on the CPU into the framebuffer of a SoftwareRenderer instead of drawn with GL
+	// * a GL context is still required, Init(), renderers and atlases create GL objects, only the drawing moves to the CPU
+	// * every texture drawn from needs its pixels registered with SoftwareRenderer::SetTexture(), nothing is read back from GL
+	// * static draw data, layers and damage tracking are not rasterized, neither is anything drawn immediately (meshes, time series, density grids, text batches, lines and points)
+
+	// Send queued draws to a software renderer on FlushShapes() and Render(), pass nullptr to draw with GL again
+	// * the renderer is not owned, it has to outlive its use
+	void SetSoftwareRenderer(SoftwareRenderer* renderer);
+
+	// ! Frame pipelining
+	// Every buffer streamed per frame is split into one region per frame in flight, each guarded by a fence
+	// The CPU builds frame N + 1 into its own region while the GPU still draws frame N, and only waits when it gets a whole ring ahead
+	// * with frames in flight every frame has to be built between BeginFrame() and EndFrame()
+
+	// Set how many frames the CPU may build ahead of the GPU, waits for the frames in flight first
+	// 1 keeps the lowest latency, but the CPU waits for every frame, 2 or 3 overlap the CPU with the GPU for more throughput and as many frames of latency
+	// Pass 0 to go back to orphaning the buffers on every upload, which leaves the overlap to the driver
+	void SetFramesInFlight(unsigned int frames);
+
+	// Start building a frame, waits only while the GPU still draws the frame that last used this frame's region
+	void BeginFrame();
+
+	// End the frame after its last draw, fencing the commands that read its region
+	// * call before swapping buffers
+	void EndFrame();
+
+	// ! Capture
+	// Shape, batch, image, text, static data, font and frame calls are recorded into a binary stream, with their arguments
+	// Capture::Replay() issues a stream again as fast as possible on any context, timing the CPU and GPU of every frame
+	// * setup (Init functions, shaders, view projection) and objects drawing their own data (meshes, time series, density, text batches, layers, virtual textures) are not recorded
+	// * images drawn during a capture are recorded by size only, and replayed from blank textures
+
+	// Start recording the calls of the current context into a file, returns false when it can't be created
+	bool StartCapture(const std::string& path);
+
+	// Stop recording and finish the file
+	void StopCapture();
+
+	// ! Contexts
+	// Each context holds its own renderers, buffers, fonts and texture units, so contexts never share state
+	// Run one context per thread, each with its own current GL context (like a HeadlessContext), to render independently in parallel
+	// * a context is used by one thread at a time, and its GL objects belong to the GL context current when it was initialized
+	// * objects created while a context is current (atlases, layers, density renderers) claim that context's texture units
+
+	// Make a context current on the calling thread, pass nullptr for the default context
+	// Every following call on this thread, including Init(), works on that context
+	void MakeCurrent(Context* context);
+
+	// Context current on the calling thread, nullptr for the default context
+	Context* GetCurrentContext();
+
 	// ! Utility functions
 
+	// Arena for data that only has to live for the current frame, everything in it is released by Render()
+	FrameArena& GetFrameArena();
+
+	// Heap allocations made on the calling thread during the last frame, from one Render() to the next
+	// Steady frames of shapes, images and printed text report 0, check it in debug builds to catch allocations creeping back in
+	// * only counted with GRAPHICS_COUNT_ALLOCATIONS defined, which replaces the global operator new, 0 otherwise
+	unsigned long long GetFrameAllocationCount();
+
 	// Triangulate a SIMPLE, CONVEX polygon
-	// * undefined behavior for complex/concave polygons
+	// * undefined behavior for complex/concave polygons, see PolygonMesh::Triangulate() for those
 	// Returns a vector of calculated triangles (6 floats per triangle, 2 floats per coord)
 	std::vector<float> TriangulatePolygon(float* vertices, unsigned int vertexCount);
+	// Triangulate into the frame arena instead, floatCount receives the size of the returned triangle list
+	// * the triangles are valid until the next Render()
+	const float* TriangulatePolygon(const float* vertices, unsigned int vertexCount, unsigned int& floatCount);
 
 	// Split up a given string based on a seperator char
 	// Outputs into an array
+	// * no longer used by font loading, kept public for applications parsing their own data
 	int split(std::string inputString, char seperator, std::string output[], int size);
 
 	// Given a float in string form, truncate x amount of digits from the decimal
 	// Pass -1 to not truncate at all
 	void TruncateDigits(std::string& text, int digits);
+	// Given a float in string form, shorten the view to x amount of digits from the decimal
+	// Pass -1 to not truncate at all
+	void TruncateDigits(std::string_view& text, int digits);
+
+	// Write a number into a buffer without allocating, returns the written part of the buffer
+	// precision is the digit count after the decimal, -1 matches std::to_string()
+	// * a buffer of 32 chars fits any integer, floating point values may need up to 311 plus the precision
+	std::string_view FormatNumber(char* buffer, size_t size, long long value);
+	std::string_view FormatNumber(char* buffer, size_t size, double value, int precision = -1);
 
 }	// namespace Graphics
 
@@ -0,0 +1,90 @@
+#include "HeadlessContext.h"
+
+#ifdef GRAPHICS_HEADLESS_EGL
+
+#include <GL/glew.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+#include <iostream>
+
+bool HeadlessContext::Create(int majorVersion, int minorVersion)
+{
+	// the surfaceless platform needs no GPU device or display server, fall back to the default display without it
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay)
+		m_Display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	if (m_Display == EGL_NO_DISPLAY)
+		m_Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	if (m_Display == EGL_NO_DISPLAY || !eglInitialize(m_Display, NULL, NULL))
+	{
+		std::cout << "Error: Failed to initialize an EGL display!" << std::endl;
+		return false;
+	}
+
+	const char* extensions = eglQueryString(m_Display, EGL_EXTENSIONS);
+	if (!extensions || !strstr(extensions, "EGL_KHR_surfaceless_context"))
+	{
+		std::cout << "Error: EGL display does not support surfaceless contexts!" << std::endl;
+		Destroy();
+		return false;
+	}
+
+	// surfaceless displays have no window configs, and window is the default surface type
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(m_Display, configAttributes, &config, 1, &configCount) || configCount == 0)
+	{
+		std::cout << "Error: No EGL config renders OpenGL!" << std::endl;
+		Destroy();
+		return false;
+	}
+
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, majorVersion,
+		EGL_CONTEXT_MINOR_VERSION, minorVersion,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	m_Context = eglCreateContext(m_Display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (m_Context == EGL_NO_CONTEXT || !eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_Context))
+	{
+		std::cout << "Error: Failed to create an OpenGL " << majorVersion << "." << minorVersion << " core context!" << std::endl;
+		Destroy();
+		return false;
+	}
+
+	// glew built for glx reports a missing X display, though every entry point still loads through EGL
+	glewExperimental = GL_TRUE;
+	GLenum result = glewInit();
+	if (result != GLEW_OK && result != GLEW_ERROR_NO_GLX_DISPLAY)
+	{
+		std::cout << "Error: Failed to initialize glew: " << glewGetErrorString(result) << std::endl;
+		Destroy();
+		return false;
+	}
+
+	return true;
+}
+
+void HeadlessContext::Destroy()
+{
+	if (m_Display == EGL_NO_DISPLAY)
+		return;
+
+	eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (m_Context != EGL_NO_CONTEXT)
+		eglDestroyContext(m_Display, m_Context);
+	eglTerminate(m_Display);
+
+	m_Context = EGL_NO_CONTEXT;
+	m_Display = EGL_NO_DISPLAY;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+// OpenGL context without a window or display server, for rendering chart images on servers
+// Only built with GRAPHICS_HEADLESS_EGL defined, it needs EGL with surfaceless contexts, like Mesa's
+// Render into an OffscreenTarget, as the context has no default framebuffer
+#ifdef GRAPHICS_HEADLESS_EGL
+
+#include <EGL/egl.h>
+
+class HeadlessContext
+{
+public:
+	HeadlessContext() = default;
+
+	// create an OpenGL core context, make it current on the calling thread and initialize glew
+	// returns false and prints the failing step when the context could not be created
+	bool Create(int majorVersion = 3, int minorVersion = 3);
+	// release and destroy the context
+	void Destroy();
+
+private:
+	EGLDisplay m_Display = EGL_NO_DISPLAY;
+	EGLContext m_Context = EGL_NO_CONTEXT;
+};
+
+#endif
+
+#endif
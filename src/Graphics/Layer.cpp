@@ -0,0 +1,109 @@
+#include "Layer.h"
+
+#include <iostream>
+
+Layer::Layer(int width, int height)
+	: m_Atlas(nullptr, width, height, 4)
+{
+	// content is blended into the layer as premultiplied color, see Begin()
+	m_Atlas.SetPremultiplied(true);
+
+	glGenFramebuffers(1, &m_FBO);
+
+	// attach the texture, keeping whatever framebuffer was bound
+	int previousFBO = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_Atlas.GetTexture().GetID(), 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: Layer framebuffer incomplete!" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+}
+
+void Layer::Resize(int width, int height)
+{
+	// the texture object stays the same, so the framebuffer attachment stays valid
+	m_Atlas.Resize(width, height);
+	m_Dirty = true;
+}
+
+void Layer::MarkDirty()
+{
+	m_Dirty = true;
+}
+
+bool Layer::IsDirty()
+{
+	return m_Dirty;
+}
+
+void Layer::SetClearColor(float red, float green, float blue, float alpha)
+{
+	m_ClearColor[0] = red;
+	m_ClearColor[1] = green;
+	m_ClearColor[2] = blue;
+	m_ClearColor[3] = alpha;
+}
+
+void Layer::Begin()
+{
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_PreviousFBO);
+	glGetIntegerv(GL_VIEWPORT, m_PreviousViewport);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	glViewport(0, 0, m_Atlas.GetTextureWidth(), m_Atlas.GetTextureHeight());
+
+	// clear to the layer's color, premultiplied like the content, restoring the clear color afterwards
+	float clearColor[4];
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+	float alpha = m_ClearColor[3];
+	glClearColor(m_ClearColor[0] * alpha, m_ClearColor[1] * alpha, m_ClearColor[2] * alpha, alpha);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+	// straight blending would leave alpha squared in the layer and apply it again on composite,
+	// so color is premultiplied and alpha accumulates as coverage, restored by End()
+	glGetIntegerv(GL_BLEND_SRC_RGB, &m_PreviousBlend[0]);
+	glGetIntegerv(GL_BLEND_DST_RGB, &m_PreviousBlend[1]);
+	glGetIntegerv(GL_BLEND_SRC_ALPHA, &m_PreviousBlend[2]);
+	glGetIntegerv(GL_BLEND_DST_ALPHA, &m_PreviousBlend[3]);
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void Layer::End()
+{
+	glBlendFuncSeparate(m_PreviousBlend[0], m_PreviousBlend[1], m_PreviousBlend[2], m_PreviousBlend[3]);
+	glViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_PreviousFBO);
+
+	m_Dirty = false;
+	m_Redrawn = true;
+}
+
+bool Layer::ConsumeRedraw()
+{
+	bool redrawn = m_Redrawn;
+	m_Redrawn = false;
+	return redrawn;
+}
+
+TextureAtlas* Layer::GetAtlas()
+{
+	return &m_Atlas;
+}
+
+int Layer::GetWidth()
+{
+	return m_Atlas.GetTextureWidth();
+}
+
+int Layer::GetHeight()
+{
+	return m_Atlas.GetTextureHeight();
+}
+
+void Layer::Clean()
+{
+	glDeleteFramebuffers(1, &m_FBO);
+	m_Atlas.GetTexture().Clean();
+}
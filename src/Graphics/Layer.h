@@ -0,0 +1,55 @@
+#ifndef LAYER_H
+#define LAYER_H
+
+#include "TextureAtlas.h"
+
+// Offscreen layer keeping rarely changing content drawn, like a background of thousands of shapes and labels
+// Graphics calls between Graphics::BeginLayer() and Graphics::EndLayer() draw into the layer's texture,
+// and Graphics::Draw() composites it as a single quad until the layer is marked dirty or resized
+// The texture holds premultiplied color, so semi-transparent content composites the same as drawing it on the screen directly
+class Layer
+{
+public:
+	Layer() = default;
+	// width and height in pixels, usually the screen size so the layer lines up with the screen's projection
+	// claims a texture unit for the layer's texture, like any TextureAtlas
+	Layer(int width, int height);
+
+	// resize the layer texture, the layer is dirty afterwards
+	void Resize(int width, int height);
+	// have the next Graphics::BeginLayer() draw the layer again
+	void MarkDirty();
+	bool IsDirty();
+
+	// color the layer is cleared to before drawing, transparent by default
+	void SetClearColor(float red, float green, float blue, float alpha = 0.f);
+
+	// bind and clear the layer framebuffer and set premultiplying blend functions, called by Graphics::BeginLayer()
+	void Begin();
+	// bind the previous framebuffer, viewport and blend functions again, the layer is clean afterwards
+	void End();
+
+	// returns true once after every redraw, so a damage tracked composite knows the layer's pixels changed
+	bool ConsumeRedraw();
+
+	TextureAtlas* GetAtlas();
+	int GetWidth();
+	int GetHeight();
+
+	// delete the layer texture and framebuffer
+	void Clean();
+
+private:
+	// opengl specific members
+	TextureAtlas m_Atlas;
+	unsigned int m_FBO = 0;
+	int m_PreviousFBO = 0;
+	int m_PreviousViewport[4] = {};
+	int m_PreviousBlend[4] = {};
+
+	float m_ClearColor[4] = {};
+	bool m_Dirty = true;
+	bool m_Redrawn = false;
+};
+
+#endif
@@ -0,0 +1,246 @@
+#include "OffscreenTarget.h"
+
+#include <cstring>
+#include <iostream>
+
+OffscreenTarget::OffscreenTarget(int width, int height, unsigned int readbackDepth)
+	: m_Readbacks(readbackDepth > 0 ? readbackDepth : 1)
+{
+	glGenFramebuffers(1, &m_FBO);
+	glGenRenderbuffers(1, &m_ColorBuffer);
+
+	for (Readback& readback : m_Readbacks)
+		glGenBuffers(1, &readback.PBO);
+
+	Resize(width, height);
+
+	m_EncodeThread = std::thread(&OffscreenTarget::EncodeLoop, this);
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+	StopEncodeThread();
+}
+
+void OffscreenTarget::Resize(int width, int height)
+{
+	// readbacks in flight have the old size
+	Finish();
+
+	m_Width = width;
+	m_Height = height;
+
+	glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	// attach the color buffer, keeping whatever framebuffer was bound
+	int previousFBO = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "Error: Offscreen framebuffer incomplete!" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFBO);
+
+	// pixel buffers are only read by the CPU
+	for (Readback& readback : m_Readbacks)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.PBO);
+		glBufferData(GL_PIXEL_PACK_BUFFER, (size_t)m_Width * m_Height * 4, NULL, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void OffscreenTarget::SetEncodeHook(OffscreenEncodeHook hook)
+{
+	// the encode thread calls the hook without holding the lock, so it has to be idle
+	Finish();
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_EncodeHook = hook;
+}
+
+void OffscreenTarget::Bind()
+{
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_PreviousFBO);
+	glGetIntegerv(GL_VIEWPORT, m_PreviousViewport);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+	glViewport(0, 0, m_Width, m_Height);
+}
+
+void OffscreenTarget::Unbind()
+{
+	glViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_PreviousFBO);
+}
+
+void OffscreenTarget::Capture()
+{
+	Poll();
+
+	// the ring is full, the oldest readback has to land before its buffer is reused
+	Readback& readback = m_Readbacks[m_Next];
+	if (readback.Fence)
+		Resolve(readback, true);
+
+	// the read lands in the pixel buffer, glReadPixels() returns without waiting for the frame to finish
+	int previousReadFBO = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFBO);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_FBO);
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.PBO);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFBO);
+
+	readback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	readback.Index = m_CaptureCount++;
+
+	m_Next = (m_Next + 1) % m_Readbacks.size();
+	m_InFlight++;
+}
+
+void OffscreenTarget::Poll()
+{
+	// oldest first, so frames reach the hook in capture order
+	while (m_InFlight > 0)
+	{
+		size_t oldest = (m_Next + m_Readbacks.size() - m_InFlight) % m_Readbacks.size();
+		if (!Resolve(m_Readbacks[oldest], false))
+			break;
+	}
+}
+
+void OffscreenTarget::Finish()
+{
+	while (m_InFlight > 0)
+	{
+		size_t oldest = (m_Next + m_Readbacks.size() - m_InFlight) % m_Readbacks.size();
+		Resolve(m_Readbacks[oldest], true);
+	}
+
+	// wait for the encode thread to run out of frames
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Condition.wait(lock, [this]() { return m_Queued.empty() && m_Encoding == 0; });
+}
+
+void OffscreenTarget::Clean()
+{
+	Finish();
+	StopEncodeThread();
+
+	for (Readback& readback : m_Readbacks)
+		glDeleteBuffers(1, &readback.PBO);
+	glDeleteFramebuffers(1, &m_FBO);
+	glDeleteRenderbuffers(1, &m_ColorBuffer);
+}
+
+int OffscreenTarget::GetWidth()
+{
+	return m_Width;
+}
+
+int OffscreenTarget::GetHeight()
+{
+	return m_Height;
+}
+
+bool OffscreenTarget::Resolve(Readback& readback, bool wait)
+{
+	// flushing makes sure the fence is eventually signaled, even with nothing else submitted
+	GLenum status = glClientWaitSync(readback.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	while (wait && status == GL_TIMEOUT_EXPIRED)
+		status = glClientWaitSync(readback.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+
+	if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		return false;
+
+	glDeleteSync(readback.Fence);
+	readback.Fence = 0;
+	m_InFlight--;
+
+	// the copy frees the pixel buffer for the next capture right away
+	std::unique_ptr<OffscreenFrame> frame = AcquireFrame();
+	frame->Width = m_Width;
+	frame->Height = m_Height;
+	frame->Index = readback.Index;
+	frame->Pixels.resize((size_t)m_Width * m_Height * 4);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.PBO);
+	const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frame->Pixels.size(), GL_MAP_READ_BIT);
+	if (pixels)
+	{
+		memcpy(frame->Pixels.data(), pixels, frame->Pixels.size());
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	else
+		std::cout << "Error: Failed to map offscreen readback buffer!" << std::endl;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Queued.push_back(std::move(frame));
+	}
+	m_Condition.notify_all();
+	return true;
+}
+
+std::unique_ptr<OffscreenFrame> OffscreenTarget::AcquireFrame()
+{
+	// frames are bounded so a slow encoder applies back pressure instead of growing memory
+	const unsigned int maxFrames = (unsigned int)m_Readbacks.size() + 2;
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	if (m_FreeFrames.empty() && m_FrameCount < maxFrames)
+	{
+		m_FrameCount++;
+		return std::unique_ptr<OffscreenFrame>(new OffscreenFrame());
+	}
+
+	m_Condition.wait(lock, [this]() { return !m_FreeFrames.empty(); });
+	std::unique_ptr<OffscreenFrame> frame = std::move(m_FreeFrames.back());
+	m_FreeFrames.pop_back();
+	return frame;
+}
+
+void OffscreenTarget::EncodeLoop()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true)
+	{
+		m_Condition.wait(lock, [this]() { return m_Stopping || !m_Queued.empty(); });
+		if (m_Queued.empty())
+			return;
+
+		std::unique_ptr<OffscreenFrame> frame = std::move(m_Queued.front());
+		m_Queued.pop_front();
+		m_Encoding++;
+
+		// the hook runs unlocked, so captures keep being queued while it encodes
+		lock.unlock();
+		if (m_EncodeHook)
+			m_EncodeHook(*frame);
+		lock.lock();
+
+		m_Encoding--;
+		m_FreeFrames.push_back(std::move(frame));
+		m_Condition.notify_all();
+	}
+}
+
+void OffscreenTarget::StopEncodeThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_Condition.notify_all();
+
+	if (m_EncodeThread.joinable())
+		m_EncodeThread.join();
+}
@@ -0,0 +1,110 @@
+#ifndef OFFSCREEN_TARGET_H
+#define OFFSCREEN_TARGET_H
+
+#include "Shader.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pixels of a captured frame, RGBA8 rows from the bottom up like glReadPixels()
+struct OffscreenFrame
+{
+	std::vector<unsigned char> Pixels;
+	int Width = 0;
+	int Height = 0;
+	unsigned long long Index = 0;	// Capture() count when the frame was captured, starting at 0
+};
+
+// Called on the encode thread for every captured frame, the frame is reused once it returns
+typedef std::function<void(const OffscreenFrame& frame)> OffscreenEncodeHook;
+
+// Framebuffer to render into without a window, with asynchronous readback of its pixels
+// Capture() only queues a glReadPixels() into one of a ring of pixel buffers and fences it,
+// the pixels are copied out once the GPU got to them, so frame N is read back while frame N + 1 renders
+// Copied frames are handed to the encode hook on a worker thread, so encoding never stalls rendering either
+class OffscreenTarget
+{
+public:
+	OffscreenTarget() = default;
+	// width and height of the target in pixels
+	// readbackDepth is the number of captures in flight before Capture() has to wait for the oldest, 2 or 3 is usually enough
+	OffscreenTarget(int width, int height, unsigned int readbackDepth = 3);
+	// stops the encode thread once it encoded the queued frames, see Clean() to delete the target
+	~OffscreenTarget();
+
+	// resize the target, captures in flight are finished first
+	void Resize(int width, int height);
+
+	// set the function receiving captured frames, called on the encode thread
+	// * captures in flight are finished with the previous hook first
+	void SetEncodeHook(OffscreenEncodeHook hook);
+
+	// bind the target and set the viewport to it, remembering the previous framebuffer and viewport
+	void Bind();
+	// bind the previous framebuffer and viewport again
+	void Unbind();
+
+	// queue a readback of the target's current pixels
+	// * waits only when every readback buffer is still in flight
+	void Capture();
+	// hand every finished readback to the encode thread, never waits on the GPU
+	// * call once per frame, Capture() also calls it
+	void Poll();
+	// wait until every capture is read back and encoded
+	void Finish();
+
+	// finish all captures, stop the encode thread and delete the target
+	void Clean();
+
+	int GetWidth();
+	int GetHeight();
+
+private:
+	// a pixel buffer of the readback ring
+	struct Readback
+	{
+		unsigned int PBO = 0;
+		GLsync Fence = 0;
+		unsigned long long Index = 0;
+	};
+
+	// private helper functions
+	// copy a fenced readback into a frame and queue it for encoding, wait says whether to block on the fence
+	bool Resolve(Readback& readback, bool wait);
+	// free frame to copy pixels into, waits when the encode thread is too far behind
+	std::unique_ptr<OffscreenFrame> AcquireFrame();
+	void EncodeLoop();
+	void StopEncodeThread();
+
+private:
+	// opengl specific members
+	unsigned int m_FBO = 0, m_ColorBuffer = 0;
+	int m_PreviousFBO = 0;
+	int m_PreviousViewport[4] = {};
+
+	int m_Width = 0, m_Height = 0;
+
+	// readback ring, captures go to m_Next and are resolved oldest first
+	std::vector<Readback> m_Readbacks;
+	unsigned int m_Next = 0;
+	unsigned int m_InFlight = 0;
+	unsigned long long m_CaptureCount = 0;
+
+	// encode thread, frames move from m_Queued to the hook and back to m_FreeFrames
+	OffscreenEncodeHook m_EncodeHook;
+	std::thread m_EncodeThread;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::deque<std::unique_ptr<OffscreenFrame>> m_Queued;
+	std::vector<std::unique_ptr<OffscreenFrame>> m_FreeFrames;
+	unsigned int m_FrameCount = 0;
+	unsigned int m_Encoding = 0;
+	bool m_Stopping = false;
+};
+
+#endif
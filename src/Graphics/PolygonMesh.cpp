@@ -0,0 +1,557 @@
+#include "PolygonMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+namespace {
+
+	// Vertex of the circular linked list the ear clipper works on
+	struct EarNode
+	{
+		unsigned int Index;		// index of the vertex in the source array
+		float X, Y;
+		EarNode* Prev = nullptr;
+		EarNode* Next = nullptr;
+		bool Steiner = false;	// single vertex hole, must never be filtered out
+	};
+
+	// Owns every node of a triangulation, deque keeps node pointers stable while growing
+	struct EarPool
+	{
+		std::deque<EarNode> Nodes;
+
+		EarNode* Create(unsigned int index, float x, float y)
+		{
+			Nodes.push_back({ index, x, y });
+			return &Nodes.back();
+		}
+	};
+
+	// twice the signed area of the triangle (p, q, r), negative for a convex corner of a clockwise ring
+	float Area(const EarNode* p, const EarNode* q, const EarNode* r)
+	{
+		return (q->Y - p->Y) * (r->X - q->X) - (q->X - p->X) * (r->Y - q->Y);
+	}
+
+	bool Equals(const EarNode* a, const EarNode* b)
+	{
+		return a->X == b->X && a->Y == b->Y;
+	}
+
+	int Sign(float value)
+	{
+		return value > 0.f ? 1 : value < 0.f ? -1 : 0;
+	}
+
+	bool PointInTriangle(float ax, float ay, float bx, float by, float cx, float cy, float px, float py)
+	{
+		return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+			(ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+			(bx - px) * (cy - py) >= (cx - px) * (by - py);
+	}
+
+	// q lies on the bounding box of the collinear segment (p, r)
+	bool OnSegment(const EarNode* p, const EarNode* q, const EarNode* r)
+	{
+		return q->X <= std::max(p->X, r->X) && q->X >= std::min(p->X, r->X) &&
+			q->Y <= std::max(p->Y, r->Y) && q->Y >= std::min(p->Y, r->Y);
+	}
+
+	bool Intersects(const EarNode* p1, const EarNode* q1, const EarNode* p2, const EarNode* q2)
+	{
+		int o1 = Sign(Area(p1, q1, p2));
+		int o2 = Sign(Area(p1, q1, q2));
+		int o3 = Sign(Area(p2, q2, p1));
+		int o4 = Sign(Area(p2, q2, q1));
+
+		if (o1 != o2 && o3 != o4)
+			return true;
+
+		// collinear special cases
+		if (o1 == 0 && OnSegment(p1, p2, q1)) return true;
+		if (o2 == 0 && OnSegment(p1, q2, q1)) return true;
+		if (o3 == 0 && OnSegment(p2, p1, q2)) return true;
+		if (o4 == 0 && OnSegment(p2, q1, q2)) return true;
+
+		return false;
+	}
+
+	EarNode* InsertNode(EarPool& pool, unsigned int index, float x, float y, EarNode* last)
+	{
+		EarNode* p = pool.Create(index, x, y);
+
+		if (!last)
+		{
+			p->Prev = p;
+			p->Next = p;
+		}
+		else
+		{
+			p->Next = last->Next;
+			p->Prev = last;
+			last->Next->Prev = p;
+			last->Next = p;
+		}
+
+		return p;
+	}
+
+	void RemoveNode(EarNode* p)
+	{
+		p->Next->Prev = p->Prev;
+		p->Prev->Next = p->Next;
+	}
+
+	// create a ring from vertices [start, end) in the requested winding
+	EarNode* LinkedList(EarPool& pool, const float* vertices, unsigned int start, unsigned int end, bool clockwise)
+	{
+		// signed area of the ring, positive when clockwise in y-up space
+		float sum = 0.f;
+		for (unsigned int i = start, j = end - 1; i < end; j = i++)
+		{
+			sum += (vertices[j * 2] - vertices[i * 2]) * (vertices[i * 2 + 1] + vertices[j * 2 + 1]);
+		}
+
+		EarNode* last = nullptr;
+		if (clockwise == (sum > 0.f))
+		{
+			for (unsigned int i = start; i < end; i++)
+				last = InsertNode(pool, i, vertices[i * 2], vertices[i * 2 + 1], last);
+		}
+		else
+		{
+			for (unsigned int i = end; i-- > start;)
+				last = InsertNode(pool, i, vertices[i * 2], vertices[i * 2 + 1], last);
+		}
+
+		// drop a closing vertex that repeats the first one
+		if (last && Equals(last, last->Next))
+		{
+			RemoveNode(last);
+			last = last->Next;
+		}
+
+		return last;
+	}
+
+	// remove duplicate and collinear vertices
+	EarNode* FilterPoints(EarNode* start, EarNode* end = nullptr)
+	{
+		if (!start)
+			return start;
+		if (!end)
+			end = start;
+
+		EarNode* p = start;
+		bool again;
+		do
+		{
+			again = false;
+
+			if (!p->Steiner && (Equals(p, p->Next) || Area(p->Prev, p, p->Next) == 0.f))
+			{
+				RemoveNode(p);
+				p = end = p->Prev;
+				if (p == p->Next)
+					break;
+				again = true;
+			}
+			else
+				p = p->Next;
+		} while (again || p != end);
+
+		return end;
+	}
+
+	bool IsEar(const EarNode* ear)
+	{
+		const EarNode* a = ear->Prev;
+		const EarNode* b = ear;
+		const EarNode* c = ear->Next;
+
+		// reflex corners can't be ears
+		if (Area(a, b, c) >= 0.f)
+			return false;
+
+		// no other reflex vertex may sit inside the ear
+		const EarNode* p = ear->Next->Next;
+		while (p != ear->Prev)
+		{
+			if (PointInTriangle(a->X, a->Y, b->X, b->Y, c->X, c->Y, p->X, p->Y) && Area(p->Prev, p, p->Next) >= 0.f)
+				return false;
+			p = p->Next;
+		}
+
+		return true;
+	}
+
+	bool LocallyInside(const EarNode* a, const EarNode* b)
+	{
+		return Area(a->Prev, a, a->Next) < 0.f ?
+			Area(a, b, a->Next) >= 0.f && Area(a, a->Prev, b) >= 0.f :
+			Area(a, b, a->Prev) < 0.f || Area(a, a->Next, b) < 0.f;
+	}
+
+	// the middle of the diagonal (a, b) is inside the polygon
+	bool MiddleInside(const EarNode* a, const EarNode* b)
+	{
+		const EarNode* p = a;
+		bool inside = false;
+		float px = (a->X + b->X) / 2.f;
+		float py = (a->Y + b->Y) / 2.f;
+		do
+		{
+			if (((p->Y > py) != (p->Next->Y > py)) && p->Next->Y != p->Y &&
+				(px < (p->Next->X - p->X) * (py - p->Y) / (p->Next->Y - p->Y) + p->X))
+				inside = !inside;
+			p = p->Next;
+		} while (p != a);
+
+		return inside;
+	}
+
+	bool IntersectsPolygon(const EarNode* a, const EarNode* b)
+	{
+		const EarNode* p = a;
+		do
+		{
+			if (p->Index != a->Index && p->Next->Index != a->Index && p->Index != b->Index && p->Next->Index != b->Index &&
+				Intersects(p, p->Next, a, b))
+				return true;
+			p = p->Next;
+		} while (p != a);
+
+		return false;
+	}
+
+	bool IsValidDiagonal(const EarNode* a, const EarNode* b)
+	{
+		return a->Next->Index != b->Index && a->Prev->Index != b->Index && !IntersectsPolygon(a, b) &&
+			((LocallyInside(a, b) && LocallyInside(b, a) && MiddleInside(a, b) &&
+				(Area(a->Prev, a, b->Prev) != 0.f || Area(a, b->Prev, b) != 0.f)) ||
+			(Equals(a, b) && Area(a->Prev, a, a->Next) > 0.f && Area(b->Prev, b, b->Next) > 0.f));
+	}
+
+	// link a and b with a bridge, splitting the ring in two
+	// returns the duplicate of b that starts the second ring
+	EarNode* SplitPolygon(EarPool& pool, EarNode* a, EarNode* b)
+	{
+		EarNode* a2 = pool.Create(a->Index, a->X, a->Y);
+		EarNode* b2 = pool.Create(b->Index, b->X, b->Y);
+		EarNode* an = a->Next;
+		EarNode* bp = b->Prev;
+
+		a->Next = b;
+		b->Prev = a;
+
+		a2->Next = an;
+		an->Prev = a2;
+
+		b2->Next = a2;
+		a2->Prev = b2;
+
+		bp->Next = b2;
+		b2->Prev = bp;
+
+		return b2;
+	}
+
+	void EarcutLinked(EarPool& pool, EarNode* ear, std::vector<unsigned int>& triangles, int pass);
+
+	// clip pairs of vertices whose edges cross each other
+	EarNode* CureLocalIntersections(EarNode* start, std::vector<unsigned int>& triangles)
+	{
+		EarNode* p = start;
+		do
+		{
+			EarNode* a = p->Prev;
+			EarNode* b = p->Next->Next;
+
+			if (!Equals(a, b) && Intersects(a, p, p->Next, b) && LocallyInside(a, b) && LocallyInside(b, a))
+			{
+				triangles.push_back(a->Index);
+				triangles.push_back(p->Index);
+				triangles.push_back(b->Index);
+
+				RemoveNode(p);
+				RemoveNode(p->Next);
+
+				p = start = b;
+			}
+			p = p->Next;
+		} while (p != start);
+
+		return FilterPoints(p);
+	}
+
+	// last resort, split the polygon along a valid diagonal and clip both halves
+	void SplitEarcut(EarPool& pool, EarNode* start, std::vector<unsigned int>& triangles)
+	{
+		EarNode* a = start;
+		do
+		{
+			EarNode* b = a->Next->Next;
+			while (b != a->Prev)
+			{
+				if (a->Index != b->Index && IsValidDiagonal(a, b))
+				{
+					EarNode* c = SplitPolygon(pool, a, b);
+
+					a = FilterPoints(a, a->Next);
+					c = FilterPoints(c, c->Next);
+
+					EarcutLinked(pool, a, triangles, 0);
+					EarcutLinked(pool, c, triangles, 0);
+					return;
+				}
+				b = b->Next;
+			}
+			a = a->Next;
+		} while (a != start);
+	}
+
+	void EarcutLinked(EarPool& pool, EarNode* ear, std::vector<unsigned int>& triangles, int pass)
+	{
+		if (!ear)
+			return;
+
+		EarNode* stop = ear;
+
+		// clip ears until only a single triangle's worth of vertices is left
+		while (ear->Prev != ear->Next)
+		{
+			EarNode* prev = ear->Prev;
+			EarNode* next = ear->Next;
+
+			if (IsEar(ear))
+			{
+				triangles.push_back(prev->Index);
+				triangles.push_back(ear->Index);
+				triangles.push_back(next->Index);
+
+				RemoveNode(ear);
+
+				// skipping the next vertex leads to less sliver triangles
+				ear = next->Next;
+				stop = next->Next;
+				continue;
+			}
+
+			ear = next;
+
+			// a whole loop without finding an ear, try to recover
+			if (ear == stop)
+			{
+				if (pass == 0)
+					EarcutLinked(pool, FilterPoints(ear), triangles, 1);
+				else if (pass == 1)
+					EarcutLinked(pool, CureLocalIntersections(FilterPoints(ear), triangles), triangles, 2);
+				else
+					SplitEarcut(pool, ear, triangles);
+				break;
+			}
+		}
+	}
+
+	EarNode* GetLeftmost(EarNode* start)
+	{
+		EarNode* p = start;
+		EarNode* leftmost = start;
+		do
+		{
+			if (p->X < leftmost->X || (p->X == leftmost->X && p->Y < leftmost->Y))
+				leftmost = p;
+			p = p->Next;
+		} while (p != start);
+
+		return leftmost;
+	}
+
+	bool SectorContainsSector(const EarNode* m, const EarNode* p)
+	{
+		return Area(m->Prev, m, p->Prev) < 0.f && Area(p->Next, m, m->Next) < 0.f;
+	}
+
+	// find an outer vertex that can be connected to the leftmost hole vertex without crossing any edge
+	EarNode* FindHoleBridge(EarNode* hole, EarNode* outerNode)
+	{
+		EarNode* p = outerNode;
+		EarNode* m = nullptr;
+		float hx = hole->X;
+		float hy = hole->Y;
+		float qx = -std::numeric_limits<float>::infinity();
+
+		// cast a ray left from the hole vertex and find the closest outer edge it hits
+		do
+		{
+			if (hy <= p->Y && hy >= p->Next->Y && p->Next->Y != p->Y)
+			{
+				float x = p->X + (hy - p->Y) * (p->Next->X - p->X) / (p->Next->Y - p->Y);
+				if (x <= hx && x > qx)
+				{
+					qx = x;
+					m = p->X < p->Next->X ? p : p->Next;
+					if (x == hx)
+						return m;
+				}
+			}
+			p = p->Next;
+		} while (p != outerNode);
+
+		if (!m)
+			return nullptr;
+
+		// a reflex vertex inside the triangle (hole, hit point, m) would block the bridge
+		// pick the one with the smallest angle to the ray instead
+		EarNode* stop = m;
+		float mx = m->X;
+		float my = m->Y;
+		float tanMin = std::numeric_limits<float>::infinity();
+
+		p = m;
+		do
+		{
+			if (hx >= p->X && p->X >= mx && hx != p->X &&
+				PointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->X, p->Y))
+			{
+				float tan = std::abs(hy - p->Y) / (hx - p->X);
+
+				if (LocallyInside(p, hole) &&
+					(tan < tanMin || (tan == tanMin && (p->X > m->X || (p->X == m->X && SectorContainsSector(m, p))))))
+				{
+					m = p;
+					tanMin = tan;
+				}
+			}
+			p = p->Next;
+		} while (p != stop);
+
+		return m;
+	}
+
+	// join every hole into the outer ring through bridge edges
+	EarNode* EliminateHoles(EarPool& pool, const float* vertices, unsigned int vertexCount, const unsigned int* holeStarts, unsigned int holeCount, EarNode* outerNode)
+	{
+		std::vector<EarNode*> queue;
+		queue.reserve(holeCount);
+
+		for (unsigned int i = 0; i < holeCount; i++)
+		{
+			unsigned int start = holeStarts[i];
+			unsigned int end = i < holeCount - 1 ? holeStarts[i + 1] : vertexCount;
+			EarNode* list = LinkedList(pool, vertices, start, end, false);
+			if (!list)
+				continue;
+			if (list == list->Next)
+				list->Steiner = true;
+			queue.push_back(GetLeftmost(list));
+		}
+
+		// bridge holes from left to right
+		std::sort(queue.begin(), queue.end(), [](const EarNode* a, const EarNode* b) { return a->X < b->X; });
+
+		for (EarNode* hole : queue)
+		{
+			EarNode* bridge = FindHoleBridge(hole, outerNode);
+			if (!bridge)
+				continue;
+
+			EarNode* bridgeReverse = SplitPolygon(pool, bridge, hole);
+			FilterPoints(bridgeReverse, bridgeReverse->Next);
+			outerNode = FilterPoints(bridge, bridge->Next);
+		}
+
+		return outerNode;
+	}
+
+}	// anonymous namespace
+
+PolygonMesh::PolygonMesh(float* vertices, unsigned int vertexCount, unsigned int* holeStarts, unsigned int holeCount)
+{
+	std::vector<unsigned int> indices = Triangulate(vertices, vertexCount, holeStarts, holeCount);
+	m_FillCount = (unsigned int)indices.size();
+
+	// append the outline of every ring as line pairs
+	unsigned int ringCount = holeStarts ? holeCount + 1 : 1;
+	indices.reserve(indices.size() + vertexCount * 2);
+	for (unsigned int ring = 0; ring < ringCount; ring++)
+	{
+		unsigned int start = ring == 0 ? 0 : holeStarts[ring - 1];
+		unsigned int end = ring < ringCount - 1 ? holeStarts[ring] : vertexCount;
+
+		for (unsigned int i = start; i < end; i++)
+		{
+			indices.push_back(i);
+			indices.push_back(i + 1 < end ? i + 1 : start);
+		}
+	}
+	m_LineCount = (unsigned int)indices.size() - m_FillCount;
+
+	// generate vao and buffers
+	glGenVertexArrays(1, &m_VAO);
+	glGenBuffers(1, &m_VBO);
+	glGenBuffers(1, &m_EBO);
+
+	glBindVertexArray(m_VAO);
+
+	// bind and fill vertex buffer
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * vertexCount * 2, vertices, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 2, (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// bind and fill index buffer
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GL_UNSIGNED_INT) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+}
+
+void PolygonMesh::Bind()
+{
+	glBindVertexArray(m_VAO);
+}
+
+void PolygonMesh::Clean() const
+{
+	glDeleteVertexArrays(1, &m_VAO);
+	glDeleteBuffers(1, &m_VBO);
+	glDeleteBuffers(1, &m_EBO);
+}
+
+unsigned int PolygonMesh::GetFillIndexCount()
+{
+	return m_FillCount;
+}
+
+unsigned int PolygonMesh::GetLineIndexCount()
+{
+	return m_LineCount;
+}
+
+std::vector<unsigned int> PolygonMesh::Triangulate(const float* vertices, unsigned int vertexCount, const unsigned int* holeStarts, unsigned int holeCount)
+{
+	std::vector<unsigned int> triangles;
+	if (vertexCount < 3)
+		return triangles;
+
+	bool hasHoles = holeStarts && holeCount > 0;
+	unsigned int outerCount = hasHoles ? holeStarts[0] : vertexCount;
+
+	// a polygon of n vertices and h holes always ends up with n + 2h - 2 triangles
+	triangles.reserve((vertexCount + 2 * holeCount) * 3);
+
+	EarPool pool;
+	EarNode* outerNode = LinkedList(pool, vertices, 0, outerCount, true);
+	if (!outerNode || outerNode->Next == outerNode->Prev)
+		return triangles;
+
+	if (hasHoles)
+		outerNode = EliminateHoles(pool, vertices, vertexCount, holeStarts, holeCount, outerNode);
+
+	EarcutLinked(pool, outerNode, triangles, 0);
+
+	return triangles;
+}
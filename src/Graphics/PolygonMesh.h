@@ -0,0 +1,45 @@
+#ifndef POLYGON_MESH_H
+#define POLYGON_MESH_H
+
+#include "Shader.h"
+
+#include <vector>
+
+// Polygon compiled once into a persistent GPU mesh
+// Holds both the triangulated fill and the outline, and is drawn through Graphics::Draw() with a per-draw transform and color
+class PolygonMesh
+{
+public:
+	PolygonMesh() = default;
+
+	// compile a polygon from its outer ring followed by any number of holes
+	// holeStarts holds the vertex index each hole starts at, pass nullptr for a polygon without holes
+	// * concave polygons and polygons with holes are supported
+	PolygonMesh(float* vertices, unsigned int vertexCount, unsigned int* holeStarts = nullptr, unsigned int holeCount = 0);
+
+	// bind the mesh vao
+	void Bind();
+	// delete the mesh buffers
+	void Clean() const;
+
+	// index count of the triangulated fill
+	unsigned int GetFillIndexCount();
+	// index count of the outline, stored after the fill indices as line pairs
+	unsigned int GetLineIndexCount();
+
+	// Triangulate a simple polygon with optional holes through ear clipping
+	// Vertex and hole layout match the constructor
+	// Returns the vertex indices of the calculated triangles (3 indices per triangle)
+	static std::vector<unsigned int> Triangulate(const float* vertices, unsigned int vertexCount, const unsigned int* holeStarts = nullptr, unsigned int holeCount = 0);
+
+private:
+	// opengl specific members
+	unsigned int m_VAO = 0;
+	unsigned int m_VBO = 0;
+	unsigned int m_EBO = 0;
+
+	unsigned int m_FillCount = 0;
+	unsigned int m_LineCount = 0;
+};
+
+#endif
@@ -9,9 +9,43 @@ const char* SHADER_SHAPE_VERT = "#version 330 core\nlayout(location = 0) in vec2
 
 const char* SHADER_SHAPE_FRAG = "#version 330 core\nout vec4 FragColor;\nin vec3 color;\nvoid main()\n{\nFragColor = vec4(color, 1.0);\n}";
 
+const char* SHADER_ANALYTIC_SHAPE_VERT = "#version 330 core\n\nlayout(location = 0) in vec2 v_Corner;\nlayout(location = 1) in vec2 v_Center;\nlayout(location = 2) in vec2 v_HalfSize;\nlayout(location = 3) in vec3 v_Params; // corner radius, outline thickness, rotation\nlayout(location = 4) in vec3 v_Color;\n\nout vec2 f_Local;\nflat out vec2 f_HalfSize;\nflat out float f_CornerRadius;\nflat out float f_Thickness;\nout vec3 f_Color;\n\nlayout (std140) uniform Matrices\n{\n\tmat4 VP;\n};\n\nvoid main()\n{\n\t// grow the quad past the shape edge to leave room for anti-aliasing\n\tvec2 local = v_Corner * (v_HalfSize + 2.0);\n\n\tfloat s = sin(v_Params.z);\n\tfloat c = cos(v_Params.z);\n\tvec2 world = v_Center + vec2(c * local.x - s * local.y, s * local.x + c * local.y);\n\n\tgl_Position = VP * vec4(world, 0, 1);\n\tf_Local = local;\n\tf_HalfSize = v_HalfSize;\n\tf_CornerRadius = v_Params.x;\n\tf_Thickness = v_Params.y;\n\tf_Color = v_Color;\n}";
+
+const char* SHADER_ANALYTIC_SHAPE_FRAG = "#version 330 core\n\nin vec2 f_Local;\nflat in vec2 f_HalfSize;\nflat in float f_CornerRadius;\nflat in float f_Thickness;\nin vec3 f_Color;\n\nout vec4 FragColor;\n\nvoid main()\n{\n\t// signed distance to a rounded box, circles and capsules are rounded boxes as well\n\tvec2 q = abs(f_Local) - f_HalfSize + f_CornerRadius;\n\tfloat dist = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - f_CornerRadius;\n\n\t// outlines keep only a band of the given thickness inside the edge\n\tif (f_Thickness > 0.0)\n\t\tdist = abs(dist + f_Thickness * 0.5) - f_Thickness * 0.5;\n\n\t// analytic anti-aliasing over one pixel\n\tfloat alpha = clamp(0.5 - dist / fwidth(dist), 0.0, 1.0);\n\tif (alpha <= 0.0)\n\t\tdiscard;\n\n\tFragColor = vec4(f_Color, alpha);\n}";
+
+const char* SHADER_POLYGON_MESH_VERT = "#version 330 core\n\nlayout(location = 0) in vec2 V_Position;\n\nlayout (std140) uniform Matrices\n{\n\tmat4 VP;\n};\n\nuniform vec4 u_Transform; // x, y, rotation, scale\n\nvoid main()\n{\n\tfloat s = sin(u_Transform.z);\n\tfloat c = cos(u_Transform.z);\n\tvec2 position = V_Position * u_Transform.w;\n\tposition = vec2(c * position.x - s * position.y, s * position.x + c * position.y) + u_Transform.xy;\n\n\tgl_Position = VP * vec4(position, 0, 1);\n}";
+
+const char* SHADER_POLYGON_MESH_FRAG = "#version 330 core\n\nout vec4 FragColor;\n\nuniform vec3 u_Color;\n\nvoid main()\n{\n\tFragColor = vec4(u_Color, 1.0);\n}";
+
+const char* SHADER_POINT_VERT = "#version 330 core\n\nlayout(location = 0) in vec2 V_Position;\nlayout(location = 1) in vec3 V_Color;\nlayout(location = 2) in float V_Size;\nlayout(location = 3) in float V_Shape;\n\nlayout (std140) uniform Matrices\n{\n\tmat4 VP;\n};\n\nout vec3 color;\nflat out int shape;\n\nvoid main()\n{\n\tgl_Position = VP * vec4(V_Position, 0, 1);\n\tgl_PointSize = V_Size;\n\tcolor = V_Color;\n\tshape = int(V_Shape);\n}";
+
+const char* SHADER_POINT_FRAG = "#version 330 core\n\nout vec4 FragColor;\n\nin vec3 color;\nflat in int shape;\n\nvoid main()\n{\n\t// round points drop every fragment outside the inscribed circle\n\tif (shape == 1)\n\t{\n\t\tvec2 coord = gl_PointCoord * 2.0 - 1.0;\n\t\tif (dot(coord, coord) > 1.0)\n\t\t\tdiscard;\n\t}\n\n\tFragColor = vec4(color, 1.0);\n}";
+
+const char* SHADER_DENSITY_ACCUMULATE_VERT = "#version 330 core\n\nlayout(location = 0) in vec2 V_Position;\n\nlayout (std140) uniform Matrices\n{\n\tmat4 VP;\n};\n\nvoid main()\n{\n\tgl_Position = VP * vec4(V_Position, 0, 1);\n\tgl_PointSize = 1.0;\n}";
+
+const char* SHADER_DENSITY_ACCUMULATE_FRAG = "#version 330 core\n\nout float Density;\n\nvoid main()\n{\n\t// additive blending sums every point landing on this pixel\n\tDensity = 1.0;\n}";
+
+const char* SHADER_DENSITY_COLOR_MAP_VERT = "#version 330 core\n\nout vec2 f_TextureCoord;\n\nvoid main()\n{\n\t// single triangle covering the whole screen, no vertex data needed\n\tvec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n\tf_TextureCoord = position;\n\tgl_Position = vec4(position * 2.0 - 1.0, 0, 1);\n}";
+
+const char* SHADER_DENSITY_COLOR_MAP_FRAG = "#version 330 core\n\nin vec2 f_TextureCoord;\n\nout vec4 FragColor;\n\nuniform sampler2D u_Density;\nuniform float u_MaxDensity;\n\nvoid main()\n{\n\tfloat density = texture(u_Density, f_TextureCoord).r;\n\tif (density <= 0.0)\n\t\tdiscard;\n\n\t// log scale so sparse outliers stay visible next to dense clusters\n\tfloat t = clamp(log(1.0 + density) / log(1.0 + u_MaxDensity), 0.0, 1.0);\n\n\t// dark blue, teal, green, yellow gradient\n\tvec3 low = mix(vec3(0.27, 0.00, 0.33), vec3(0.13, 0.57, 0.55), clamp(t * 2.0, 0.0, 1.0));\n\tvec3 high = mix(vec3(0.13, 0.57, 0.55), vec3(0.99, 0.91, 0.14), clamp(t * 2.0 - 1.0, 0.0, 1.0));\n\tFragColor = vec4(t < 0.5 ? low : high, 1.0);\n}";
+
+const char* SHADER_SDF_TEXT_VERT = "#version 330 core\n\nlayout (location = 0) in vec4 v_ScreenPosition;\nlayout (location = 1) in vec3 v_ColorOffset;\nlayout (location = 2) in float v_TextureIndex;\n\nout vec2 f_TextureCoord;\nout vec3 f_ColorOffset;\nout flat int f_TextureIndex;\n\nlayout (std140) uniform Matrices\n{\n\tmat4 vp;\n};\n\nvoid main()\n{\n\tgl_Position = vp * vec4(v_ScreenPosition.xy, 0, 1);\n\tf_TextureCoord = v_ScreenPosition.zw;\n\tf_TextureIndex = int(v_TextureIndex);\n\tf_ColorOffset = v_ColorOffset;\n}";
+
+const char* SHADER_SDF_TEXT_FRAG = "#version 330 core\n\nin vec2 f_TextureCoord;\nin vec3 f_ColorOffset;\nin flat int f_TextureIndex;\n\nout vec4 r_FragColor;\n\nuniform sampler2D u_Textures[16];\n\n// distance fields store 0.5 on the glyph edge, inside is above\nfloat SampleDistance(int index, vec2 coord)\n{\n\tif (index == 0)\n\t\treturn texture(u_Textures[0], coord).r;\n\telse if (index == 1)\n\t\treturn texture(u_Textures[1], coord).r;\n\telse if (index == 2)\n\t\treturn texture(u_Textures[2], coord).r;\n\telse if (index == 3)\n\t\treturn texture(u_Textures[3], coord).r;\n\telse if (index == 4)\n\t\treturn texture(u_Textures[4], coord).r;\n\telse if (index == 5)\n\t\treturn texture(u_Textures[5], coord).r;\n\telse if (index == 6)\n\t\treturn texture(u_Textures[6], coord).r;\n\telse if (index == 7)\n\t\treturn texture(u_Textures[7], coord).r;\n\telse if (index == 8)\n\t\treturn texture(u_Textures[8], coord).r;\n\telse if (index == 9)\n\t\treturn texture(u_Textures[9], coord).r;\n\telse if (index == 10)\n\t\treturn texture(u_Textures[10], coord).r;\n\telse if (index == 11)\n\t\treturn texture(u_Textures[11], coord).r;\n\telse if (index == 12)\n\t\treturn texture(u_Textures[12], coord).r;\n\telse if (index == 13)\n\t\treturn texture(u_Textures[13], coord).r;\n\telse if (index == 14)\n\t\treturn texture(u_Textures[14], coord).r;\n\telse if (index == 15)\n\t\treturn texture(u_Textures[15], coord).r;\n\telse\n\t\treturn 0.0;\n}\n\nvoid main()\n{\n\tfloat distance = SampleDistance(f_TextureIndex, f_TextureCoord);\n\n\t// smooth over one screen pixel, so edges stay crisp at any scale\n\tfloat width = fwidth(distance) * 0.5;\n\tfloat alpha = smoothstep(0.5 - width, 0.5 + width, distance);\n\n\tr_FragColor = vec4(f_ColorOffset, alpha);\n}";
+
+const char* SHADER_BULK_TEXT_VERT = "#version 330 core\n\n// one glyph per instance: pen offset, char | low run bits << 8, high run bits\nlayout(location = 0) in uvec3 v_Glyph;\n\nout vec2 f_TextureCoord;\nout vec3 f_Color;\n\nlayout (std140) uniform Matrices\n{\n\tmat4 VP;\n};\n\n// per char (u, v, bearing, unused), u and v are the top left of the char's atlas cell\nlayout (std140) uniform GlyphMetrics\n{\n\tvec4 u_Glyphs[256];\n};\n\nuniform samplerBuffer u_Runs;\t// 2 texels per run: (x, y, scale, rotation), (r, g, b, unused)\nuniform vec2 u_CellSize;\t\t// glyph cell in pixels\nuniform vec2 u_CellUV;\t\t\t// glyph cell in texture coordinates\n\nvoid main()\n{\n\tuint ch = v_Glyph.y & 0xFFu;\n\tint run = int((v_Glyph.z << 8) | (v_Glyph.y >> 8));\n\n\tvec4 origin = texelFetch(u_Runs, run * 2);\n\tvec4 metrics = u_Glyphs[ch];\n\n\t// quad corner from the vertex id, drawn as a 4 vertex strip\n\tvec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n\n\t// same layout as Print(), rotated around the left middle of the line\n\tvec2 position = (vec2(float(v_Glyph.x) + metrics.z, 0.0) + corner * u_CellSize) * origin.z;\n\tvec2 pivot = vec2(0.0, u_CellSize.y * 0.5 * origin.z);\n\tfloat s = sin(origin.w);\n\tfloat c = cos(origin.w);\n\tposition -= pivot;\n\tposition = vec2(c * position.x - s * position.y, s * position.x + c * position.y) + pivot;\n\n\tgl_Position = VP * vec4(origin.xy + position, 0, 1);\n\tf_TextureCoord = metrics.xy + corner * u_CellUV;\n\tf_Color = texelFetch(u_Runs, run * 2 + 1).rgb;\n}";
+
+const char* SHADER_BULK_TEXT_FRAG = "#version 330 core\n\nin vec2 f_TextureCoord;\nin vec3 f_Color;\n\nout vec4 r_FragColor;\n\nuniform sampler2D u_Font;\nuniform int u_DistanceField;\t// 1 when the font was loaded with LoadSDFFont()\n\nvoid main()\n{\n\tvec4 texel = texture(u_Font, f_TextureCoord);\n\n\tif (u_DistanceField != 0)\n\t{\t// same edge reconstruction as the SDF_TEXT shader\n\t\tfloat width = fwidth(texel.r) * 0.5;\n\t\tr_FragColor = vec4(f_Color, smoothstep(0.5 - width, 0.5 + width, texel.r));\n\t}\n\telse\n\t\tr_FragColor = texel * vec4(f_Color, 1.0);\n}";
+
 const char* SHADER_TEXTURE_RENDER_VERT = "#version 330 core\nlayout(location = 0) in vec4 v_ScreenPosition;\nlayout(location = 1) in vec3 v_ColorOffset;\nlayout(location = 2) in float v_TextureIndex;\nout vec2 f_TextureCoord;\nout vec3 f_ColorOffset;\nflat out int f_TextureIndex;\nlayout(std140) uniform Matrices\n{\n	mat4 vp;\n};\nvoid main()\n{\n	gl_Position = vp * vec4(v_ScreenPosition.xy, 0, 1);\n	f_TextureCoord = v_ScreenPosition.zw;\n	f_TextureIndex = int(v_TextureIndex);\n	f_ColorOffset = v_ColorOffset;\n}";
 
-const char* SHADER_TEXTURE_RENDER_FRAG = "#version 330 core\nin vec2 f_TextureCoord;\nin vec3 f_ColorOffset;\nflat in int f_TextureIndex;\nout vec4 r_FragColor;\nuniform sampler2D u_Textures[16];\nvoid main()\n{\n	int index = f_TextureIndex;\n	if (index == 0)\n		r_FragColor = texture(u_Textures[0], f_TextureCoord);\n	else if (index == 1)\n		r_FragColor = texture(u_Textures[1], f_TextureCoord);\n	else if (index == 2)\n		r_FragColor = texture(u_Textures[2], f_TextureCoord);\n	else if (index == 3)\n		r_FragColor = texture(u_Textures[3], f_TextureCoord);\n	else if (index == 4)\n		r_FragColor = texture(u_Textures[4], f_TextureCoord);\n	else if (index == 5)\n		r_FragColor = texture(u_Textures[5], f_TextureCoord);\n	else if (index == 6)\n		r_FragColor = texture(u_Textures[6], f_TextureCoord);\n	else if (index == 7)\n		r_FragColor = texture(u_Textures[7], f_TextureCoord);\n	else if (index == 8)\n		r_FragColor = texture(u_Textures[8], f_TextureCoord);\n	else if (index == 9)\n		r_FragColor = texture(u_Textures[9], f_TextureCoord);\n	else if (index == 10)\n		r_FragColor = texture(u_Textures[10], f_TextureCoord);\n	else if (index == 11)\n		r_FragColor = texture(u_Textures[11], f_TextureCoord);\n	else if (index == 12)\n		r_FragColor = texture(u_Textures[12], f_TextureCoord);\n	else if (index == 13)\n		r_FragColor = texture(u_Textures[13], f_TextureCoord);\n	else if (index == 14)\n		r_FragColor = texture(u_Textures[14], f_TextureCoord);\n	else if (index == 15)\n		r_FragColor = texture(u_Textures[15], f_TextureCoord);\n	else\n		r_FragColor = vec4(1, 0, 1, 1);\n	r_FragColor = r_FragColor * vec4(f_ColorOffset, 1);\n}";
+const char* SHADER_TEXTURE_RENDER_FRAG = "#version 330 core\nin vec2 f_TextureCoord;\nin vec3 f_ColorOffset;\nflat in int f_TextureIndex;\nout vec4 r_FragColor;\nuniform sampler2D u_Textures[16];\nvoid main()\n{\n	// indices past the 16 units sample premultiplied textures, like layers\n	int index = f_TextureIndex;\n	bool premultiplied = index >= 16;\n	if (premultiplied)\n		index -= 16;\n	if (index == 0)\n		r_FragColor = texture(u_Textures[0], f_TextureCoord);\n	else if (index == 1)\n		r_FragColor = texture(u_Textures[1], f_TextureCoord);\n	else if (index == 2)\n		r_FragColor = texture(u_Textures[2], f_TextureCoord);\n	else if (index == 3)\n		r_FragColor = texture(u_Textures[3], f_TextureCoord);\n	else if (index == 4)\n		r_FragColor = texture(u_Textures[4], f_TextureCoord);\n	else if (index == 5)\n		r_FragColor = texture(u_Textures[5], f_TextureCoord);\n	else if (index == 6)\n		r_FragColor = texture(u_Textures[6], f_TextureCoord);\n	else if (index == 7)\n		r_FragColor = texture(u_Textures[7], f_TextureCoord);\n	else if (index == 8)\n		r_FragColor = texture(u_Textures[8], f_TextureCoord);\n	else if (index == 9)\n		r_FragColor = texture(u_Textures[9], f_TextureCoord);\n	else if (index == 10)\n		r_FragColor = texture(u_Textures[10], f_TextureCoord);\n	else if (index == 11)\n		r_FragColor = texture(u_Textures[11], f_TextureCoord);\n	else if (index == 12)\n		r_FragColor = texture(u_Textures[12], f_TextureCoord);\n	else if (index == 13)\n		r_FragColor = texture(u_Textures[13], f_TextureCoord);\n	else if (index == 14)\n		r_FragColor = texture(u_Textures[14], f_TextureCoord);\n	else if (index == 15)\n		r_FragColor = texture(u_Textures[15], f_TextureCoord);\n	else\n		r_FragColor = vec4(1, 0, 1, 1);\n	// dividing the alpha back out lets the usual SRC_ALPHA, ONE_MINUS_SRC_ALPHA blend composite premultiplied color like ONE, ONE_MINUS_SRC_ALPHA\n	if (premultiplied && r_FragColor.a > 0.0)\n		r_FragColor.rgb /= r_FragColor.a;\n	r_FragColor = r_FragColor * vec4(f_ColorOffset, 1);\n}";
+
+const char* SHADER_SHAPE_MULTI_VIEW_VERT = "#version 330 core\n\nlayout(location = 0) in vec2 V_Position;\nlayout(location = 1) in vec3 V_Color;\n\nout vec3 color;\n\n// view-projection and viewport of every view, see Graphics::SetViews()\nlayout (std140) uniform Views\n{\n\tmat4 u_ViewVP[8];\n\tvec4 u_ViewRect[8];\t// clip space scale (xy) and offset (zw) of the viewport\n\tfloat u_ViewCount;\n};\n\n// instances are drawn once per view, the view's viewport is carved out of the framebuffer in clip space\nvec4 ViewPosition(vec2 world)\n{\n\tint view = gl_InstanceID % int(u_ViewCount);\n\tvec4 clip = u_ViewVP[view] * vec4(world, 0, 1);\n\n\t// clip to the view's own frustum, not the framebuffer's\n\tgl_ClipDistance[0] = clip.w + clip.x;\n\tgl_ClipDistance[1] = clip.w - clip.x;\n\tgl_ClipDistance[2] = clip.w + clip.y;\n\tgl_ClipDistance[3] = clip.w - clip.y;\n\n\tvec4 rect = u_ViewRect[view];\n\tclip.xy = clip.xy * rect.xy + rect.zw * clip.w;\n\treturn clip;\n}\n\nvoid main()\n{\n\tgl_Position = ViewPosition(V_Position);\n\tcolor = V_Color;\n}";
+
+const char* SHADER_ANALYTIC_SHAPE_MULTI_VIEW_VERT = "#version 330 core\n\nlayout(location = 0) in vec2 v_Corner;\nlayout(location = 1) in vec2 v_Center;\nlayout(location = 2) in vec2 v_HalfSize;\nlayout(location = 3) in vec3 v_Params; // corner radius, outline thickness, rotation\nlayout(location = 4) in vec3 v_Color;\n\nout vec2 f_Local;\nflat out vec2 f_HalfSize;\nflat out float f_CornerRadius;\nflat out float f_Thickness;\nout vec3 f_Color;\n\n// view-projection and viewport of every view, see Graphics::SetViews()\nlayout (std140) uniform Views\n{\n\tmat4 u_ViewVP[8];\n\tvec4 u_ViewRect[8];\t// clip space scale (xy) and offset (zw) of the viewport\n\tfloat u_ViewCount;\n};\n\n// instances are drawn once per view, the view's viewport is carved out of the framebuffer in clip space\nvec4 ViewPosition(vec2 world)\n{\n\tint view = gl_InstanceID % int(u_ViewCount);\n\tvec4 clip = u_ViewVP[view] * vec4(world, 0, 1);\n\n\t// clip to the view's own frustum, not the framebuffer's\n\tgl_ClipDistance[0] = clip.w + clip.x;\n\tgl_ClipDistance[1] = clip.w - clip.x;\n\tgl_ClipDistance[2] = clip.w + clip.y;\n\tgl_ClipDistance[3] = clip.w - clip.y;\n\n\tvec4 rect = u_ViewRect[view];\n\tclip.xy = clip.xy * rect.xy + rect.zw * clip.w;\n\treturn clip;\n}\n\nvoid main()\n{\n\t// grow the quad past the shape edge to leave room for anti-aliasing\n\tvec2 local = v_Corner * (v_HalfSize + 2.0);\n\n\tfloat s = sin(v_Params.z);\n\tfloat c = cos(v_Params.z);\n\tvec2 world = v_Center + vec2(c * local.x - s * local.y, s * local.x + c * local.y);\n\n\tgl_Position = ViewPosition(world);\n\tf_Local = local;\n\tf_HalfSize = v_HalfSize;\n\tf_CornerRadius = v_Params.x;\n\tf_Thickness = v_Params.y;\n\tf_Color = v_Color;\n}";
+
+const char* SHADER_TEXTURE_RENDER_MULTI_VIEW_VERT = "#version 330 core\n\nlayout(location = 0) in vec4 v_ScreenPosition;\nlayout(location = 1) in vec3 v_ColorOffset;\nlayout(location = 2) in float v_TextureIndex;\n\nout vec2 f_TextureCoord;\nout vec3 f_ColorOffset;\nflat out int f_TextureIndex;\n\n// view-projection and viewport of every view, see Graphics::SetViews()\nlayout (std140) uniform Views\n{\n\tmat4 u_ViewVP[8];\n\tvec4 u_ViewRect[8];\t// clip space scale (xy) and offset (zw) of the viewport\n\tfloat u_ViewCount;\n};\n\n// instances are drawn once per view, the view's viewport is carved out of the framebuffer in clip space\nvec4 ViewPosition(vec2 world)\n{\n\tint view = gl_InstanceID % int(u_ViewCount);\n\tvec4 clip = u_ViewVP[view] * vec4(world, 0, 1);\n\n\t// clip to the view's own frustum, not the framebuffer's\n\tgl_ClipDistance[0] = clip.w + clip.x;\n\tgl_ClipDistance[1] = clip.w - clip.x;\n\tgl_ClipDistance[2] = clip.w + clip.y;\n\tgl_ClipDistance[3] = clip.w - clip.y;\n\n\tvec4 rect = u_ViewRect[view];\n\tclip.xy = clip.xy * rect.xy + rect.zw * clip.w;\n\treturn clip;\n}\n\nvoid main()\n{\n\tgl_Position = ViewPosition(v_ScreenPosition.xy);\n\tf_TextureCoord = v_ScreenPosition.zw;\n\tf_TextureIndex = int(v_TextureIndex);\n\tf_ColorOffset = v_ColorOffset;\n}";
 
 
 
@@ -125,6 +159,73 @@ Shader::Shader(ShaderType premadeType)
 		fShaderCode = SHADER_TEXTURE_RENDER_FRAG;
 		break;
 	}
+	case ANALYTIC_SHAPE:
+	{
+		vShaderCode = SHADER_ANALYTIC_SHAPE_VERT;
+		fShaderCode = SHADER_ANALYTIC_SHAPE_FRAG;
+		break;
+	}
+	case POLYGON_MESH:
+	{
+		vShaderCode = SHADER_POLYGON_MESH_VERT;
+		fShaderCode = SHADER_POLYGON_MESH_FRAG;
+		break;
+	}
+	case POINT_SPRITE:
+	{
+		vShaderCode = SHADER_POINT_VERT;
+		fShaderCode = SHADER_POINT_FRAG;
+		break;
+	}
+	case DENSITY_ACCUMULATE:
+	{
+		vShaderCode = SHADER_DENSITY_ACCUMULATE_VERT;
+		fShaderCode = SHADER_DENSITY_ACCUMULATE_FRAG;
+		break;
+	}
+	case DENSITY_COLOR_MAP:
+	{
+		vShaderCode = SHADER_DENSITY_COLOR_MAP_VERT;
+		fShaderCode = SHADER_DENSITY_COLOR_MAP_FRAG;
+		break;
+	}
+	case SDF_TEXT:
+	{
+		vShaderCode = SHADER_SDF_TEXT_VERT;
+		fShaderCode = SHADER_SDF_TEXT_FRAG;
+		break;
+	}
+	case BULK_TEXT:
+	{
+		vShaderCode = SHADER_BULK_TEXT_VERT;
+		fShaderCode = SHADER_BULK_TEXT_FRAG;
+		break;
+	}
+	case SHAPE_MULTI_VIEW:
+	{
+		vShaderCode = SHADER_SHAPE_MULTI_VIEW_VERT;
+		fShaderCode = SHADER_SHAPE_FRAG;
+		break;
+	}
+	case ANALYTIC_SHAPE_MULTI_VIEW:
+	{
+		vShaderCode = SHADER_ANALYTIC_SHAPE_MULTI_VIEW_VERT;
+		fShaderCode = SHADER_ANALYTIC_SHAPE_FRAG;
+		break;
+	}
+	case TEXTURE_RENDERER_MULTI_VIEW:
+	{
+		vShaderCode = SHADER_TEXTURE_RENDER_MULTI_VIEW_VERT;
+		fShaderCode = SHADER_TEXTURE_RENDER_FRAG;
+		break;
+	}
+	case SDF_TEXT_MULTI_VIEW:
+	{
+		// glyph quads have the same vertices as images
+		vShaderCode = SHADER_TEXTURE_RENDER_MULTI_VIEW_VERT;
+		fShaderCode = SHADER_SDF_TEXT_FRAG;
+		break;
+	}
 	default:
 		break;
 	}
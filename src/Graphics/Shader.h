@@ -16,17 +16,63 @@
 enum ShaderType
 {
 	SHAPE,
-	TEXTURE_RENDERER
+	TEXTURE_RENDERER,
+	ANALYTIC_SHAPE,
+	POLYGON_MESH,
+	POINT_SPRITE,
+	DENSITY_ACCUMULATE,
+	DENSITY_COLOR_MAP,
+	SDF_TEXT,
+	BULK_TEXT,
+	// multi-view variants, drawing every instance into one of the views of Graphics::SetViews()
+	SHAPE_MULTI_VIEW,
+	ANALYTIC_SHAPE_MULTI_VIEW,
+	TEXTURE_RENDERER_MULTI_VIEW,
+	SDF_TEXT_MULTI_VIEW
 };
 
 extern const char* SHADER_SHAPE_VERT;
 
 extern const char* SHADER_SHAPE_FRAG;
 
+extern const char* SHADER_ANALYTIC_SHAPE_VERT;
+
+extern const char* SHADER_ANALYTIC_SHAPE_FRAG;
+
+extern const char* SHADER_POLYGON_MESH_VERT;
+
+extern const char* SHADER_POLYGON_MESH_FRAG;
+
+extern const char* SHADER_POINT_VERT;
+
+extern const char* SHADER_POINT_FRAG;
+
+extern const char* SHADER_DENSITY_ACCUMULATE_VERT;
+
+extern const char* SHADER_DENSITY_ACCUMULATE_FRAG;
+
+extern const char* SHADER_DENSITY_COLOR_MAP_VERT;
+
+extern const char* SHADER_DENSITY_COLOR_MAP_FRAG;
+
+extern const char* SHADER_SDF_TEXT_VERT;
+
+extern const char* SHADER_SDF_TEXT_FRAG;
+
+extern const char* SHADER_BULK_TEXT_VERT;
+
+extern const char* SHADER_BULK_TEXT_FRAG;
+
 extern const char* SHADER_TEXTURE_RENDER_VERT;
 
 extern const char* SHADER_TEXTURE_RENDER_FRAG;
 
+extern const char* SHADER_SHAPE_MULTI_VIEW_VERT;
+
+extern const char* SHADER_ANALYTIC_SHAPE_MULTI_VIEW_VERT;
+
+extern const char* SHADER_TEXTURE_RENDER_MULTI_VIEW_VERT;
+
 
 
 class UBO
@@ -0,0 +1,713 @@
+#include "SoftwareRenderer.h"
+#include "TextureRenderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#endif
+
+// pixels are RGBA8 in memory, so red is the lowest byte
+static inline uint32_t PackPixel(uint32_t red, uint32_t green, uint32_t blue, uint32_t alpha)
+{
+	return red | (green << 8) | (blue << 16) | (alpha << 24);
+}
+
+static inline uint32_t ToByte(float value)
+{
+	return (uint32_t)(std::min(std::max(value, 0.f), 1.f) * 255.f + 0.5f);
+}
+
+// src alpha blending, alpha uses the same factors like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+static inline uint32_t BlendPixel(uint32_t destination, uint32_t red, uint32_t green, uint32_t blue, uint32_t alpha)
+{
+	uint32_t inverse = 255 - alpha;
+	uint32_t result = 0;
+	const uint32_t source[4] = { red, green, blue, alpha };
+	for (int channel = 0; channel < 4; channel++)
+	{
+		uint32_t t = source[channel] * alpha + ((destination >> (channel * 8)) & 0xFF) * inverse + 128;
+		result |= ((t + (t >> 8)) >> 8) << (channel * 8);
+	}
+	return result;
+}
+
+// fill a span of pixels with an opaque color
+static void FillSpan(uint32_t* pixels, int count, uint32_t color)
+{
+	int i = 0;
+#ifdef SOFTWARE_RENDERER_SSE2
+	__m128i value = _mm_set1_epi32((int)color);
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_si128((__m128i*)(pixels + i), value);
+#endif
+	for (; i < count; i++)
+		pixels[i] = color;
+}
+
+// blend one color over a span of pixels, with a coverage byte per pixel as its alpha
+static void BlendSpan(uint32_t* pixels, const unsigned char* coverage, int count, uint32_t red, uint32_t green, uint32_t blue)
+{
+	int i = 0;
+#ifdef SOFTWARE_RENDERER_SSE2
+	// 2 pixels per register as 16 bit channels, the math is the same as BlendPixel()
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi16(255);
+	const __m128i half = _mm_set1_epi16(128);
+	for (; i + 4 <= count; i += 4)
+	{
+		const unsigned char* a = coverage + i;
+		if ((a[0] | a[1] | a[2] | a[3]) == 0)
+			continue;
+
+		__m128i destination = _mm_loadu_si128((const __m128i*)(pixels + i));
+		__m128i result[2];
+		for (int half2 = 0; half2 < 2; half2++)
+		{
+			short a0 = a[half2 * 2], a1 = a[half2 * 2 + 1];
+			__m128i alpha = _mm_set_epi16(a1, a1, a1, a1, a0, a0, a0, a0);
+			__m128i source = _mm_set_epi16(a1, (short)blue, (short)green, (short)red, a0, (short)blue, (short)green, (short)red);
+			__m128i target = half2 == 0 ? _mm_unpacklo_epi8(destination, zero) : _mm_unpackhi_epi8(destination, zero);
+
+			__m128i t = _mm_add_epi16(_mm_mullo_epi16(source, alpha), _mm_mullo_epi16(target, _mm_sub_epi16(full, alpha)));
+			t = _mm_add_epi16(t, half);
+			result[half2] = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+		}
+		_mm_storeu_si128((__m128i*)(pixels + i), _mm_packus_epi16(result[0], result[1]));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		if (coverage[i] > 0)
+			pixels[i] = BlendPixel(pixels[i], red, green, blue, coverage[i]);
+	}
+}
+
+// span of pixel centers on a row inside a convex polygon with counter clockwise corners, limited to [minX, maxX)
+// edges follow a half open rule, so polygons sharing an edge never both cover a pixel
+static bool PolygonSpan(const float* x, const float* y, int cornerCount, float rowY, int minX, int maxX, int& spanBegin, int& spanEnd)
+{
+	float low = (float)minX, high = (float)maxX;
+	for (int i = 0; i < cornerCount; i++)
+	{
+		int j = (i + 1) % cornerCount;
+		float edgeX = x[j] - x[i];
+		float edgeY = y[j] - y[i];
+
+		// inside is edgeX * (rowY - y[i]) - edgeY * (px - x[i]) >= 0, solved for px
+		float slope = -edgeY;
+		float offset = edgeX * (rowY - y[i]) + edgeY * x[i];
+		if (slope > 0.f)
+			low = std::max(low, -offset / slope);
+		else if (slope < 0.f)
+			high = std::min(high, -offset / slope);
+		else if (offset < 0.f)
+			return false;
+	}
+
+	spanBegin = (int)ceilf(low - 0.5f);
+	spanEnd = (int)ceilf(high - 0.5f);
+	return spanBegin < spanEnd;
+}
+
+// signed area of a polygon, positive when its corners are counter clockwise
+static float PolygonArea(const float* x, const float* y, int cornerCount)
+{
+	float area = 0.f;
+	for (int i = 0; i < cornerCount; i++)
+	{
+		int j = (i + 1) % cornerCount;
+		area += x[i] * y[j] - x[j] * y[i];
+	}
+	return area * 0.5f;
+}
+
+SoftwareRenderer::SoftwareRenderer(unsigned int threadCount, int tileSize)
+	: m_ThreadCount(threadCount), m_TileSize(std::min(std::max(tileSize, 8), MAX_TILE_SIZE))
+{
+	if (m_ThreadCount == 0)
+		m_ThreadCount = std::thread::hardware_concurrency();
+	if (m_ThreadCount == 0)
+		m_ThreadCount = 1;
+
+	// the thread calling Render() is the last rasterizing thread
+	m_Workers.reserve(m_ThreadCount - 1);
+	for (unsigned int t = 1; t < m_ThreadCount; t++)
+		m_Workers.emplace_back(&SoftwareRenderer::WorkerLoop, this);
+}
+
+SoftwareRenderer::~SoftwareRenderer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_Start.notify_all();
+
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+void SoftwareRenderer::SetTarget(uint32_t* pixels, int width, int height, int stride)
+{
+	m_Pixels = pixels;
+	m_Width = width;
+	m_Height = height;
+	m_Stride = stride > 0 ? stride : width;
+
+	m_TilesX = (m_Width + m_TileSize - 1) / m_TileSize;
+	m_TilesY = (m_Height + m_TileSize - 1) / m_TileSize;
+	m_TileBins.resize((size_t)m_TilesX * m_TilesY);
+
+	// the pixel transform depends on the target size
+	SetViewProjection(m_ViewProjection);
+}
+
+void SoftwareRenderer::SetViewProjection(glm::mat4 viewProjection)
+{
+	m_ViewProjection = viewProjection;
+
+	// world to normalized device coordinates, then to pixels with rows from the top
+	const glm::mat4& m = m_ViewProjection;
+	float halfWidth = m_Width * 0.5f;
+	float halfHeight = m_Height * 0.5f;
+	m_ToPixel[0] = m[0][0] * halfWidth;
+	m_ToPixel[1] = m[1][0] * halfWidth;
+	m_ToPixel[2] = (m[3][0] + 1.f) * halfWidth;
+	m_ToPixel[3] = -m[0][1] * halfHeight;
+	m_ToPixel[4] = -m[1][1] * halfHeight;
+	m_ToPixel[5] = (1.f - m[3][1]) * halfHeight;
+
+	float determinant = m_ToPixel[0] * m_ToPixel[4] - m_ToPixel[1] * m_ToPixel[3];
+	if (determinant == 0.f)
+		return;
+
+	m_ToWorld[0] = m_ToPixel[4] / determinant;
+	m_ToWorld[1] = -m_ToPixel[1] / determinant;
+	m_ToWorld[3] = -m_ToPixel[3] / determinant;
+	m_ToWorld[4] = m_ToPixel[0] / determinant;
+	m_ToWorld[2] = -(m_ToWorld[0] * m_ToPixel[2] + m_ToWorld[1] * m_ToPixel[5]);
+	m_ToWorld[5] = -(m_ToWorld[3] * m_ToPixel[2] + m_ToWorld[4] * m_ToPixel[5]);
+}
+
+void SoftwareRenderer::SetTexture(int textureUnit, const unsigned char* pixels, int width, int height, int channels, SoftwareFilter filter)
+{
+	if (textureUnit < 0 || channels < 1 || channels > 4)
+		return;
+
+	if ((size_t)textureUnit >= m_Textures.size())
+		m_Textures.resize(textureUnit + 1);
+
+	SoftwareTexture& texture = m_Textures[textureUnit];
+	texture.Width = width;
+	texture.Height = height;
+	texture.Coverage = channels == 1;
+	texture.Filter = filter;
+	texture.Pixels.resize((size_t)width * height);
+
+	// expand to RGBA like GL does for missing channels, single channels are white with coverage as alpha
+	for (size_t i = 0; i < texture.Pixels.size(); i++)
+	{
+		const unsigned char* texel = pixels + i * channels;
+		switch (channels)
+		{
+		case 1: texture.Pixels[i] = PackPixel(255, 255, 255, texel[0]); break;
+		case 2: texture.Pixels[i] = PackPixel(texel[0], texel[1], 0, 255); break;
+		case 3: texture.Pixels[i] = PackPixel(texel[0], texel[1], texel[2], 255); break;
+		default: texture.Pixels[i] = PackPixel(texel[0], texel[1], texel[2], texel[3]); break;
+		}
+	}
+}
+
+void SoftwareRenderer::SetTexture(TextureAtlas* atlas, const unsigned char* pixels, int channels, SoftwareFilter filter)
+{
+	SetTexture(atlas->GetID(), pixels, atlas->GetTextureWidth(), atlas->GetTextureHeight(), channels, filter);
+}
+
+void SoftwareRenderer::RemoveTexture(int textureUnit)
+{
+	if (textureUnit >= 0 && (size_t)textureUnit < m_Textures.size())
+		m_Textures[textureUnit] = SoftwareTexture();
+}
+
+void SoftwareRenderer::Clear(float red, float green, float blue, float alpha)
+{
+	uint32_t color = PackPixel(ToByte(red), ToByte(green), ToByte(blue), ToByte(alpha));
+	for (int y = 0; y < m_Height; y++)
+		FillSpan(m_Pixels + (size_t)y * m_Stride, m_Width, color);
+}
+
+void SoftwareRenderer::AddTriangles(const float* vertices, unsigned int count)
+{
+	// shapes have a single color, so the first vertex colors the whole triangle
+	for (unsigned int i = 0; i + 3 <= count; i += 3)
+	{
+		const float* triangle = vertices + (size_t)i * 5;
+		float x[3], y[3];
+		for (int j = 0; j < 3; j++)
+			Project(triangle[j * 5], triangle[j * 5 + 1], x[j], y[j]);
+
+		AddPolygon(x, y, 3, triangle + 2);
+	}
+}
+
+void SoftwareRenderer::AddLines(const float* vertices, unsigned int count)
+{
+	for (unsigned int i = 0; i + 2 <= count; i += 2)
+	{
+		const float* line = vertices + (size_t)i * 5;
+
+		Primitive primitive;
+		primitive.Type = PRIMITIVE_LINE;
+		primitive.CornerCount = 2;
+		for (int j = 0; j < 2; j++)
+			Project(line[j * 5], line[j * 5 + 1], primitive.X[j], primitive.Y[j]);
+		std::copy(line + 2, line + 5, primitive.Color);
+
+		if (Bound(primitive, std::min(primitive.X[0], primitive.X[1]), std::min(primitive.Y[0], primitive.Y[1]), std::max(primitive.X[0], primitive.X[1]) + 1.f, std::max(primitive.Y[0], primitive.Y[1]) + 1.f))
+			m_Primitives.push_back(primitive);
+	}
+}
+
+void SoftwareRenderer::AddAnalyticShapes(const float* instances, unsigned int count)
+{
+	static const float corners[4][2] = { { -1.f, -1.f }, { 1.f, -1.f }, { 1.f, 1.f }, { -1.f, 1.f } };
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const float* instance = instances + (size_t)i * 10;
+
+		Primitive primitive;
+		primitive.Type = PRIMITIVE_ANALYTIC;
+		primitive.CornerCount = 4;
+		std::copy(instance + 2, instance + 6, primitive.Shape);
+		std::copy(instance + 7, instance + 10, primitive.Color);
+
+		// the same quad as the ANALYTIC_SHAPE vertex shader, grown past the edge for anti-aliasing
+		float s = sinf(instance[6]);
+		float c = cosf(instance[6]);
+
+		// pixels to the shape's local space, undoing its rotation
+		const float* w = m_ToWorld;
+		float* local = primitive.Shape + 4;
+		local[0] = c * w[0] + s * w[3];
+		local[1] = c * w[1] + s * w[4];
+		local[2] = c * (w[2] - instance[0]) + s * (w[5] - instance[1]);
+		local[3] = -s * w[0] + c * w[3];
+		local[4] = -s * w[1] + c * w[4];
+		local[5] = -s * (w[2] - instance[0]) + c * (w[5] - instance[1]);
+		for (int j = 0; j < 4; j++)
+		{
+			float localX = corners[j][0] * (instance[2] + 2.f);
+			float localY = corners[j][1] * (instance[3] + 2.f);
+			Project(instance[0] + c * localX - s * localY, instance[1] + s * localX + c * localY, primitive.X[j], primitive.Y[j]);
+		}
+
+		if (PolygonArea(primitive.X, primitive.Y, 4) < 0.f)
+		{
+			std::swap(primitive.X[1], primitive.X[3]);
+			std::swap(primitive.Y[1], primitive.Y[3]);
+		}
+
+		float minX = *std::min_element(primitive.X, primitive.X + 4), maxX = *std::max_element(primitive.X, primitive.X + 4);
+		float minY = *std::min_element(primitive.Y, primitive.Y + 4), maxY = *std::max_element(primitive.Y, primitive.Y + 4);
+		if (Bound(primitive, minX, minY, maxX, maxY))
+			m_Primitives.push_back(primitive);
+	}
+}
+
+void SoftwareRenderer::AddQuads(const float* quads, unsigned int count, bool distanceField)
+{
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const float* quad = quads + (size_t)i * VERTEX_FLOAT_COUNT;
+
+		// quads without registered pixels have nothing to sample
+		int texture = (int)quad[7];
+		if (texture < 0 || (size_t)texture >= m_Textures.size() || m_Textures[texture].Pixels.empty())
+			continue;
+
+		Primitive primitive;
+		primitive.Type = distanceField ? PRIMITIVE_DISTANCE_QUAD : PRIMITIVE_QUAD;
+		primitive.CornerCount = 4;
+		primitive.Texture = texture;
+		std::copy(quad + 4, quad + 7, primitive.Color);
+
+		// the quad's triangles are (0, 1, 3) and (3, 2, 0), so its outline is 0, 1, 3, 2
+		static const int outline[4] = { 0, 1, 3, 2 };
+		float u[4], v[4];
+		for (int j = 0; j < 4; j++)
+		{
+			const float* vertex = quad + outline[j] * 8;
+			Project(vertex[0], vertex[1], primitive.X[j], primitive.Y[j]);
+			u[j] = vertex[2];
+			v[j] = vertex[3];
+		}
+
+		// quads are parallelograms, so texture coordinates are affine over the whole quad
+		float x1 = primitive.X[1] - primitive.X[0], y1 = primitive.Y[1] - primitive.Y[0];
+		float x2 = primitive.X[3] - primitive.X[0], y2 = primitive.Y[3] - primitive.Y[0];
+		float determinant = x1 * y2 - x2 * y1;
+		if (determinant == 0.f)
+			continue;
+
+		const float* planes[2] = { u, v };
+		float* targets[2] = { primitive.U, primitive.V };
+		for (int j = 0; j < 2; j++)
+		{
+			const float* t = planes[j];
+			float perX = ((t[1] - t[0]) * y2 - (t[3] - t[0]) * y1) / determinant;
+			float perY = ((t[3] - t[0]) * x1 - (t[1] - t[0]) * x2) / determinant;
+			targets[j][0] = perX;
+			targets[j][1] = perY;
+			targets[j][2] = t[0] - perX * primitive.X[0] - perY * primitive.Y[0];
+		}
+
+		if (PolygonArea(primitive.X, primitive.Y, 4) < 0.f)
+		{
+			std::swap(primitive.X[1], primitive.X[3]);
+			std::swap(primitive.Y[1], primitive.Y[3]);
+		}
+
+		float minX = *std::min_element(primitive.X, primitive.X + 4), maxX = *std::max_element(primitive.X, primitive.X + 4);
+		float minY = *std::min_element(primitive.Y, primitive.Y + 4), maxY = *std::max_element(primitive.Y, primitive.Y + 4);
+		if (Bound(primitive, minX, minY, maxX, maxY))
+			m_Primitives.push_back(primitive);
+	}
+}
+
+void SoftwareRenderer::Render()
+{
+	if (m_Pixels && !m_Primitives.empty())
+	{
+		BinPrimitives();
+		RasterizeTiles();
+	}
+
+	m_Primitives.clear();
+	for (std::vector<unsigned int>& bin : m_TileBins)
+		bin.clear();
+}
+
+int SoftwareRenderer::GetWidth()
+{
+	return m_Width;
+}
+
+int SoftwareRenderer::GetHeight()
+{
+	return m_Height;
+}
+
+void SoftwareRenderer::Project(float x, float y, float& pixelX, float& pixelY)
+{
+	pixelX = m_ToPixel[0] * x + m_ToPixel[1] * y + m_ToPixel[2];
+	pixelY = m_ToPixel[3] * x + m_ToPixel[4] * y + m_ToPixel[5];
+}
+
+bool SoftwareRenderer::Bound(Primitive& primitive, float minX, float minY, float maxX, float maxY)
+{
+	if (!(maxX > 0.f && maxY > 0.f && minX < m_Width && minY < m_Height))
+		return false;
+
+	primitive.MinX = std::max((int)floorf(minX), 0);
+	primitive.MinY = std::max((int)floorf(minY), 0);
+	primitive.MaxX = std::min((int)ceilf(maxX) + 1, m_Width);
+	primitive.MaxY = std::min((int)ceilf(maxY) + 1, m_Height);
+	return true;
+}
+
+void SoftwareRenderer::AddPolygon(const float* x, const float* y, int cornerCount, const float* color)
+{
+	Primitive primitive;
+	primitive.Type = PRIMITIVE_POLYGON;
+	primitive.CornerCount = cornerCount;
+	std::copy(color, color + 3, primitive.Color);
+
+	// corners go counter clockwise, degenerate polygons cover nothing
+	float area = PolygonArea(x, y, cornerCount);
+	if (area == 0.f)
+		return;
+	for (int i = 0; i < cornerCount; i++)
+	{
+		int j = area > 0.f ? i : cornerCount - 1 - i;
+		primitive.X[i] = x[j];
+		primitive.Y[i] = y[j];
+	}
+
+	float minX = *std::min_element(x, x + cornerCount), maxX = *std::max_element(x, x + cornerCount);
+	float minY = *std::min_element(y, y + cornerCount), maxY = *std::max_element(y, y + cornerCount);
+	if (Bound(primitive, minX, minY, maxX, maxY))
+		m_Primitives.push_back(primitive);
+}
+
+void SoftwareRenderer::BinPrimitives()
+{
+	// primitives are binned in order, so every tile draws its primitives in submission order
+	for (unsigned int i = 0; i < (unsigned int)m_Primitives.size(); i++)
+	{
+		const Primitive& primitive = m_Primitives[i];
+		int firstX = primitive.MinX / m_TileSize, lastX = (primitive.MaxX - 1) / m_TileSize;
+		int firstY = primitive.MinY / m_TileSize, lastY = (primitive.MaxY - 1) / m_TileSize;
+
+		for (int tileY = firstY; tileY <= lastY; tileY++)
+		{
+			for (int tileX = firstX; tileX <= lastX; tileX++)
+				m_TileBins[(size_t)tileY * m_TilesX + tileX].push_back(i);
+		}
+	}
+}
+
+void SoftwareRenderer::RasterizeTiles()
+{
+	m_TileCount = m_TilesX * m_TilesY;
+	m_NextTile = 0;
+
+	if (!m_Workers.empty())
+	{	// wake the workers for this frame's tiles
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Job++;
+			m_Busy = (unsigned int)m_Workers.size();
+		}
+		m_Start.notify_all();
+	}
+
+	// the calling thread rasterizes tiles as well
+	RasterizeNextTiles();
+
+	// tiles taken by a worker may still be drawing
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Done.wait(lock, [this]() { return m_Busy == 0; });
+}
+
+void SoftwareRenderer::RasterizeNextTiles()
+{
+	for (int tile = m_NextTile++; tile < m_TileCount; tile = m_NextTile++)
+	{
+		if (!m_TileBins[tile].empty())
+			RasterizeTile(tile);
+	}
+}
+
+void SoftwareRenderer::WorkerLoop()
+{
+	unsigned long long job = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Start.wait(lock, [this, job]() { return m_Stopping || m_Job != job; });
+			if (m_Stopping)
+				return;
+			job = m_Job;
+		}
+
+		RasterizeNextTiles();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (--m_Busy == 0)
+			m_Done.notify_one();
+	}
+}
+
+void SoftwareRenderer::RasterizeTile(int tile)
+{
+	int tileMinX = (tile % m_TilesX) * m_TileSize;
+	int tileMinY = (tile / m_TilesX) * m_TileSize;
+	int tileMaxX = std::min(tileMinX + m_TileSize, m_Width);
+	int tileMaxY = std::min(tileMinY + m_TileSize, m_Height);
+
+	for (unsigned int index : m_TileBins[tile])
+	{
+		const Primitive& primitive = m_Primitives[index];
+		int minX = std::max(primitive.MinX, tileMinX), maxX = std::min(primitive.MaxX, tileMaxX);
+		int minY = std::max(primitive.MinY, tileMinY), maxY = std::min(primitive.MaxY, tileMaxY);
+
+		switch (primitive.Type)
+		{
+		case PRIMITIVE_POLYGON: DrawPolygon(primitive, minX, minY, maxX, maxY); break;
+		case PRIMITIVE_LINE: DrawLine(primitive, minX, minY, maxX, maxY); break;
+		case PRIMITIVE_ANALYTIC: DrawAnalytic(primitive, minX, minY, maxX, maxY); break;
+		default: DrawQuad(primitive, minX, minY, maxX, maxY); break;
+		}
+	}
+}
+
+void SoftwareRenderer::DrawPolygon(const Primitive& primitive, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY)
+{
+	// shapes are opaque, spans are filled without blending
+	uint32_t color = PackPixel(ToByte(primitive.Color[0]), ToByte(primitive.Color[1]), ToByte(primitive.Color[2]), 255);
+	for (int y = tileMinY; y < tileMaxY; y++)
+	{
+		int begin, end;
+		if (PolygonSpan(primitive.X, primitive.Y, primitive.CornerCount, y + 0.5f, tileMinX, tileMaxX, begin, end))
+			FillSpan(m_Pixels + (size_t)y * m_Stride + begin, end - begin, color);
+	}
+}
+
+void SoftwareRenderer::DrawLine(const Primitive& primitive, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY)
+{
+	uint32_t color = PackPixel(ToByte(primitive.Color[0]), ToByte(primitive.Color[1]), ToByte(primitive.Color[2]), 255);
+
+	// one pixel per column or row along the major axis, from the first endpoint up to but excluding the last like GL
+	float x0 = primitive.X[0], y0 = primitive.Y[0], x1 = primitive.X[1], y1 = primitive.Y[1];
+	bool majorX = fabsf(x1 - x0) >= fabsf(y1 - y0);
+	if (!majorX)
+	{
+		std::swap(x0, y0);
+		std::swap(x1, y1);
+	}
+	if (x0 == x1)
+		return;
+
+	float slope = (y1 - y0) / (x1 - x0);
+	int first = (int)ceilf(std::min(x0, x1) - 0.5f);
+	int last = (int)ceilf(std::max(x0, x1) - 0.5f);
+	for (int major = first; major < last; major++)
+	{
+		int minor = (int)floorf(y0 + (major + 0.5f - x0) * slope);
+		int x = majorX ? major : minor;
+		int y = majorX ? minor : major;
+		if (x >= tileMinX && x < tileMaxX && y >= tileMinY && y < tileMaxY)
+			m_Pixels[(size_t)y * m_Stride + x] = color;
+	}
+}
+
+float SoftwareRenderer::AnalyticDistance(const float* shape, float localX, float localY)
+{
+	// same rounded box distance as the ANALYTIC_SHAPE fragment shader
+	float cornerRadius = shape[2];
+	float qx = fabsf(localX) - shape[0] + cornerRadius;
+	float qy = fabsf(localY) - shape[1] + cornerRadius;
+	float outside = sqrtf(std::max(qx, 0.f) * std::max(qx, 0.f) + std::max(qy, 0.f) * std::max(qy, 0.f));
+	float distance = outside + std::min(std::max(qx, qy), 0.f) - cornerRadius;
+
+	float thickness = shape[3];
+	if (thickness > 0.f)
+		distance = fabsf(distance + thickness * 0.5f) - thickness * 0.5f;
+	return distance;
+}
+
+void SoftwareRenderer::DrawAnalytic(const Primitive& primitive, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY)
+{
+	uint32_t red = ToByte(primitive.Color[0]), green = ToByte(primitive.Color[1]), blue = ToByte(primitive.Color[2]);
+	unsigned char coverage[MAX_TILE_SIZE];
+
+	for (int y = tileMinY; y < tileMaxY; y++)
+	{
+		int begin, end;
+		if (!PolygonSpan(primitive.X, primitive.Y, 4, y + 0.5f, tileMinX, tileMaxX, begin, end))
+			continue;
+
+		const float* local = primitive.Shape + 4;
+		float localX = local[0] * (begin + 0.5f) + local[1] * (y + 0.5f) + local[2];
+		float localY = local[3] * (begin + 0.5f) + local[4] * (y + 0.5f) + local[5];
+		for (int x = begin; x < end; x++, localX += local[0], localY += local[3])
+		{
+			// fwidth() from the distance at the next pixel in x and y
+			float distance = AnalyticDistance(primitive.Shape, localX, localY);
+			float width = fabsf(AnalyticDistance(primitive.Shape, localX + local[0], localY + local[3]) - distance) + fabsf(AnalyticDistance(primitive.Shape, localX + local[1], localY + local[4]) - distance);
+			float alpha = width > 0.f ? 0.5f - distance / width : (distance < 0.f ? 1.f : 0.f);
+			coverage[x - begin] = (unsigned char)ToByte(alpha);
+		}
+
+		BlendSpan(m_Pixels + (size_t)y * m_Stride + begin, coverage, end - begin, red, green, blue);
+	}
+}
+
+void SoftwareRenderer::DrawQuad(const Primitive& primitive, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY)
+{
+	const SoftwareTexture& texture = m_Textures[primitive.Texture];
+	uint32_t red = ToByte(primitive.Color[0]), green = ToByte(primitive.Color[1]), blue = ToByte(primitive.Color[2]);
+	unsigned char coverage[MAX_TILE_SIZE];
+
+	for (int y = tileMinY; y < tileMaxY; y++)
+	{
+		int begin, end;
+		if (!PolygonSpan(primitive.X, primitive.Y, 4, y + 0.5f, tileMinX, tileMaxX, begin, end))
+			continue;
+
+		uint32_t* row = m_Pixels + (size_t)y * m_Stride;
+		float u = primitive.U[0] * (begin + 0.5f) + primitive.U[1] * (y + 0.5f) + primitive.U[2];
+		float v = primitive.V[0] * (begin + 0.5f) + primitive.V[1] * (y + 0.5f) + primitive.V[2];
+
+		if (primitive.Type == PRIMITIVE_DISTANCE_QUAD)
+		{
+			// same smoothstep over one pixel as the SDF_TEXT shader, fwidth() from the next pixel in x and y
+			for (int x = begin; x < end; x++, u += primitive.U[0], v += primitive.V[0])
+			{
+				float distance = SampleDistance(texture, u, v);
+				float width = 0.5f * (fabsf(SampleDistance(texture, u + primitive.U[0], v + primitive.V[0]) - distance) + fabsf(SampleDistance(texture, u + primitive.U[1], v + primitive.V[1]) - distance));
+
+				float alpha;
+				if (width > 0.f)
+				{
+					float t = std::min(std::max((distance - 0.5f + width) / (2.f * width), 0.f), 1.f);
+					alpha = t * t * (3.f - 2.f * t);
+				}
+				else
+					alpha = distance >= 0.5f ? 1.f : 0.f;
+				coverage[x - begin] = (unsigned char)ToByte(alpha);
+			}
+
+			BlendSpan(row + begin, coverage, end - begin, red, green, blue);
+			continue;
+		}
+
+		// the texture color is multiplied by the quad color, like the MULTI_TEXTURE_RENDER shader
+		for (int x = begin; x < end; x++, u += primitive.U[0], v += primitive.V[0])
+		{
+			float texel[4];
+			Sample(texture, u, v, texel);
+			uint32_t alpha = ToByte(texel[3]);
+			if (alpha > 0)
+				row[x] = BlendPixel(row[x], ToByte(texel[0] * primitive.Color[0]), ToByte(texel[1] * primitive.Color[1]), ToByte(texel[2] * primitive.Color[2]), alpha);
+		}
+	}
+}
+
+void SoftwareRenderer::Sample(const SoftwareTexture& texture, float u, float v, float* rgba)
+{
+	auto channels = [&rgba](uint32_t texel, float weight)
+	{
+		for (int channel = 0; channel < 4; channel++)
+			rgba[channel] += ((texel >> (channel * 8)) & 0xFF) * weight;
+	};
+	rgba[0] = rgba[1] = rgba[2] = rgba[3] = 0.f;
+
+	if (texture.Filter == SOFTWARE_NEAREST)
+	{
+		int x = std::min(std::max((int)floorf(u * texture.Width), 0), texture.Width - 1);
+		int y = std::min(std::max((int)floorf(v * texture.Height), 0), texture.Height - 1);
+		channels(texture.Pixels[(size_t)y * texture.Width + x], 1.f / 255.f);
+		return;
+	}
+
+	// texel centers are at half coordinates, edges are clamped
+	float fx = u * texture.Width - 0.5f;
+	float fy = v * texture.Height - 0.5f;
+	float baseX = floorf(fx), baseY = floorf(fy);
+	float tx = fx - baseX, ty = fy - baseY;
+	int x0 = std::min(std::max((int)baseX, 0), texture.Width - 1), x1 = std::min(std::max((int)baseX + 1, 0), texture.Width - 1);
+	int y0 = std::min(std::max((int)baseY, 0), texture.Height - 1), y1 = std::min(std::max((int)baseY + 1, 0), texture.Height - 1);
+
+	const uint32_t* row0 = texture.Pixels.data() + (size_t)y0 * texture.Width;
+	const uint32_t* row1 = texture.Pixels.data() + (size_t)y1 * texture.Width;
+	channels(row0[x0], (1.f - tx) * (1.f - ty) / 255.f);
+	channels(row0[x1], tx * (1.f - ty) / 255.f);
+	channels(row1[x0], (1.f - tx) * ty / 255.f);
+	channels(row1[x1], tx * ty / 255.f);
+}
+
+float SoftwareRenderer::SampleDistance(const SoftwareTexture& texture, float u, float v)
+{
+	// single channel textures keep their values in alpha, see SetTexture()
+	float rgba[4];
+	Sample(texture, u, v, rgba);
+	return texture.Coverage ? rgba[3] : rgba[0];
+}
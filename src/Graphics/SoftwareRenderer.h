@@ -0,0 +1,167 @@
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include "TextureAtlas.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Enum for the way software textures are sampled
+enum SoftwareFilter
+{
+	// Nearest texel, like GL_NEAREST
+	SOFTWARE_NEAREST,
+	// Bilinear blend of the 4 nearest texels, like GL_LINEAR
+	SOFTWARE_LINEAR
+};
+
+// renderer drawing the queued shapes, images and text on the CPU into a user owned framebuffer
+// primitives are binned into screen tiles, then the tiles are rasterized in parallel by a pool of worker threads, each tile by a single thread
+// output follows the GL pipeline closely: pixel center sampling, the same distance field anti-aliasing and src alpha blending
+// * the renderer itself makes no GL calls, primitives added to it directly draw without any GL context
+// * drawing through Graphics::SetSoftwareRenderer() still needs a live GL context: Init(), TextureRenderer and TextureAtlas create GL objects
+// * texture pixels are never read back from GL, register them with SetTexture() after creating an atlas and again after changing it
+// * only affine view projections are supported, like the orthographic projection of the Matrices uniform buffer
+// * textures are clamped to the edge and have no mipmaps, see SetTexture()
+class SoftwareRenderer
+{
+public:
+	// threadCount is the number of threads rasterizing tiles, 0 uses every hardware thread
+	// tileSize is the width and height of a screen tile in pixels, up to 256
+	// * the calling thread of Render() rasterizes as well, threadCount - 1 workers are started here and kept until destruction
+	SoftwareRenderer(unsigned int threadCount = 0, int tileSize = 64);
+	~SoftwareRenderer();
+
+	SoftwareRenderer(const SoftwareRenderer&) = delete;
+	SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+
+	// set the framebuffer to draw into, RGBA8 pixels with rows from the top down
+	// stride is the distance between rows in pixels, 0 for tightly packed rows
+	// * the pixels are owned by the caller and have to outlive every Render()
+	void SetTarget(uint32_t* pixels, int width, int height, int stride = 0);
+
+	// set the view projection placing primitives on the framebuffer, usually the matrix of the Matrices uniform buffer
+	void SetViewProjection(glm::mat4 viewProjection);
+
+	// register a CPU copy of the pixels of a texture unit, quads sampling an unregistered unit are skipped
+	// pixels have 1 to 4 channels with rows from the top, single channel textures are coverage like glyph cache pages
+	// * the pixels are copied, call again after the texture changed
+	void SetTexture(int textureUnit, const unsigned char* pixels, int width, int height, int channels, SoftwareFilter filter = SOFTWARE_LINEAR);
+	void SetTexture(TextureAtlas* atlas, const unsigned char* pixels, int channels, SoftwareFilter filter = SOFTWARE_LINEAR);
+	void RemoveTexture(int textureUnit);
+
+	// fill the whole framebuffer with a color
+	void Clear(float red = 0.f, float green = 0.f, float blue = 0.f, float alpha = 1.f);
+
+	// queue primitives in drawing order, in the vertex formats of the Graphics shape streams
+	// triangles and lines are (x, y, r, g, b) per vertex, count is the vertex count
+	void AddTriangles(const float* vertices, unsigned int count);
+	void AddLines(const float* vertices, unsigned int count);
+	// analytic shapes are (center x, y, half width, half height, corner radius, thickness, rotation, r, g, b) per instance
+	void AddAnalyticShapes(const float* instances, unsigned int count);
+	// quads are VERTEX_FLOAT_COUNT floats each, like TextureRenderer::GetQuadData()
+	// distanceField draws them as distance field text, like the SDF_TEXT shader
+	void AddQuads(const float* quads, unsigned int count, bool distanceField = false);
+
+	// rasterize every queued primitive into the framebuffer, then clear the queue
+	void Render();
+
+	int GetWidth();
+	int GetHeight();
+
+private:
+	// Enum for the kind of a queued primitive
+	enum PrimitiveType { PRIMITIVE_POLYGON, PRIMITIVE_LINE, PRIMITIVE_ANALYTIC, PRIMITIVE_QUAD, PRIMITIVE_DISTANCE_QUAD };
+
+	// a primitive projected to pixels, polygons are convex with 3 or 4 corners
+	struct Primitive
+	{
+		PrimitiveType Type;
+		int CornerCount = 0;
+		float X[4], Y[4];
+		float Color[3];
+		int Texture = -1;
+		// texture coordinates are planes over the pixels, (per pixel x, per pixel y, at pixel 0)
+		float U[3], V[3];
+		// analytic shapes keep their size, corner radius and thickness, then their local space as planes over the pixels
+		float Shape[10];
+		// pixel bounds, inclusive min and exclusive max
+		int MinX, MinY, MaxX, MaxY;
+	};
+
+	// a registered texture, expanded to RGBA8
+	struct SoftwareTexture
+	{
+		std::vector<uint32_t> Pixels;
+		int Width = 0;
+		int Height = 0;
+		bool Coverage = false;
+		SoftwareFilter Filter = SOFTWARE_LINEAR;
+	};
+
+	// private helper functions
+	void Project(float x, float y, float& pixelX, float& pixelY);
+	// compute the pixel bounds of a primitive, returns false when it is off the framebuffer
+	bool Bound(Primitive& primitive, float minX, float minY, float maxX, float maxY);
+	void AddPolygon(const float* x, const float* y, int cornerCount, const float* color);
+
+	void BinPrimitives();
+	void RasterizeTiles();
+	// rasterize tiles until none are left, run by the workers and the thread calling Render()
+	void RasterizeNextTiles();
+	void RasterizeTile(int tile);
+	void WorkerLoop();
+
+	void DrawPolygon(const Primitive& primitive, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY);
+	void DrawLine(const Primitive& primitive, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY);
+	void DrawAnalytic(const Primitive& primitive, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY);
+	void DrawQuad(const Primitive& primitive, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY);
+
+	// distance of a pixel to an analytic shape, in world units
+	float AnalyticDistance(const float* shape, float localX, float localY);
+	// texture sample as floats from 0 to 1
+	void Sample(const SoftwareTexture& texture, float u, float v, float* rgba);
+	float SampleDistance(const SoftwareTexture& texture, float u, float v);
+
+private:
+	// tiles are rasterized with stack buffers of this size
+	static const int MAX_TILE_SIZE = 256;
+
+	unsigned int m_ThreadCount = 1;
+	int m_TileSize = 64;
+
+	// framebuffer members
+	uint32_t* m_Pixels = nullptr;
+	int m_Width = 0;
+	int m_Height = 0;
+	int m_Stride = 0;
+
+	// world to pixel transform, px = a * x + b * y + c and py = d * x + e * y + f, and its inverse
+	glm::mat4 m_ViewProjection = glm::mat4(1.f);
+	float m_ToPixel[6] = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+	float m_ToWorld[6] = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+
+	// data storage members
+	std::vector<SoftwareTexture> m_Textures;	// indexed by texture unit
+	std::vector<Primitive> m_Primitives;
+	int m_TilesX = 0;
+	int m_TilesY = 0;
+	std::vector<std::vector<unsigned int>> m_TileBins;	// primitive indices per tile, in drawing order
+
+	// worker pool, every Render() bumps m_Job and waits until m_Busy workers are done with it
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_Start;
+	std::condition_variable m_Done;
+	unsigned long long m_Job = 0;
+	unsigned int m_Busy = 0;
+	bool m_Stopping = false;
+	std::atomic<int> m_NextTile{ 0 };	// tiles are taken from this counter, they never share pixels
+	int m_TileCount = 0;
+};
+
+#endif
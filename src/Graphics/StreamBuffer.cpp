@@ -0,0 +1,102 @@
+#include "StreamBuffer.h"
+
+#include <cstring>
+
+StreamBuffer::FrameState StreamBuffer::m_DefaultFrame;
+thread_local StreamBuffer::FrameState* StreamBuffer::m_Frame = &StreamBuffer::m_DefaultFrame;
+
+StreamBuffer::StreamBuffer(GLenum target)
+	: m_Target(target)
+{
+	glGenBuffers(1, &m_ID);
+}
+
+unsigned int StreamBuffer::Reserve(unsigned int size, unsigned int alignment)
+{
+	const FrameState& frame = *m_Frame;
+
+	// without frame pipelining every upload gets fresh storage from the driver instead of waiting on draws still reading the old data
+	if (frame.FrameCount == 0)
+	{
+		if (size > m_RegionCapacity)
+			m_RegionCapacity = m_RegionCapacity * 2 > size ? m_RegionCapacity * 2 : size;
+
+		m_RegionCount = 1;
+		glBufferData(m_Target, m_RegionCapacity, NULL, GL_DYNAMIC_DRAW);
+		return 0;
+	}
+
+	// the first upload of a frame starts at the beginning of its region
+	if (m_Serial != frame.FrameSerial)
+	{
+		m_Serial = frame.FrameSerial;
+		m_Cursor = 0;
+	}
+
+	unsigned int regionStart = frame.FrameSlot * m_RegionCapacity;
+	unsigned int offset = (regionStart + m_Cursor + alignment - 1) / alignment * alignment;
+	if (m_RegionCount != frame.FrameCount || offset + size > regionStart + m_RegionCapacity)
+	{
+		// fresh storage with every region empty, the rest of the frame's region has room for the upload after alignment
+		// regions grow once per frame, a frame that fills them again only orphans the storage,
+		// so frames that are never started with BeginFrame() can't keep doubling the buffer
+		unsigned int needed = size + alignment;
+		if (m_GrowSerial != frame.FrameSerial)
+		{
+			m_RegionCapacity = m_RegionCapacity * 2 > needed ? m_RegionCapacity * 2 : needed;
+			m_GrowSerial = frame.FrameSerial;
+		}
+		else if (needed > m_RegionCapacity)
+		{
+			m_RegionCapacity = needed;
+		}
+		m_RegionCount = frame.FrameCount;
+		glBufferData(m_Target, (GLsizeiptr)m_RegionCapacity * m_RegionCount, NULL, GL_DYNAMIC_DRAW);
+
+		regionStart = frame.FrameSlot * m_RegionCapacity;
+		offset = (regionStart + alignment - 1) / alignment * alignment;
+	}
+
+	m_Cursor = offset + size - regionStart;
+	return offset;
+}
+
+void* StreamBuffer::Map(unsigned int size, unsigned int& offset, unsigned int alignment)
+{
+	offset = Reserve(size, alignment);
+
+	// the bytes are either fresh storage or in a region BeginFrame() waited for, so the driver doesn't have to synchronize
+	return glMapBufferRange(m_Target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+void StreamBuffer::Unmap()
+{
+	glUnmapBuffer(m_Target);
+}
+
+unsigned int StreamBuffer::Upload(const void* data, unsigned int size, unsigned int alignment)
+{
+	// mapping no bytes is an error
+	if (size == 0)
+		return Reserve(size, alignment);
+
+	unsigned int offset;
+	void* mapped = Map(size, offset, alignment);
+	if (mapped)
+	{
+		memcpy(mapped, data, size);
+		Unmap();
+	}
+	return offset;
+}
+
+unsigned int StreamBuffer::GetID()
+{
+	return m_ID;
+}
+
+void StreamBuffer::Clean()
+{
+	glDeleteBuffers(1, &m_ID);
+	m_ID = 0;
+}
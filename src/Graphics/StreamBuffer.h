@@ -0,0 +1,60 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include "Shader.h"
+
+// Dynamic buffer for data uploaded every frame, split into one region per frame in flight
+// Uploads of a frame are appended to its own region, so they never overwrite data an earlier frame may still be drawing
+// Graphics::BeginFrame() moves every stream buffer on to the next region, see Graphics::SetFramesInFlight()
+class StreamBuffer
+{
+public:
+	// frame state shared by every stream buffer of a Graphics context
+	struct FrameState
+	{
+		// number of regions, 0 when frames are not pipelined and every upload orphans the buffer instead
+		unsigned int FrameCount = 0;
+		// region of the frame being built, and a serial changing on every frame
+		unsigned int FrameSlot = 0;
+		unsigned long long FrameSerial = 0;
+	};
+
+	// frame state of the Graphics context current on the calling thread, m_DefaultFrame until one is made current
+	static thread_local FrameState* m_Frame;
+	static FrameState m_DefaultFrame;
+
+	StreamBuffer() = default;
+	// generate the buffer, target is what it gets bound to for uploads
+	StreamBuffer(GLenum target);
+
+	// make room for size bytes in the region of the current frame and map them for writing, returns the mapped bytes
+	// offset receives their offset in the buffer in bytes, a multiple of alignment,
+	// so it divides into whole vertices when alignment is the vertex size
+	// * the buffer has to be bound to its target, call Unmap() once the bytes are written
+	// * a full region reallocates the buffer, draws already issued keep reading the previous storage
+	void* Map(unsigned int size, unsigned int& offset, unsigned int alignment = 4);
+	void Unmap();
+	// map, copy and unmap size bytes of data, returns their offset in the buffer
+	unsigned int Upload(const void* data, unsigned int size, unsigned int alignment = 4);
+
+	unsigned int GetID();
+
+	// delete the buffer
+	void Clean();
+
+private:
+	// private helper functions
+	unsigned int Reserve(unsigned int size, unsigned int alignment);
+
+private:
+	GLenum m_Target = GL_ARRAY_BUFFER;
+	unsigned int m_ID = 0;
+
+	unsigned int m_RegionCapacity = 0;		// size of a region in bytes
+	unsigned int m_RegionCount = 0;			// regions of the current storage
+	unsigned int m_Cursor = 0;				// bytes used in the region of the current frame
+	unsigned long long m_Serial = 0;		// frame serial the cursor belongs to
+	unsigned long long m_GrowSerial = ~0ULL;	// frame serial the regions last grew in
+};
+
+#endif
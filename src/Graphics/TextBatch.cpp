@@ -0,0 +1,115 @@
+#include "TextBatch.h"
+
+#include <algorithm>
+
+TextBatch::TextBatch()
+{
+	// generate vao and buffers
+	glGenVertexArrays(1, &m_VAO);
+	glGenBuffers(1, &m_VBO);
+	glGenBuffers(1, &m_RunBuffer);
+	glGenTextures(1, &m_RunTexture);
+
+	glBindVertexArray(m_VAO);
+
+	// one glyph per instance, the 4 quad corners come from gl_VertexID
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	glVertexAttribIPointer(0, 3, GL_UNSIGNED_SHORT, sizeof(uint16_t) * 3, (void*)0);
+	glVertexAttribDivisor(0, 1);
+	glEnableVertexAttribArray(0);
+
+	glBindVertexArray(0);
+
+	// runs are 2 texels of the run table, which can't outgrow the driver's texture buffer limit
+	GLint maxTexels = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+	m_MaxRuns = std::min(MAX_RUNS, (unsigned int)std::max(maxTexels, 0) / 2);
+}
+
+bool TextBatch::AddRun(float x, float y, float scale, float rotation, float red, float green, float blue)
+{
+	if (GetRunCount() >= m_MaxRuns)
+		return false;
+
+	const float run[8] = { x, y, scale, rotation, red, green, blue, 0.f };
+	m_Runs.insert(m_Runs.end(), run, run + 8);
+
+	m_Dirty = true;
+	return true;
+}
+
+void TextBatch::AddGlyph(unsigned char ch, unsigned int penOffset)
+{
+	unsigned int run = GetRunCount() - 1;
+
+	m_Glyphs.push_back((uint16_t)penOffset);
+	m_Glyphs.push_back((uint16_t)(ch | ((run & 0xFF) << 8)));
+	m_Glyphs.push_back((uint16_t)(run >> 8));
+
+	m_Dirty = true;
+}
+
+void TextBatch::Clear()
+{
+	m_Glyphs.clear();
+	m_Runs.clear();
+	m_Dirty = true;
+}
+
+void TextBatch::Upload()
+{
+	if (!m_Dirty)
+		return;
+
+	// buffers only grow, so a batch refilled every frame stops allocating
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	if (GetGlyphCount() > m_GlyphCapacity)
+	{
+		m_GlyphCapacity = GetGlyphCount() * 2;
+		glBufferData(GL_ARRAY_BUFFER, sizeof(uint16_t) * 3 * m_GlyphCapacity, NULL, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(uint16_t) * m_Glyphs.size(), m_Glyphs.data());
+
+	glBindBuffer(GL_TEXTURE_BUFFER, m_RunBuffer);
+	if (GetRunCount() > m_RunCapacity)
+	{
+		m_RunCapacity = GetRunCount() * 2;
+		glBufferData(GL_TEXTURE_BUFFER, sizeof(GL_FLOAT) * 8 * m_RunCapacity, NULL, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, sizeof(GL_FLOAT) * m_Runs.size(), m_Runs.data());
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	m_Dirty = false;
+}
+
+void TextBatch::Bind(int runTextureUnit)
+{
+	glBindVertexArray(m_VAO);
+
+	glActiveTexture(GL_TEXTURE0 + runTextureUnit);
+	glBindTexture(GL_TEXTURE_BUFFER, m_RunTexture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_RunBuffer);
+}
+
+void TextBatch::Clean() const
+{
+	glDeleteVertexArrays(1, &m_VAO);
+	glDeleteBuffers(1, &m_VBO);
+	glDeleteBuffers(1, &m_RunBuffer);
+	glDeleteTextures(1, &m_RunTexture);
+}
+
+unsigned int TextBatch::GetGlyphCount()
+{
+	return (unsigned int)m_Glyphs.size() / 3;
+}
+
+unsigned int TextBatch::GetRunCount()
+{
+	return (unsigned int)m_Runs.size() / 8;
+}
+
+unsigned int TextBatch::GetMaxRuns()
+{
+	return m_MaxRuns;
+}
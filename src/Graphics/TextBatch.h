@@ -0,0 +1,60 @@
+#ifndef TEXT_BATCH_H
+#define TEXT_BATCH_H
+
+#include "Shader.h"
+
+#include <cstdint>
+#include <vector>
+
+// Bulk text stored as char codes, glyph quads are generated by the BULK_TEXT vertex shader
+// Every glyph is 6 bytes and every run 32 bytes, against 152 bytes per glyph for Print()
+// Filled by Graphics::BatchText() and drawn through Graphics::Draw(), suited to log panes and tables
+class TextBatch
+{
+public:
+	TextBatch();
+
+	// start a new run, the following glyphs are placed relative to its origin
+	// returns false when the batch already holds the most runs it can index, see GetMaxRuns()
+	bool AddRun(float x, float y, float scale, float rotation, float red, float green, float blue);
+	// add a glyph to the current run, penOffset is its unscaled distance from the run origin in pixels
+	void AddGlyph(unsigned char ch, unsigned int penOffset);
+	// remove all runs and glyphs
+	void Clear();
+
+	// upload the runs and glyphs when they changed since the last upload
+	void Upload();
+
+	// bind the glyph vao and the run table to a texture unit
+	void Bind(int runTextureUnit);
+	// delete the batch buffers and run table
+	void Clean() const;
+
+	unsigned int GetGlyphCount();
+	unsigned int GetRunCount();
+	// most runs a batch holds, MAX_RUNS clamped to the run table size the driver supports
+	// * GL 3.3 only guarantees texture buffers of 65536 texels, which is 32768 runs
+	unsigned int GetMaxRuns();
+
+public:
+	// packing limits of a glyph, a 24 bit run index and 16 bit pen offset
+	static const unsigned int MAX_RUNS = 1 << 24;
+	static const unsigned int MAX_PEN_OFFSET = 0xFFFF;
+
+private:
+	// opengl specific members
+	unsigned int m_VAO = 0, m_VBO = 0;
+	unsigned int m_RunBuffer = 0, m_RunTexture = 0;
+	unsigned int m_GlyphCapacity = 0, m_RunCapacity = 0;
+	unsigned int m_MaxRuns = 0;
+
+	// data storage members
+	// glyphs are 3 uint16 each: pen offset, char | low run bits << 8, high run bits
+	std::vector<uint16_t> m_Glyphs;
+	// runs are 2 texels each: (x, y, scale, rotation), (r, g, b, unused)
+	std::vector<float> m_Runs;
+
+	bool m_Dirty = false;
+};
+
+#endif
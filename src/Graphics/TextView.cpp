@@ -0,0 +1,225 @@
+#include "TextView.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+TextView::~TextView()
+{
+	Close();
+}
+
+bool TextView::Open(const std::string& path)
+{
+	Close();
+
+	if (!m_File.Open(path))
+		return false;
+	m_Text = std::string_view(m_File.GetData(), m_File.GetSize());
+
+	m_LineStarts.assign(1, 0);
+	IndexLines(0);
+	m_Scroll = 0.0;
+	Invalidate();
+	return true;
+}
+
+void TextView::SetText(std::string_view text)
+{
+	Close();
+
+	m_Text = text;
+	m_LineStarts.assign(1, 0);
+	IndexLines(0);
+	Invalidate();
+}
+
+void TextView::ExtendText(std::string_view text)
+{
+	// a mapped file has a fixed size
+	assert(m_File.GetData() == nullptr && text.size() >= m_Text.size());
+
+	size_t from = m_Text.size();
+	m_Text = text;
+
+	// the last line may have grown
+	size_t lastLine = m_LineStarts.size() - 1;
+	if (!m_Cache.empty() && m_Cache[lastLine % m_Cache.size()].Line == lastLine)
+		m_Cache[lastLine % m_Cache.size()].Line = NO_LINE;
+
+	IndexLines(from);
+}
+
+void TextView::Close()
+{
+	m_File.Close();
+	m_Text = std::string_view();
+	m_LineStarts.clear();
+	m_Scroll = 0.0;
+	Invalidate();
+}
+
+void TextView::SetViewport(float x, float y, float height)
+{
+	m_X = x;
+	m_Y = y;
+	m_Height = height;
+}
+
+void TextView::SetMargin(unsigned int lines)
+{
+	m_Margin = lines;
+}
+
+void TextView::SetScale(float scale)
+{
+	m_Scale = scale;
+}
+
+void TextView::SetMaxLineLength(unsigned int length)
+{
+	if (length != m_MaxLineLength)
+		Invalidate();
+	m_MaxLineLength = length;
+}
+
+void TextView::ScrollTo(double firstLine)
+{
+	// stop once the last line reaches the bottom of the view
+	float lineHeight = Graphics::GetLineHeight(m_Scale);
+	double fullLines = lineHeight > 0.f ? floor(m_Height / lineHeight) : 0.0;
+	double lastScroll = std::max((double)GetLineCount() - fullLines, 0.0);
+
+	m_Scroll = std::min(std::max(firstLine, 0.0), lastScroll);
+}
+
+void TextView::ScrollBy(double lines)
+{
+	ScrollTo(m_Scroll + lines);
+}
+
+double TextView::GetScroll()
+{
+	return m_Scroll;
+}
+
+size_t TextView::GetLineCount()
+{
+	// a line break at the very end doesn't start another line
+	size_t count = m_LineStarts.size();
+	if (count > 0 && m_LineStarts.back() == m_Text.size())
+		count--;
+	return count;
+}
+
+std::string_view TextView::GetLine(size_t line)
+{
+	assert(line < GetLineCount());
+
+	size_t start = m_LineStarts[line];
+	size_t end = line + 1 < m_LineStarts.size() ? m_LineStarts[line + 1] - 1 : m_Text.size();
+
+	std::string_view text = m_Text.substr(start, end - start);
+	if (!text.empty() && text.back() == '\r')
+		text.remove_suffix(1);
+	return text;
+}
+
+unsigned int TextView::GetVisibleLineCount()
+{
+	float lineHeight = Graphics::GetLineHeight(m_Scale);
+	if (lineHeight <= 0.f)
+		return 0;
+
+	// one more for the line cut in half while scrolling
+	return (unsigned int)ceilf(m_Height / lineHeight) + 1;
+}
+
+void TextView::Draw(float red, float green, float blue)
+{
+	// a different font or scale invalidates every laid out line
+	float lineHeight = Graphics::GetLineHeight(m_Scale);
+	if (Graphics::GetFont() != m_Font || Graphics::GetFontSize() != m_FontSize || lineHeight != m_LineHeight)
+	{
+		Invalidate();
+		m_Font = Graphics::GetFont();
+		m_FontSize = Graphics::GetFontSize();
+		m_LineHeight = lineHeight;
+	}
+
+	size_t lineCount = GetLineCount();
+	if (lineHeight <= 0.f || lineCount == 0)
+		return;
+
+	unsigned int visibleLines = GetVisibleLineCount();
+	ResizeCache(visibleLines);
+
+	size_t firstLine = (size_t)m_Scroll;
+	float y = m_Y - (float)(m_Scroll - firstLine) * lineHeight;
+
+	for (size_t line = firstLine; line < lineCount && line < firstLine + visibleLines; line++)
+	{
+		float lineY = y + (line - firstLine) * lineHeight;
+		if (lineY >= m_Y + m_Height)
+			break;
+
+		Graphics::Draw(GetBlob(line), m_X, lineY, red, green, blue);
+	}
+
+	// lay out the margins ahead of scrolling, nearest lines first
+	for (size_t i = 1; i <= m_Margin; i++)
+	{
+		if (firstLine >= i)
+			GetBlob(firstLine - i);
+		if (firstLine + visibleLines - 1 + i < lineCount)
+			GetBlob(firstLine + visibleLines - 1 + i);
+	}
+}
+
+void TextView::Invalidate()
+{
+	for (CachedLine& cached : m_Cache)
+		cached.Line = NO_LINE;
+}
+
+void TextView::IndexLines(size_t from)
+{
+	const char* text = m_Text.data();
+	size_t size = m_Text.size();
+
+	while (from < size)
+	{
+		const char* found = (const char*)memchr(text + from, '\n', size - from);
+		if (!found)
+			break;
+
+		from = found - text + 1;
+		m_LineStarts.push_back(from);
+	}
+}
+
+void TextView::ResizeCache(unsigned int visibleLines)
+{
+	// the visible lines and both margins always fit, so they never evict each other
+	size_t size = visibleLines + 2 * (size_t)m_Margin;
+	if (size == m_Cache.size())
+		return;
+
+	// lines move to other slots, blobs keep their storage for the next layouts
+	m_Cache.resize(size);
+	Invalidate();
+}
+
+Graphics::TextBlob& TextView::GetBlob(size_t line)
+{
+	CachedLine& cached = m_Cache[line % m_Cache.size()];
+	if (cached.Line != line)
+	{
+		std::string_view text = GetLine(line);
+		Graphics::CompileTextBlob(cached.Blob, text.substr(0, m_MaxLineLength), m_Scale);
+		cached.Line = line;
+	}
+
+	return cached.Blob;
+}
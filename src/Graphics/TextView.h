@@ -0,0 +1,101 @@
+#ifndef TEXT_VIEW_H
+#define TEXT_VIEW_H
+
+#include "Graphics.h"
+#include "FileMapping.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Scrollable view of a large text buffer, like a log of millions of lines
+// Line starts are indexed once, then only the visible lines and a margin around them are laid out,
+// each into a TextBlob cached by line, so scrolling only lays out the lines that come into view
+// Frame cost depends on the viewport height, not on the document size
+class TextView
+{
+public:
+	TextView() = default;
+	~TextView();
+
+	TextView(const TextView&) = delete;
+	TextView& operator=(const TextView&) = delete;
+
+	// map a file into memory and index its lines, returns false when it could not be opened
+	bool Open(const std::string& path);
+	// index text owned by the caller, it has to stay alive until the next SetText(), Open() or Close()
+	void SetText(std::string_view text);
+	// continue indexing a caller owned text that grew at its end, like a log being written
+	// * the text has to start with everything already indexed, only the new part is scanned
+	void ExtendText(std::string_view text);
+	// drop the text, and unmap a file from Open()
+	void Close();
+
+	// top left corner and height of the view in pixels, lines below it are not drawn
+	// * lines are cut off by SetMaxLineLength() rather than by a width
+	void SetViewport(float x, float y, float height);
+	// lines laid out ahead beyond the top and bottom of the view, so short scrolls hit the cache
+	void SetMargin(unsigned int lines);
+	// text scale passed on to the font, see Graphics::Print()
+	void SetScale(float scale);
+	// longest line that is laid out, longer lines are cut off
+	void SetMaxLineLength(unsigned int length);
+
+	// scroll so firstLine is at the top of the view, fractions scroll smoothly
+	void ScrollTo(double firstLine);
+	void ScrollBy(double lines);
+	double GetScroll();
+
+	size_t GetLineCount();
+	// text of a line without its line break
+	std::string_view GetLine(size_t line);
+	// lines that fit in the view at the current scale
+	unsigned int GetVisibleLineCount();
+
+	// draw the visible lines with the current Graphics font
+	// * lines partly inside the view are drawn whole
+	void Draw(float red = 1.f, float green = 1.f, float blue = 1.f);
+	// drop every laid out line, needed after LoadFont() replaced the bitmap font
+	// changing the TrueType font or the scale is detected on its own
+	void Invalidate();
+
+private:
+	// laid out line, tagged with the line it holds
+	struct CachedLine
+	{
+		size_t Line = NO_LINE;
+		Graphics::TextBlob Blob;
+	};
+
+	// private helper functions
+	void IndexLines(size_t from);
+	void ResizeCache(unsigned int visibleLines);
+	Graphics::TextBlob& GetBlob(size_t line);
+
+private:
+	static const size_t NO_LINE = (size_t)-1;
+
+	// text and the start offset of every line
+	std::string_view m_Text;
+	std::vector<size_t> m_LineStarts;
+
+	// file mapped by Open()
+	FileMapping m_File;
+
+	// view state
+	float m_X = 0.f, m_Y = 0.f, m_Height = 0.f;
+	float m_Scale = 1.f;
+	unsigned int m_Margin = 16;
+	unsigned int m_MaxLineLength = 1024;
+	double m_Scroll = 0.0;
+
+	// direct mapped line cache, slot = line % size, sized to the visible lines and margins
+	std::vector<CachedLine> m_Cache;
+
+	// font the cache was laid out with
+	int m_Font = -1;
+	float m_FontSize = 0.f;
+	float m_LineHeight = 0.f;
+};
+
+#endif
@@ -1,10 +1,12 @@
 #include "Texture.h"
+#include "Trace.h"
 
 #include <iostream>
 
 Texture::Texture(const char* filepath, bool hasAlpha, int texUnit)
-	: m_ID(0), m_Width(0), m_Height(0), m_NumChannels(0), m_TexUnit(texUnit)
+	: m_ID(0), m_TexUnit(texUnit), m_Width(0), m_Height(0), m_NumChannels(0)
 {
+	TRACE_ZONE("Texture::Load");
 	// create and bind texture 
 	glActiveTexture(GL_TEXTURE0 + m_TexUnit);
 	glGenTextures(1, &m_ID);
@@ -34,6 +36,35 @@ Texture::Texture(const char* filepath, bool hasAlpha, int texUnit)
 	stbi_image_free(data);
 }
 
+Texture::Texture(const unsigned char* data, int width, int height, int numChannels, int texUnit)
+	: m_ID(0), m_TexUnit(texUnit), m_Width(width), m_Height(height), m_NumChannels(numChannels)
+{
+	TRACE_ZONE("Texture::Create");
+	// create and bind texture 
+	glActiveTexture(GL_TEXTURE0 + m_TexUnit);
+	glGenTextures(1, &m_ID);
+	glBindTexture(GL_TEXTURE_2D, m_ID);
+
+	// set texture attributes
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	const GLenum formats[4] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+	const GLenum internalFormats[4] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
+	if (numChannels < 1 || numChannels > 4)
+	{
+		std::cout << "Fatal Error: Unsupported texture channel count: " << numChannels << std::endl;
+		return;
+	}
+
+	// rows are tightly packed, which is not 4 byte aligned for 1 to 3 channels
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormats[numChannels - 1], m_Width, m_Height, 0, formats[numChannels - 1], GL_UNSIGNED_BYTE, data);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
 void Texture::Bind(int texUnit)
 {
 	if (texUnit == -1)
@@ -62,6 +93,20 @@ void Texture::Clean() const
 	glDeleteTextures(1, &m_ID);
 }
 
+void Texture::Resize(int width, int height)
+{
+	m_Width = width;
+	m_Height = height;
+
+	const GLenum formats[4] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+	const GLenum internalFormats[4] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
+	int channels = m_NumChannels < 1 || m_NumChannels > 4 ? 4 : m_NumChannels;
+
+	glActiveTexture(GL_TEXTURE0 + m_TexUnit);
+	glBindTexture(GL_TEXTURE_2D, m_ID);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormats[channels - 1], m_Width, m_Height, 0, formats[channels - 1], GL_UNSIGNED_BYTE, NULL);
+}
+
 unsigned int Texture::GetID()
 {
 	return m_ID;
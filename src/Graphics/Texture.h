@@ -13,11 +13,17 @@ class Texture
 public:
 	Texture() = default;
 	Texture(const char* filepath, bool hasAlpha = false, int texUnit = 0);
+	// create a texture from tightly packed pixel data in memory, with 1 to 4 channels
+	// sampled linearly and clamped at the edges, without mipmaps
+	Texture(const unsigned char* data, int width, int height, int numChannels, int texUnit = 0);
 
 	void Bind(int texUnit = -1);
 	void Unbind();
 	void Clean() const;
 
+	// reallocate the texture at a new size, its contents are undefined afterwards
+	void Resize(int width, int height);
+
 	unsigned int GetID();
 	int GetTexUnit();
 	void SetTexUnit(int texUnit);
@@ -1,15 +1,16 @@
 #include "TextureAtlas.h"
 
-int TextureAtlas::m_AtlasCount = 0;
+int TextureAtlas::m_DefaultAtlasCount = 0;
+thread_local int* TextureAtlas::m_AtlasCount = &TextureAtlas::m_DefaultAtlasCount;
 
 TextureAtlas::TextureAtlas(std::string imagePath, int slotWidth, int slotHeight)
 	: m_AtlasWidth(slotWidth), m_AtlasHeight(slotHeight)
 {
 	// assign this atlas it's ID
-	m_AtlasID = m_AtlasCount;
+	m_AtlasID = GetAtlasCount();
 
-	// increment the static atlas count
-	m_AtlasCount++;
+	// increment the context's atlas count
+	GetAtlasCount()++;
 
 	// create texture
 	m_Texture = Texture(imagePath.c_str(), true, m_AtlasID);
@@ -23,6 +24,32 @@ TextureAtlas::TextureAtlas(std::string imagePath, int slotWidth, int slotHeight)
 	m_CellHeight = m_TextureHeight / m_AtlasHeight;
 }
 
+TextureAtlas::TextureAtlas(const unsigned char* pixels, int textureWidth, int textureHeight, int numChannels, int slotWidth, int slotHeight)
+	: m_AtlasWidth(slotWidth), m_AtlasHeight(slotHeight)
+{
+	// assign this atlas it's ID
+	m_AtlasID = GetAtlasCount();
+
+	// increment the context's atlas count
+	GetAtlasCount()++;
+
+	// create texture
+	m_Texture = Texture(pixels, textureWidth, textureHeight, numChannels, m_AtlasID);
+
+	// copy and store the texture dimentions
+	m_TextureWidth = textureWidth;
+	m_TextureHeight = textureHeight;
+
+	// calculate the individual cell dimentions from texture and atlas dimentions
+	m_CellWidth = m_TextureWidth / m_AtlasWidth;
+	m_CellHeight = m_TextureHeight / m_AtlasHeight;
+}
+
+int& TextureAtlas::GetAtlasCount()
+{
+	return *m_AtlasCount;
+}
+
 glm::vec4 TextureAtlas::GetQuad(unsigned int cellIndex)
 {
 	// Get texture index in the form of a coordinate
@@ -46,6 +73,27 @@ void TextureAtlas::Bind()
 	m_Texture.Bind(m_AtlasID);
 }
 
+void TextureAtlas::Resize(int textureWidth, int textureHeight)
+{
+	m_Texture.Resize(textureWidth, textureHeight);
+
+	m_TextureWidth = textureWidth;
+	m_TextureHeight = textureHeight;
+
+	m_CellWidth = m_TextureWidth / m_AtlasWidth;
+	m_CellHeight = m_TextureHeight / m_AtlasHeight;
+}
+
+void TextureAtlas::SetPremultiplied(bool premultiplied)
+{
+	m_Premultiplied = premultiplied;
+}
+
+bool TextureAtlas::IsPremultiplied()
+{
+	return m_Premultiplied;
+}
+
 glm::vec2 TextureAtlas::GetAtlasDimentions()
 {
 	return glm::vec2(m_AtlasWidth, m_AtlasHeight);
@@ -81,3 +129,7 @@ int TextureAtlas::GetID()
 	return m_AtlasID;
 }
 
+Texture& TextureAtlas::GetTexture()
+{
+	return m_Texture;
+}
@@ -9,8 +9,14 @@
 class TextureAtlas
 {
 public:
-	// static variable holding the total count of atlases, used to assign texture units
-	static int m_AtlasCount;
+	// count of atlases of the Graphics context current on the calling thread, used to assign texture units
+	// points to m_DefaultAtlasCount until a thread makes a context current, see Graphics::MakeCurrent()
+	static thread_local int* m_AtlasCount;
+	static int m_DefaultAtlasCount;
+
+	// the atlas count of the current context, read and written like the single static count of earlier versions
+	// ex: int unit = TextureAtlas::GetAtlasCount()++;
+	static int& GetAtlasCount();
 
 	TextureAtlas() = default;
 
@@ -19,6 +25,10 @@ public:
 	// ex: a 2x3 atlas would have 2 and 3 as dimentions
 	TextureAtlas(std::string imagePath, int atlasWidth = 1, int atlasHeight = 1);
 
+	// create a texture atlas from pixel data in memory, see the matching Texture constructor
+	// textureWidth and textureHeight are in pixels, atlasWidth and atlasHeight in cell units
+	TextureAtlas(const unsigned char* pixels, int textureWidth, int textureHeight, int numChannels, int atlasWidth = 1, int atlasHeight = 1);
+
 	// get texture coordinates and dimentions for a certain atlas cell.
 	// return quad is in (x, y, width, height) format
 	glm::vec4 GetQuad(unsigned int cellIndex = 0);
@@ -27,6 +37,14 @@ public:
 	// the creation of the texture atlas itself calls Texture::Bind()
 	void Bind();
 
+	// reallocate the texture at a new size in pixels, keeping the atlas dimentions and texture unit
+	// * the texture contents are undefined afterwards
+	void Resize(int textureWidth, int textureHeight);
+
+	// mark the texture as holding premultiplied color, like a Layer, so the texture renderer composites it as such
+	void SetPremultiplied(bool premultiplied);
+	bool IsPremultiplied();
+
 public:
 	// gets the texture dimentions in cells
 	glm::vec2 GetAtlasDimentions();
@@ -45,6 +63,9 @@ public:
 	// return the stored ID/texture unit
 	int GetID();
 
+	// return the stored texture
+	Texture& GetTexture();
+
 private:
 	// reference to the actual image texture
 	Texture m_Texture;
@@ -62,6 +83,9 @@ private:
 	// dimentions of the atlas in pixels
 	int m_TextureWidth = 0;
 	int m_TextureHeight = 0;
+
+	// whether the texture color is premultiplied by its alpha
+	bool m_Premultiplied = false;
 };
 
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "TextureRenderer.h"
+#include "Trace.h"
 
 TextureRenderer::TextureRenderer(Shader* shader)
 	: m_Shader(shader)
@@ -13,15 +14,14 @@ TextureRenderer::TextureRenderer(Shader* shader)
 
 	// generate vao and buffers
 	glGenVertexArrays(1, &m_VAO);
-	glGenBuffers(1, &m_VBO);
-	glGenBuffers(1, &m_EBO);
+	m_VertexStream = StreamBuffer(GL_ARRAY_BUFFER);
+	m_IndexStream = StreamBuffer(GL_ELEMENT_ARRAY_BUFFER);
 
 	// bind vao
 	glBindVertexArray(m_VAO);
 
-	// bind and configure vertex buffer
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * m_VertexData.size(), NULL, GL_DYNAMIC_DRAW);
+	// bind and configure vertex buffer, storage is allocated on the first upload
+	glBindBuffer(GL_ARRAY_BUFFER, m_VertexStream.GetID());
 	// screen and texture position
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 8, (void*)(0));
 	// color offset
@@ -32,9 +32,8 @@ TextureRenderer::TextureRenderer(Shader* shader)
 	glEnableVertexAttribArray(1);
 	glEnableVertexAttribArray(2);
 
-	// bind and configure index buffer
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GL_UNSIGNED_INT) * m_IndexData.size(), NULL, GL_DYNAMIC_DRAW);
+	// bind index buffer
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexStream.GetID());
 
 	// unbind vao
 	glBindVertexArray(0);
@@ -63,12 +62,17 @@ TextureRenderer::TextureRenderer(Shader* shader)
 
 	glBindVertexArray(0);
 
-	// specify the texture sampler array with good values
-	// currently only 16 texture units are supported
-	m_Shader->use();
-	auto location = glGetUniformLocation(m_Shader->getID(), "u_Textures");
-	int textures[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
-	glUniform1iv(location, 16, textures);
+	SetSamplers(m_Shader);
+}
+
+void TextureRenderer::SetViews(Shader* viewShader, unsigned int viewCount)
+{
+	// the view shader samples the same texture units
+	if (viewShader && viewShader != m_ViewShader)
+		SetSamplers(viewShader);
+
+	m_ViewShader = viewShader;
+	m_ViewCount = viewShader ? viewCount : 0;
 }
 
 void TextureRenderer::Draw(TextureAtlas* atlas, unsigned int atlasIndex, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
@@ -82,7 +86,7 @@ void TextureRenderer::Draw(TextureAtlas* atlas, unsigned int atlasIndex, float x
 void TextureRenderer::Draw(TextureAtlas* atlas, glm::vec4 calculatedQuad, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
 {
 	// get the textureID to be added to the vertex data
-	float textureID = (float)atlas->GetID();
+	float textureID = (float)(atlas->GetID() + (atlas->IsPremultiplied() ? PREMULTIPLIED_TEXTURE_INDEX : 0));
 
 	// get the texture quad
 	glm::vec4 quad = calculatedQuad;
@@ -162,10 +166,45 @@ void TextureRenderer::Draw(CompiledRenderData& container)
 	}
 }
 
+void TextureRenderer::Draw(CompiledRenderData& container, float offsetX, float offsetY, float red, float green, float blue)
+{
+	// store the previous value of draw count for use in index adding
+	int OriginalDrawCount = m_DrawCount;
+
+	for (unsigned int j = 0; j < container.Count; j++)
+	{
+		// call resize on the vectors if vectors are about to overflow
+		TryToResize(10);
+
+		// store the vertex data, offsetting the position and replacing the color of every vertex
+		const float* source = &container.Vertices[VERTEX_FLOAT_COUNT * j];
+		float* destination = &m_VertexData[m_DrawCount * VERTEX_FLOAT_COUNT];
+		for (int i = 0; i < VERTEX_FLOAT_COUNT; i += 8)
+		{
+			destination[i] = source[i] + offsetX;
+			destination[i + 1] = source[i + 1] + offsetY;
+			destination[i + 2] = source[i + 2];
+			destination[i + 3] = source[i + 3];
+			destination[i + 4] = red;
+			destination[i + 5] = green;
+			destination[i + 6] = blue;
+			destination[i + 7] = source[i + 7];
+		}
+
+		// store the index data
+		for (int i = 0; i < INDEX_UINT_COUNT; i++)
+		{
+			m_IndexData[m_DrawCount * INDEX_UINT_COUNT + i] = container.Indices[i + INDEX_UINT_COUNT * j] + (OriginalDrawCount * VERTICES_PER_QUAD);
+		}
+
+		m_DrawCount++;
+	}
+}
+
 void TextureRenderer::CompileStatic(CompiledRenderData& container, TextureAtlas* atlas, glm::vec4 calculatedQuad, float x, float y, float width, float height, float rotation, float rotationOffsetX, float rotationOffsetY, float red, float green, float blue)
 {
 	// get the textureID to be added to the vertex data
-	float textureID = (float)atlas->GetID();
+	float textureID = (float)(atlas->GetID() + (atlas->IsPremultiplied() ? PREMULTIPLIED_TEXTURE_INDEX : 0));
 
 	// get the texture quad
 	glm::vec4 quad = calculatedQuad;
@@ -256,9 +295,81 @@ void TextureRenderer::LoadStaticData(CompiledRenderData& container)
 }
 
 void TextureRenderer::Render()
+{
+	TRACE_ZONE("TextureRenderer::Render");
+	DrawStatic();
+	Flush();
+}
+
+void TextureRenderer::Flush()
+{
+	if (m_DrawCount == 0)
+		return;
+
+	DrawQuads();
+
+	// clean up vectors
+	ResetVectors();
+}
+
+void TextureRenderer::RenderPass()
+{
+	TRACE_ZONE("TextureRenderer::RenderPass");
+	DrawStatic();
+
+	if (m_DrawCount > 0)
+		DrawQuads();
+}
+
+void TextureRenderer::Clear()
+{
+	ResetVectors();
+}
+
+const float* TextureRenderer::GetQuadData() const
+{
+	return m_VertexData.data();
+}
+
+int TextureRenderer::GetQuadCount() const
+{
+	return m_DrawCount;
+}
+
+void TextureRenderer::SetSamplers(Shader* shader)
+{
+	// specify the texture sampler array with good values
+	// currently only 16 texture units are supported
+	shader->use();
+	auto location = glGetUniformLocation(shader->getID(), "u_Textures");
+	int textures[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+	glUniform1iv(location, 16, textures);
+}
+
+void TextureRenderer::UseShader()
+{
+	if (m_ViewCount > 0)
+		m_ViewShader->use();
+	else
+		m_Shader->use();
+}
+
+void TextureRenderer::SetViewClipping(bool enable)
+{
+	// the view shader clips every view to its viewport with 4 clip distances
+	for (int i = 0; i < 4; i++)
+	{
+		if (enable)
+			glEnable(GL_CLIP_DISTANCE0 + i);
+		else
+			glDisable(GL_CLIP_DISTANCE0 + i);
+	}
+}
+
+void TextureRenderer::DrawStatic()
 {
 	// bind shader
-	m_Shader->use();
+	UseShader();
 
 	// bind static vao
 	glBindVertexArray(m_StaticVAO);
@@ -267,25 +378,51 @@ void TextureRenderer::Render()
 	glBindBuffer(GL_ARRAY_BUFFER, m_StaticVBO);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_StaticEBO);
 
-	// draw static data
-	glDrawElements(GL_TRIANGLES, m_StaticCount * INDEX_UINT_COUNT, GL_UNSIGNED_INT, 0);
+	// draw static data, once per view with multiple views
+	if (m_ViewCount > 0)
+	{
+		SetViewClipping(true);
+		glDrawElementsInstanced(GL_TRIANGLES, m_StaticCount * INDEX_UINT_COUNT, GL_UNSIGNED_INT, 0, m_ViewCount);
+		SetViewClipping(false);
+	}
+	else
+		glDrawElements(GL_TRIANGLES, m_StaticCount * INDEX_UINT_COUNT, GL_UNSIGNED_INT, 0);
+}
+
+void TextureRenderer::DrawQuads()
+{
+	TRACE_ZONE("TextureRenderer::DrawQuads");
+	// bind shader
+	UseShader();
 
 	// bind vao
 	glBindVertexArray(m_VAO);
 
-	// bind and fill vertex buffer
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GL_FLOAT) * VERTEX_FLOAT_COUNT * m_DrawCount, m_VertexData.data());
+	// quads already uploaded by an earlier pass of the same frame are drawn as they are
+	if (m_UploadedCount != m_DrawCount)
+	{
+		// bind and fill vertex buffer, at a whole vertex offset
+		unsigned int vertexSize = sizeof(GL_FLOAT) * VERTEX_FLOAT_COUNT * m_DrawCount;
+		glBindBuffer(GL_ARRAY_BUFFER, m_VertexStream.GetID());
+		m_VertexOffset = m_VertexStream.Upload(m_VertexData.data(), vertexSize, sizeof(GL_FLOAT) * 8);
 
-	// bind and fill index buffer
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(GL_UNSIGNED_INT) * INDEX_UINT_COUNT * m_DrawCount, m_IndexData.data());
+		// fill index buffer, the vao keeps it bound
+		unsigned int indexSize = sizeof(GL_UNSIGNED_INT) * INDEX_UINT_COUNT * m_DrawCount;
+		m_IndexOffset = m_IndexStream.Upload(m_IndexData.data(), indexSize, sizeof(GL_UNSIGNED_INT));
 
-	// issue draw call
-	glDrawElements(GL_TRIANGLES, m_DrawCount * INDEX_UINT_COUNT, GL_UNSIGNED_INT, 0);
+		m_UploadedCount = m_DrawCount;
+	}
 
-	// clean up vectors
-	ResetVectors();
+	// issue draw call, indices start at the first uploaded vertex
+	// with multiple views the quads are uploaded once and drawn as one instance per view
+	if (m_ViewCount > 0)
+	{
+		SetViewClipping(true);
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, m_DrawCount * INDEX_UINT_COUNT, GL_UNSIGNED_INT, (void*)(size_t)m_IndexOffset, m_ViewCount, m_VertexOffset / (sizeof(GL_FLOAT) * 8));
+		SetViewClipping(false);
+	}
+	else
+		glDrawElementsBaseVertex(GL_TRIANGLES, m_DrawCount * INDEX_UINT_COUNT, GL_UNSIGNED_INT, (void*)(size_t)m_IndexOffset, m_VertexOffset / (sizeof(GL_FLOAT) * 8));
 }
 
 void TextureRenderer::ResizeVertexVector(int newSize)
@@ -302,23 +439,18 @@ void TextureRenderer::TryToResize(int changeInSize)
 {
 	if (m_DrawCount >= m_DrawCapacity)
 	{
-		// bind vao
-		glBindVertexArray(m_VAO);
+		// only the growth is traced, this runs for every quad
+		TRACE_ZONE("TextureRenderer::TryToResize");
 
 		// update new m_DrawCapacity
 		m_DrawCapacity += changeInSize;
 
 		// resize by given value * VERTEX_FLOAT_COUNT values, since every quad is VERTEX_FLOAT_COUNT floats
+		// the streams grow on their own when the quads are uploaded
 		ResizeVertexVector(m_DrawCapacity * VERTEX_FLOAT_COUNT);
-		// resize vertex buffer
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * m_DrawCapacity * VERTEX_FLOAT_COUNT, NULL, GL_DYNAMIC_DRAW);
 
 		// resize by given value * INDEX_UINT_COUNT values, since every quad is INDEX_UINT_COUNT uints
 		ResizeIndexVector(m_DrawCapacity * INDEX_UINT_COUNT);
-		// resize index buffer
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GL_UNSIGNED_INT) * m_DrawCapacity * INDEX_UINT_COUNT, NULL, GL_DYNAMIC_DRAW);
 	}
 }
 
@@ -330,4 +462,5 @@ void TextureRenderer::ResetVectors()
 	m_IndexData.clear();
 	m_IndexData.resize(m_DrawCapacity * INDEX_UINT_COUNT);
 	m_DrawCount = 0;
+	m_UploadedCount = -1;
 }
@@ -3,12 +3,15 @@
 
 #include "Shader.h"
 #include "TextureAtlas.h"
+#include "StreamBuffer.h"
 
 #include <vector>
 
 const int VERTEX_FLOAT_COUNT = 32;
 const int INDEX_UINT_COUNT = 6;
 const int VERTICES_PER_QUAD = 4;
+// added to the texture index of quads sampling a premultiplied texture, see TextureAtlas::SetPremultiplied()
+const int PREMULTIPLIED_TEXTURE_INDEX = 16;
 
 
 struct CompiledRenderData
@@ -29,19 +32,21 @@ struct CompiledRenderData
 		Count = count;
 	}
 
-	inline void Add(CompiledRenderData& data)
+	inline void Add(const CompiledRenderData& data)
 	{
+		// counted before growing, data may be this container
 		int oldCount = Count;
-		Count += data.Count;
+		unsigned int addedCount = data.Count;
+		Count += addedCount;
 
 		Vertices.resize(Count * VERTEX_FLOAT_COUNT);
-		for (unsigned int i = 0; i < data.Count * VERTEX_FLOAT_COUNT; i++)
+		for (unsigned int i = 0; i < addedCount * VERTEX_FLOAT_COUNT; i++)
 		{
 			Vertices[oldCount * VERTEX_FLOAT_COUNT + i] = data.Vertices[i];
 		}
 
 		Indices.resize(Count * INDEX_UINT_COUNT);
-		for (unsigned int i = 0; i < data.Count * INDEX_UINT_COUNT; i++)
+		for (unsigned int i = 0; i < addedCount * INDEX_UINT_COUNT; i++)
 		{
 			Indices[oldCount * INDEX_UINT_COUNT + i] = data.Indices[i] + 4 * oldCount;
 		}
@@ -49,7 +54,7 @@ struct CompiledRenderData
 		Capacity = Count;
 	}
 
-	void Set(CompiledRenderData& data, unsigned int start)
+	void Set(const CompiledRenderData& data, unsigned int start)
 	{
 		for (unsigned int i = 0; i < data.Count * VERTEX_FLOAT_COUNT; i++)
 		{
@@ -62,7 +67,8 @@ struct CompiledRenderData
 		}
 	}
 
-	inline CompiledRenderData operator+ (CompiledRenderData b)
+	// + allocates a new container, += appends in place so a reused container keeps its storage
+	inline CompiledRenderData operator+ (const CompiledRenderData& b) const
 	{
 		CompiledRenderData c;
 		c.Add(*(this));
@@ -70,7 +76,7 @@ struct CompiledRenderData
 		return c;
 	}
 
-	inline void operator+= (CompiledRenderData b)
+	inline void operator+= (const CompiledRenderData& b)
 	{
 		this->Add(b);
 	}
@@ -94,6 +100,8 @@ public:
 	void Draw(TextureAtlas* atlas, unsigned int atlasIndex, float x, float y, float width, float height, float rotation = 0.f, float rotationOffsetX = 0.f, float rotationOffsetY = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
 	// adds all compiled draw data to the renderer
 	void Draw(CompiledRenderData& container);
+	// adds all compiled draw data to the renderer, moved by an offset and with its color replaced
+	void Draw(CompiledRenderData& container, float offsetX, float offsetY, float red, float green, float blue);
 	
 	// add image data to a CompiledRenderData to be drawn when loaded
 	void CompileStatic(CompiledRenderData& container, TextureAtlas* atlas, glm::vec4 calculatedQuad, float x, float y, float width, float height, float rotation = 0.f, float rotationOffsetX = 0.f, float rotationOffsetY = 0.f, float red = 1.f, float green = 1.f, float blue = 1.f);
@@ -106,6 +114,25 @@ public:
 
 	// render all added images/quads to the screen
 	void Render();
+	// render only the added images/quads, without the static data
+	// used to draw queued quads early, before a texture they sample is changed
+	void Flush();
+	// render everything like Render(), but keep the added images/quads for another pass
+	// used to draw one frame in several scissored passes, the quads are uploaded only once
+	void RenderPass();
+	// remove the added images/quads without drawing them
+	void Clear();
+
+	// draw every quad once per view with a multi-view shader (TEXTURE_RENDERER_MULTI_VIEW or SDF_TEXT_MULTI_VIEW), see Graphics::SetViews()
+	// pass a view count of 0 to draw with the renderer's own shader again
+	void SetViews(Shader* viewShader, unsigned int viewCount);
+	// enable or disable the 4 clip distances the multi-view shaders clip every view to its viewport with
+	// * only enable them around draws with a multi-view shader, clip distances other shaders don't write are undefined
+	static void SetViewClipping(bool enable);
+
+	// vertex data of the added images/quads, VERTEX_FLOAT_COUNT floats per quad
+	const float* GetQuadData() const;
+	int GetQuadCount() const;
 
 private:
 	// private helper functions
@@ -114,12 +141,19 @@ private:
 	void TryToResize(int changeInSize);
 
 	void ResetVectors();
+	void SetSamplers(Shader* shader);
+	void UseShader();
+	void DrawStatic();
+	void DrawQuads();
 
 private:
 	Shader* m_Shader = nullptr;
+	Shader* m_ViewShader = nullptr;		// shader drawing the quads into every view, see SetViews()
+	unsigned int m_ViewCount = 0;		// views drawn by m_ViewShader, 0 draws once with m_Shader
 
 	// opengl specific members
-	unsigned int m_VAO, m_VBO, m_EBO;
+	unsigned int m_VAO;
+	StreamBuffer m_VertexStream, m_IndexStream;
 	unsigned int m_StaticVAO, m_StaticVBO, m_StaticEBO;
 
 	static const int VERTEX_FLOAT_COUNT = 32;
@@ -134,6 +168,9 @@ private:
 
 	int m_DrawCount = 0;
 	int m_DrawCapacity = 0;
+	int m_UploadedCount = -1;	// quads in the buffers since the last reset, -1 when not uploaded
+	unsigned int m_VertexOffset = 0;	// byte offsets of the uploaded quads in the streams
+	unsigned int m_IndexOffset = 0;
 
 	int m_StaticCount = 0;
 	int m_StaticCapacity = 0;
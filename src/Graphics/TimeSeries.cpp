@@ -0,0 +1,166 @@
+#include "TimeSeries.h"
+
+#include <algorithm>
+
+TimeSeries::TimeSeries()
+{
+	// generate vao and buffer
+	glGenVertexArrays(1, &m_VAO);
+	glGenBuffers(1, &m_VBO);
+
+	glBindVertexArray(m_VAO);
+
+	// positions only, the color attribute is left disabled and set once per draw
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GL_FLOAT) * 2, (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glBindVertexArray(0);
+}
+
+void TimeSeries::SetSamples(const float* x, const float* y, unsigned int count)
+{
+	Clear();
+	Append(x, y, count);
+}
+
+void TimeSeries::Append(const float* x, const float* y, unsigned int count)
+{
+	m_X.insert(m_X.end(), x, x + count);
+	m_Y.insert(m_Y.end(), y, y + count);
+}
+
+void TimeSeries::Clear()
+{
+	m_X.clear();
+	m_Y.clear();
+
+	// force a full decimation on the next draw
+	m_PixelWidth = 0;
+}
+
+void TimeSeries::Decimate(float viewLeft, float viewRight, unsigned int pixelWidth)
+{
+	if (viewLeft != m_ViewLeft || viewRight != m_ViewRight || pixelWidth != m_PixelWidth)
+		ResetView(viewLeft, viewRight, pixelWidth);
+
+	// columns per unit of x
+	float scale = pixelWidth / (viewRight - viewLeft);
+	unsigned int count = (unsigned int)m_X.size();
+
+	// only samples added since the last call need to be processed
+	for (unsigned int i = m_Processed; i < count; i++)
+	{
+		if (m_X[i] > viewRight)
+		{	// samples are ascending, nothing after this one is visible
+			// only the first sample past the edge is kept, later appends leave the vertices as they are
+			if (m_After == NO_SAMPLE)
+			{
+				m_After = i;
+				m_Dirty = true;
+			}
+			m_Processed = count;
+			break;
+		}
+
+		unsigned int columnIndex = (unsigned int)((m_X[i] - viewLeft) * scale);
+		if (columnIndex >= pixelWidth)
+			columnIndex = pixelWidth - 1;
+
+		Column& column = m_Columns[columnIndex];
+		if (column.First == NO_SAMPLE)
+		{
+			column = { i, i, i, i };
+		}
+		else
+		{
+			if (m_Y[i] < m_Y[column.Min])
+				column.Min = i;
+			if (m_Y[i] > m_Y[column.Max])
+				column.Max = i;
+			column.Last = i;
+		}
+
+		m_Processed = i + 1;
+		m_Dirty = true;
+	}
+
+	if (m_Dirty)
+		BuildVertices();
+}
+
+void TimeSeries::Bind()
+{
+	glBindVertexArray(m_VAO);
+}
+
+void TimeSeries::Clean() const
+{
+	glDeleteVertexArrays(1, &m_VAO);
+	glDeleteBuffers(1, &m_VBO);
+}
+
+unsigned int TimeSeries::GetSampleCount()
+{
+	return (unsigned int)m_X.size();
+}
+
+unsigned int TimeSeries::GetVertexCount()
+{
+	return (unsigned int)m_Vertices.size() / 2;
+}
+
+void TimeSeries::ResetView(float viewLeft, float viewRight, unsigned int pixelWidth)
+{
+	m_ViewLeft = viewLeft;
+	m_ViewRight = viewRight;
+	m_PixelWidth = pixelWidth;
+
+	m_Columns.assign(pixelWidth, { NO_SAMPLE, NO_SAMPLE, NO_SAMPLE, NO_SAMPLE });
+
+	// skip every sample left of the view
+	m_Processed = (unsigned int)(std::lower_bound(m_X.begin(), m_X.end(), viewLeft) - m_X.begin());
+	m_Before = m_Processed > 0 ? m_Processed - 1 : NO_SAMPLE;
+	m_After = NO_SAMPLE;
+	m_Dirty = true;
+}
+
+void TimeSeries::BuildVertices()
+{
+	m_Vertices.clear();
+
+	unsigned int lastIndex = NO_SAMPLE;
+	auto addSample = [this, &lastIndex](unsigned int index)
+	{
+		// a column often has the same sample as first, min, max or last
+		if (index == lastIndex)
+			return;
+		m_Vertices.push_back(m_X[index]);
+		m_Vertices.push_back(m_Y[index]);
+		lastIndex = index;
+	};
+
+	if (m_Before != NO_SAMPLE)
+		addSample(m_Before);
+
+	for (const Column& column : m_Columns)
+	{
+		if (column.First == NO_SAMPLE)
+			continue;
+
+		// keep the extremes in the order they happened
+		addSample(column.First);
+		addSample(column.Min < column.Max ? column.Min : column.Max);
+		addSample(column.Min < column.Max ? column.Max : column.Min);
+		addSample(column.Last);
+	}
+
+	if (m_After != NO_SAMPLE)
+		addSample(m_After);
+
+	// bind and fill vertex buffer
+	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GL_FLOAT) * m_Vertices.size(), m_Vertices.data(), GL_DYNAMIC_DRAW);
+
+	m_Dirty = false;
+}
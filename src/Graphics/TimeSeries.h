@@ -0,0 +1,76 @@
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+#include "Shader.h"
+
+#include <vector>
+
+// Line chart of a sample series, decimated per pixel column before it is drawn
+// Every pixel column keeps its first, lowest, highest and last sample, which draws the same as the full series
+// Drawn through Graphics::Draw() as a single line strip
+class TimeSeries
+{
+public:
+	TimeSeries();
+
+	// replace all samples, x values must be ascending
+	void SetSamples(const float* x, const float* y, unsigned int count);
+	// add samples to the end of the series, x values must keep ascending
+	// * only the new samples are decimated as long as the view doesn't change
+	void Append(const float* x, const float* y, unsigned int count);
+	// remove all samples
+	void Clear();
+
+	// decimate the series for a view spanning viewLeft to viewRight over pixelWidth columns
+	// and upload the result, does nothing when neither the view nor the samples changed
+	void Decimate(float viewLeft, float viewRight, unsigned int pixelWidth);
+
+	// bind the series vao
+	void Bind();
+	// delete the series buffers
+	void Clean() const;
+
+	// sample count of the whole series
+	unsigned int GetSampleCount();
+	// vertex count of the decimated line strip
+	unsigned int GetVertexCount();
+
+private:
+	// decimated samples of one pixel column, as sample indices
+	struct Column
+	{
+		unsigned int First;
+		unsigned int Min;
+		unsigned int Max;
+		unsigned int Last;
+	};
+
+	// private helper functions
+	void ResetView(float viewLeft, float viewRight, unsigned int pixelWidth);
+	void BuildVertices();
+
+private:
+	static const unsigned int NO_SAMPLE = 0xFFFFFFFF;
+
+	// opengl specific members
+	unsigned int m_VAO = 0, m_VBO = 0;
+
+	// data storage members
+	std::vector<float> m_X;
+	std::vector<float> m_Y;
+	std::vector<Column> m_Columns;
+	std::vector<float> m_Vertices;
+
+	// view the columns were decimated for
+	float m_ViewLeft = 0.f;
+	float m_ViewRight = 0.f;
+	unsigned int m_PixelWidth = 0;
+
+	// decimation state
+	unsigned int m_Processed = 0;			// samples before this index are already in the columns
+	unsigned int m_Before = NO_SAMPLE;		// last sample left of the view, keeps the line running off the edge
+	unsigned int m_After = NO_SAMPLE;		// first sample right of the view
+	bool m_Dirty = true;					// vertices need to be rebuilt
+};
+
+#endif
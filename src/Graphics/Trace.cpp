@@ -0,0 +1,198 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+	// a recorded zone, instant events like frame boundaries have no duration
+	struct TraceEvent
+	{
+		const char* Name = nullptr;
+		uint64_t Start = 0;
+		uint64_t End = 0;
+		bool Instant = false;
+	};
+
+	// ring slot of an event, atomic so Write() can copy slots while their thread overwrites them
+	struct TraceSlot
+	{
+		std::atomic<const char*> Name{ nullptr };
+		std::atomic<uint64_t> Start{ 0 };
+		std::atomic<uint64_t> End{ 0 };
+		std::atomic<bool> Instant{ false };
+	};
+
+	// ring of events written only by its own thread
+	// the write count is published after the event, so a reader sees whole events up to it
+	struct ThreadBuffer
+	{
+		std::unique_ptr<TraceSlot[]> Events;
+		uint64_t Capacity = 0;
+		std::atomic<uint64_t> WriteCount{ 0 };
+		std::atomic<uint64_t> ClearCount{ 0 };	// events before this count were cleared
+		unsigned int ThreadIndex = 0;
+	};
+
+	// buffers outlive their threads, so events of finished threads can still be written
+	std::mutex BuffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+	unsigned int BufferSize = 1 << 16;
+
+	thread_local ThreadBuffer* CurrentBuffer = nullptr;
+
+	ThreadBuffer* GetThreadBuffer()
+	{
+		if (CurrentBuffer)
+			return CurrentBuffer;
+
+		// first event of the thread, the only time recording takes a lock
+		std::lock_guard<std::mutex> lock(BuffersMutex);
+		std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+		buffer->Events.reset(new TraceSlot[BufferSize]);
+		buffer->Capacity = BufferSize;
+		buffer->ThreadIndex = (unsigned int)Buffers.size() + 1;
+		CurrentBuffer = buffer.get();
+		Buffers.push_back(std::move(buffer));
+		return CurrentBuffer;
+	}
+
+	void Push(const char* name, uint64_t start, uint64_t end, bool instant)
+	{
+		ThreadBuffer* buffer = GetThreadBuffer();
+		uint64_t index = buffer->WriteCount.load(std::memory_order_relaxed);
+
+		// a reader seeing any part of this event also sees the count published before it, see Trace::Write()
+		std::atomic_thread_fence(std::memory_order_release);
+
+		TraceSlot& slot = buffer->Events[index % buffer->Capacity];
+		slot.Name.store(name, std::memory_order_relaxed);
+		slot.Start.store(start, std::memory_order_relaxed);
+		slot.End.store(end, std::memory_order_relaxed);
+		slot.Instant.store(instant, std::memory_order_relaxed);
+
+		buffer->WriteCount.store(index + 1, std::memory_order_release);
+	}
+
+	// names are string literals, only quotes and backslashes need escaping
+	void WriteName(std::ofstream& file, const char* name)
+	{
+		for (const char* c = name; *c; c++)
+		{
+			if (*c == '"' || *c == '\\')
+				file << '\\';
+			file << *c;
+		}
+	}
+
+}
+
+std::atomic<bool> Trace::m_Enabled(false);
+
+void Trace::SetEnabled(bool enabled)
+{
+	m_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Trace::SetBufferSize(unsigned int eventCount)
+{
+	std::lock_guard<std::mutex> lock(BuffersMutex);
+	BufferSize = eventCount > 0 ? eventCount : 1;
+}
+
+void Trace::Record(const char* name, uint64_t start, uint64_t end)
+{
+	Push(name, start, end, false);
+}
+
+void Trace::Frame()
+{
+	if (!m_Enabled.load(std::memory_order_relaxed))
+		return;
+
+	uint64_t now = Now();
+	Push("Frame", now, now, true);
+}
+
+uint64_t Trace::Now()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool Trace::Write(const std::string& path)
+{
+	std::ofstream file(path, std::ios::out | std::ios::trunc);
+	if (!file)
+		return false;
+
+	std::lock_guard<std::mutex> lock(BuffersMutex);
+
+	// timestamps are in microseconds, relative to the first event so they stay readable
+	uint64_t origin = UINT64_MAX;
+	std::vector<std::vector<TraceEvent>> snapshots(Buffers.size());
+	for (size_t i = 0; i < Buffers.size(); i++)
+	{
+		ThreadBuffer& buffer = *Buffers[i];
+		uint64_t capacity = buffer.Capacity;
+		uint64_t end = buffer.WriteCount.load(std::memory_order_acquire);
+		uint64_t begin = end > capacity ? end - capacity : 0;
+		begin = std::max(begin, buffer.ClearCount.load(std::memory_order_relaxed));
+
+		std::vector<TraceEvent>& snapshot = snapshots[i];
+		for (uint64_t index = begin; index < end; index++)
+		{
+			const TraceSlot& slot = buffer.Events[index % capacity];
+			TraceEvent event;
+			event.Name = slot.Name.load(std::memory_order_relaxed);
+			event.Start = slot.Start.load(std::memory_order_relaxed);
+			event.End = slot.End.load(std::memory_order_relaxed);
+			event.Instant = slot.Instant.load(std::memory_order_relaxed);
+			snapshot.push_back(event);
+		}
+
+		// the thread may have lapped the copy, the events it overwrote meanwhile are dropped
+		// the event at the count may be half written, and its slot holds the event a whole ring before it
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64_t after = buffer.WriteCount.load(std::memory_order_relaxed);
+		uint64_t overwritten = after + 1 > capacity ? after + 1 - capacity : 0;
+		if (overwritten > begin)
+			snapshot.erase(snapshot.begin(), snapshot.begin() + (size_t)std::min(overwritten - begin, (uint64_t)snapshot.size()));
+
+		for (const TraceEvent& event : snapshot)
+			origin = std::min(origin, event.Start);
+	}
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"traceEvents\":[\n";
+	bool first = true;
+	for (size_t i = 0; i < snapshots.size(); i++)
+	{
+		unsigned int thread = Buffers[i]->ThreadIndex;
+		for (const TraceEvent& event : snapshots[i])
+		{
+			file << (first ? "" : ",\n") << "{\"name\":\"";
+			WriteName(file, event.Name);
+			file << "\",\"pid\":1,\"tid\":" << thread << ",\"ts\":" << (event.Start - origin) / 1000.0;
+			if (event.Instant)
+				file << ",\"ph\":\"i\",\"s\":\"g\"}";
+			else
+				file << ",\"ph\":\"X\",\"dur\":" << (event.End - event.Start) / 1000.0 << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+
+	return (bool)file;
+}
+
+void Trace::Clear()
+{
+	std::lock_guard<std::mutex> lock(BuffersMutex);
+	for (std::unique_ptr<ThreadBuffer>& buffer : Buffers)
+		buffer->ClearCount.store(buffer->WriteCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
@@ -0,0 +1,76 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped CPU trace zones, recorded into a ring buffer per thread and written out as Chrome trace event JSON
+// The JSON loads in chrome://tracing and in the Perfetto UI
+// Zones are only compiled in with GRAPHICS_TRACE defined, and only recorded while tracing is enabled at runtime
+// ex: void Update() { TRACE_ZONE("Update"); ... }
+#ifdef GRAPHICS_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// time the rest of the enclosing scope, name has to be a string literal
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+// mark the end of a frame
+#define TRACE_FRAME() Trace::Frame()
+#else
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_FRAME() ((void)0)
+#endif
+
+class Trace
+{
+public:
+	// start or stop recording, zones cost a single relaxed load while stopped
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled() { return m_Enabled.load(std::memory_order_relaxed); }
+
+	// set the number of events every thread keeps, older events are overwritten
+	// * only applies to threads recording their first event afterwards
+	static void SetBufferSize(unsigned int eventCount);
+
+	// record a finished zone on the calling thread, times are from Now()
+	static void Record(const char* name, uint64_t start, uint64_t end);
+	// record a frame boundary on the calling thread
+	static void Frame();
+
+	// current time in nanoseconds, from a steady clock
+	static uint64_t Now();
+
+	// write the events of every thread as Chrome trace event JSON, returns false when the file can't be written
+	// * threads keep recording while the file is written, events overwritten meanwhile are left out
+	static bool Write(const std::string& path);
+	// forget every recorded event
+	static void Clear();
+
+private:
+	static std::atomic<bool> m_Enabled;
+};
+
+// zone timing its own lifetime, see TRACE_ZONE()
+class TraceZone
+{
+public:
+	TraceZone(const char* name)
+		: m_Name(Trace::IsEnabled() ? name : nullptr), m_Start(m_Name ? Trace::Now() : 0)
+	{
+	}
+
+	~TraceZone()
+	{
+		if (m_Name)
+			Trace::Record(m_Name, m_Start, Trace::Now());
+	}
+
+	TraceZone(const TraceZone&) = delete;
+	TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+	const char* m_Name;
+	uint64_t m_Start;
+};
+
+#endif
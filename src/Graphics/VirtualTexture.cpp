@@ -0,0 +1,533 @@
+#include "VirtualTexture.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+	// file header, followed by the tiles of every level from level 0, each level in rows from the top
+	struct TileFileHeader
+	{
+		char Magic[4] = { 'G', 'V', 'T', 'X' };
+		unsigned int Version = 1;
+		int Width = 0;
+		int Height = 0;
+		int TileSize = 0;
+		int LevelCount = 0;
+	};
+
+	// pixels on each side of a tile copied from its neighbours, so linear filtering never bleeds into the next cache cell
+	const int TILE_BORDER = 1;
+
+	int CeilDivide(int value, int divisor)
+	{
+		return (value + divisor - 1) / divisor;
+	}
+
+	// level count of a pyramid halving the image until it fits a single tile
+	int PyramidLevels(int width, int height, int tileSize)
+	{
+		int levels = 1;
+		while (width > tileSize || height > tileSize)
+		{
+			width = (width + 1) / 2;
+			height = (height + 1) / 2;
+			levels++;
+		}
+		return levels;
+	}
+
+}
+
+VirtualTexture::~VirtualTexture()
+{
+	StopWorkers();
+}
+
+bool VirtualTexture::Build(const std::string& imagePath, const std::string& tilePath, int tileSize)
+{
+	int width = 0, height = 0, channels = 0;
+	unsigned char* pixels = stbi_load(imagePath.c_str(), &width, &height, &channels, 4);
+	if (!pixels)
+	{
+		std::cout << "Error: Failed to load image for virtual texture: " << imagePath << std::endl;
+		return false;
+	}
+
+	bool built = Build(pixels, width, height, 4, tilePath, tileSize);
+	stbi_image_free(pixels);
+	return built;
+}
+
+bool VirtualTexture::Build(const unsigned char* pixels, int width, int height, int channels, const std::string& tilePath, int tileSize)
+{
+	if (!pixels || width <= 0 || height <= 0 || channels < 1 || channels > 4 || tileSize <= 0)
+		return false;
+
+	std::ofstream file(tilePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cout << "Error: Failed to create virtual texture file: " << tilePath << std::endl;
+		return false;
+	}
+
+	TileFileHeader header;
+	header.Width = width;
+	header.Height = height;
+	header.TileSize = tileSize;
+	header.LevelCount = PyramidLevels(width, height, tileSize);
+	file.write((const char*)&header, sizeof(header));
+
+	// expand to RGBA8, single channel images are gray
+	std::vector<uint32_t> level((size_t)width * height);
+	for (size_t i = 0; i < level.size(); i++)
+	{
+		const unsigned char* pixel = pixels + i * channels;
+		unsigned char rgba[4] = { pixel[0], pixel[0], pixel[0], 255 };
+		if (channels == 2)
+			rgba[3] = pixel[1];
+		else if (channels >= 3)
+		{
+			rgba[1] = pixel[1];
+			rgba[2] = pixel[2];
+			if (channels == 4)
+				rgba[3] = pixel[3];
+		}
+		memcpy(&level[i], rgba, 4);
+	}
+
+	int cell = tileSize + TILE_BORDER * 2;
+	std::vector<uint32_t> tile((size_t)cell * cell);
+	int levelWidth = width, levelHeight = height;
+
+	for (int l = 0; l < header.LevelCount; l++)
+	{
+		// tiles with their border, pixels past the level's edge repeat the edge
+		for (int tileY = 0; tileY < CeilDivide(levelHeight, tileSize); tileY++)
+		{
+			for (int tileX = 0; tileX < CeilDivide(levelWidth, tileSize); tileX++)
+			{
+				for (int row = 0; row < cell; row++)
+				{
+					int sourceY = std::clamp(tileY * tileSize + row - TILE_BORDER, 0, levelHeight - 1);
+					for (int column = 0; column < cell; column++)
+					{
+						int sourceX = std::clamp(tileX * tileSize + column - TILE_BORDER, 0, levelWidth - 1);
+						tile[(size_t)row * cell + column] = level[(size_t)sourceY * levelWidth + sourceX];
+					}
+				}
+				file.write((const char*)tile.data(), tile.size() * sizeof(uint32_t));
+			}
+		}
+
+		if (l + 1 == header.LevelCount)
+			break;
+
+		// box filter down to the next level, a pixel of the next level covers 2 x 2 pixels of this one
+		int nextWidth = (levelWidth + 1) / 2, nextHeight = (levelHeight + 1) / 2;
+		std::vector<uint32_t> next((size_t)nextWidth * nextHeight);
+		for (int y = 0; y < nextHeight; y++)
+		{
+			int y0 = y * 2, y1 = std::min(y * 2 + 1, levelHeight - 1);
+			for (int x = 0; x < nextWidth; x++)
+			{
+				int x0 = x * 2, x1 = std::min(x * 2 + 1, levelWidth - 1);
+				const unsigned char* a = (const unsigned char*)&level[(size_t)y0 * levelWidth + x0];
+				const unsigned char* b = (const unsigned char*)&level[(size_t)y0 * levelWidth + x1];
+				const unsigned char* c = (const unsigned char*)&level[(size_t)y1 * levelWidth + x0];
+				const unsigned char* d = (const unsigned char*)&level[(size_t)y1 * levelWidth + x1];
+
+				unsigned char average[4];
+				for (int i = 0; i < 4; i++)
+					average[i] = (unsigned char)((a[i] + b[i] + c[i] + d[i] + 2) / 4);
+				memcpy(&next[(size_t)y * nextWidth + x], average, 4);
+			}
+		}
+
+		level.swap(next);
+		levelWidth = nextWidth;
+		levelHeight = nextHeight;
+	}
+
+	if (!file)
+	{
+		std::cout << "Error: Failed to write virtual texture file: " << tilePath << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool VirtualTexture::Open(const std::string& tilePath, int cacheSize, unsigned int threadCount)
+{
+	if (m_LevelCount > 0)
+		Clean();
+
+	std::ifstream file(tilePath, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		std::cout << "Error: Failed to open virtual texture file: " << tilePath << std::endl;
+		return false;
+	}
+	size_t fileSize = (size_t)file.tellg();
+	file.seekg(0);
+
+	TileFileHeader header, expected;
+	file.read((char*)&header, sizeof(header));
+	if (!file || memcmp(header.Magic, expected.Magic, sizeof(header.Magic)) != 0 || header.Version != expected.Version
+		|| header.Width <= 0 || header.Height <= 0 || header.TileSize <= 0 || header.LevelCount != PyramidLevels(header.Width, header.Height, header.TileSize))
+	{
+		std::cout << "Error: Not a virtual texture file: " << tilePath << std::endl;
+		return false;
+	}
+
+	m_Path = tilePath;
+	m_Width = header.Width;
+	m_Height = header.Height;
+	m_TileSize = header.TileSize;
+
+	// tile grid and file offset of every level
+	int cell = m_TileSize + TILE_BORDER * 2;
+	size_t tileBytes = (size_t)cell * cell * 4;
+	size_t offset = sizeof(header);
+	m_TilesX.clear();
+	m_TilesY.clear();
+	m_LevelOffsets.clear();
+	for (int l = 0; l < header.LevelCount; l++)
+	{
+		m_TilesX.push_back(CeilDivide(LevelSize(m_Width, l), m_TileSize));
+		m_TilesY.push_back(CeilDivide(LevelSize(m_Height, l), m_TileSize));
+		m_LevelOffsets.push_back(offset);
+		offset += (size_t)m_TilesX.back() * m_TilesY.back() * tileBytes;
+	}
+	if (fileSize < offset)
+	{
+		std::cout << "Error: Virtual texture file is truncated: " << tilePath << std::endl;
+		return false;
+	}
+	m_LevelCount = header.LevelCount;
+
+	// empty cache, every cell holds a tile and its border
+	m_CacheSize = cacheSize > 1 ? cacheSize : 2;
+	m_Cache = TextureAtlas(nullptr, cell * m_CacheSize, cell * m_CacheSize, 4, m_CacheSize, m_CacheSize);
+	m_Slots.assign((size_t)m_CacheSize * m_CacheSize, Slot());
+	m_Resident.clear();
+	m_DrawCount = 0;
+
+	// the coarsest level is cached for good, it is what missing tiles fall back to
+	uint64_t rootKey = TileKey(m_LevelCount - 1, 0, 0);
+	std::vector<unsigned char> root(tileBytes);
+	file.seekg(TileOffset(m_LevelCount - 1, 0, 0));
+	file.read((char*)root.data(), root.size());
+	int rootSlot = AcquireSlot(rootKey);
+	UploadTile(rootSlot, root.data());
+
+	m_Stopping = false;
+	for (unsigned int i = 0; i < (threadCount > 0 ? threadCount : 1); i++)
+		m_Workers.emplace_back(&VirtualTexture::WorkerLoop, this);
+
+	return true;
+}
+
+void VirtualTexture::Draw(TextureRenderer* renderer, float x, float y, float width, float height, glm::vec4 view, unsigned int pixelWidth, float red, float green, float blue)
+{
+	TRACE_ZONE("VirtualTexture::Draw");
+	if (m_LevelCount == 0 || width <= 0.f || height <= 0.f || view.z <= 0.f || view.w <= 0.f || pixelWidth == 0)
+		return;
+
+	m_DrawCount++;
+	UploadTiles();
+
+	m_X = x;
+	m_Y = y;
+	m_DrawWidth = width;
+	m_DrawHeight = height;
+	m_Color[0] = red;
+	m_Color[1] = green;
+	m_Color[2] = blue;
+
+	// level whose pixels are closest in size to a screen pixel
+	float texelsPerPixel = (m_Width / width) * (view.z / pixelWidth);
+	int level = texelsPerPixel > 1.f ? (int)floorf(log2f(texelsPerPixel) + 0.5f) : 0;
+	level = std::min(level, m_LevelCount - 1);
+
+	// visible part of the image, in 0 to 1 image coordinates
+	float left = x - width / 2, top = y - height / 2;
+	float u0 = std::max(0.f, (view.x - left) / width);
+	float v0 = std::max(0.f, (view.y - top) / height);
+	float u1 = std::min(1.f, (view.x + view.z - left) / width);
+	float v1 = std::min(1.f, (view.y + view.w - top) / height);
+	if (u0 >= u1 || v0 >= v1)
+		return;
+
+	// extent of a tile of the level in image coordinates
+	float spanU = (float)m_TileSize * (1 << level) / m_Width;
+	float spanV = (float)m_TileSize * (1 << level) / m_Height;
+	int firstX = (int)(u0 / spanU), lastX = std::min((int)(u1 / spanU), m_TilesX[level] - 1);
+	int firstY = (int)(v0 / spanV), lastY = std::min((int)(v1 / spanV), m_TilesY[level] - 1);
+	float centerU = (u0 + u1) / 2, centerV = (v0 + v1) / 2;
+
+	m_Missing.clear();
+	for (int tileY = firstY; tileY <= lastY; tileY++)
+	{
+		for (int tileX = firstX; tileX <= lastX; tileX++)
+		{
+			float tileU0 = tileX * spanU, tileU1 = std::min(1.f, (tileX + 1) * spanU);
+			float tileV0 = tileY * spanV, tileV1 = std::min(1.f, (tileY + 1) * spanV);
+
+			uint64_t key = TileKey(level, tileX, tileY);
+			std::unordered_map<uint64_t, int>::iterator found = m_Resident.find(key);
+			if (found != m_Resident.end())
+			{
+				DrawRegion(renderer, found->second, level, tileX, tileY, tileU0, tileV0, tileU1, tileV1);
+				continue;
+			}
+
+			float du = (tileU0 + tileU1) / 2 - centerU, dv = (tileV0 + tileV1) / 2 - centerV;
+			m_Missing.push_back(std::make_pair(du * du + dv * dv, key));
+
+			// stand in with the same region of the closest cached coarser tile, the coarsest level is always cached
+			for (int coarser = level + 1; coarser < m_LevelCount; coarser++)
+			{
+				int shift = coarser - level;
+				found = m_Resident.find(TileKey(coarser, tileX >> shift, tileY >> shift));
+				if (found != m_Resident.end())
+				{
+					DrawRegion(renderer, found->second, coarser, tileX >> shift, tileY >> shift, tileU0, tileV0, tileU1, tileV1);
+					break;
+				}
+			}
+		}
+	}
+
+	if (m_Missing.empty())
+		return;
+	std::sort(m_Missing.begin(), m_Missing.end());
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		// requests no worker got to are for an older view, only the current one is loaded
+		for (uint64_t key : m_Requests)
+			m_Pending.erase(key);
+		m_Requests.clear();
+
+		for (const std::pair<float, uint64_t>& missing : m_Missing)
+		{
+			if (m_Requests.size() >= m_Slots.size())
+				break;
+			if (m_Pending.insert(missing.second).second)
+				m_Requests.push_back(missing.second);
+		}
+	}
+	m_Condition.notify_all();
+}
+
+void VirtualTexture::SetUploadLimit(unsigned int tiles)
+{
+	m_UploadLimit = tiles;
+}
+
+void VirtualTexture::Clean()
+{
+	StopWorkers();
+
+	if (m_LevelCount > 0)
+		m_Cache.GetTexture().Clean();
+
+	m_Slots.clear();
+	m_Resident.clear();
+	m_LevelCount = 0;
+}
+
+int VirtualTexture::GetWidth()
+{
+	return m_Width;
+}
+
+int VirtualTexture::GetHeight()
+{
+	return m_Height;
+}
+
+int VirtualTexture::GetLevelCount()
+{
+	return m_LevelCount;
+}
+
+unsigned int VirtualTexture::GetPendingCount()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return (unsigned int)m_Pending.size();
+}
+
+uint64_t VirtualTexture::TileKey(int level, int tileX, int tileY)
+{
+	return ((uint64_t)level << 48) | ((uint64_t)tileY << 24) | (uint64_t)tileX;
+}
+
+size_t VirtualTexture::TileOffset(int level, int tileX, int tileY)
+{
+	size_t cell = m_TileSize + TILE_BORDER * 2;
+	return m_LevelOffsets[level] + ((size_t)tileY * m_TilesX[level] + tileX) * cell * cell * 4;
+}
+
+int VirtualTexture::LevelSize(int size, int level)
+{
+	return ((size - 1) >> level) + 1;
+}
+
+void VirtualTexture::UploadTiles()
+{
+	std::vector<std::unique_ptr<LoadedTile>> uploads;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		while (!m_Finished.empty() && uploads.size() < m_UploadLimit)
+		{
+			uploads.push_back(std::move(m_Finished.back()));
+			m_Finished.pop_back();
+		}
+	}
+	if (uploads.empty())
+		return;
+
+	for (std::unique_ptr<LoadedTile>& tile : uploads)
+	{
+		// with every slot in view the tile is dropped, it is requested again while it is still visible
+		int slot = AcquireSlot(tile->Key);
+		if (slot >= 0)
+			UploadTile(slot, tile->Pixels.data());
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (std::unique_ptr<LoadedTile>& tile : uploads)
+	{
+		m_Pending.erase(tile->Key);
+		m_FreeTiles.push_back(std::move(tile));
+	}
+}
+
+void VirtualTexture::UploadTile(int slot, const unsigned char* pixels)
+{
+	int cell = m_TileSize + TILE_BORDER * 2;
+	m_Cache.Bind();
+	glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % m_CacheSize) * cell, (slot / m_CacheSize) * cell, cell, cell, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+int VirtualTexture::AcquireSlot(uint64_t key)
+{
+	uint64_t rootKey = TileKey(m_LevelCount - 1, 0, 0);
+
+	// a free slot, otherwise the least recently drawn one that wasn't drawn by this or the last Draw()
+	int best = -1;
+	for (int i = 0; i < (int)m_Slots.size(); i++)
+	{
+		const Slot& slot = m_Slots[i];
+		if (!slot.Used)
+		{
+			best = i;
+			break;
+		}
+
+		if (slot.Key != rootKey && slot.LastDrawn + 1 < m_DrawCount && (best < 0 || slot.LastDrawn < m_Slots[best].LastDrawn))
+			best = i;
+	}
+	if (best < 0)
+		return -1;
+
+	Slot& slot = m_Slots[best];
+	if (slot.Used)
+		m_Resident.erase(slot.Key);
+
+	slot.Key = key;
+	slot.Used = true;
+	slot.LastDrawn = m_DrawCount;
+	m_Resident[key] = best;
+	return best;
+}
+
+void VirtualTexture::DrawRegion(TextureRenderer* renderer, int slot, int level, int tileX, int tileY, float u0, float v0, float u1, float v1)
+{
+	m_Slots[slot].LastDrawn = m_DrawCount;
+
+	// region in pixels of the tile's level, relative to the tile
+	float scale = (float)(1 << level);
+	float x0 = u0 * m_Width / scale - tileX * m_TileSize, x1 = u1 * m_Width / scale - tileX * m_TileSize;
+	float y0 = v0 * m_Height / scale - tileY * m_TileSize, y1 = v1 * m_Height / scale - tileY * m_TileSize;
+
+	int cell = m_TileSize + TILE_BORDER * 2;
+	glm::vec4 quad(
+		(slot % m_CacheSize) * cell + TILE_BORDER + x0,
+		(slot / m_CacheSize) * cell + TILE_BORDER + y0,
+		x1 - x0, y1 - y0
+	);
+
+	float left = m_X - m_DrawWidth / 2 + u0 * m_DrawWidth, right = m_X - m_DrawWidth / 2 + u1 * m_DrawWidth;
+	float top = m_Y - m_DrawHeight / 2 + v0 * m_DrawHeight, bottom = m_Y - m_DrawHeight / 2 + v1 * m_DrawHeight;
+	renderer->Draw(&m_Cache, quad, (left + right) / 2, (top + bottom) / 2, right - left, bottom - top, 0.f, 0.f, 0.f, m_Color[0], m_Color[1], m_Color[2]);
+}
+
+void VirtualTexture::WorkerLoop()
+{
+	// every worker reads through its own stream, so reads never wait on each other
+	std::ifstream file(m_Path, std::ios::binary);
+	size_t cell = m_TileSize + TILE_BORDER * 2;
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true)
+	{
+		m_Condition.wait(lock, [this]() { return m_Stopping || !m_Requests.empty(); });
+		if (m_Stopping)
+			return;
+
+		uint64_t key = m_Requests.front();
+		m_Requests.pop_front();
+
+		std::unique_ptr<LoadedTile> tile;
+		if (!m_FreeTiles.empty())
+		{
+			tile = std::move(m_FreeTiles.back());
+			m_FreeTiles.pop_back();
+		}
+		else
+			tile.reset(new LoadedTile());
+
+		// the read runs unlocked, so Draw() keeps queueing and uploading meanwhile
+		lock.unlock();
+		tile->Key = key;
+		tile->Pixels.resize(cell * cell * 4);
+		file.seekg(TileOffset((int)(key >> 48), (int)(key & 0xFFFFFF), (int)((key >> 24) & 0xFFFFFF)));
+		file.read((char*)tile->Pixels.data(), tile->Pixels.size());
+		bool read = (bool)file;
+		file.clear();
+		lock.lock();
+
+		if (read)
+			m_Finished.push_back(std::move(tile));
+		else
+		{
+			m_Pending.erase(key);
+			m_FreeTiles.push_back(std::move(tile));
+		}
+	}
+}
+
+void VirtualTexture::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_Condition.notify_all();
+
+	for (std::thread& worker : m_Workers)
+		worker.join();
+	m_Workers.clear();
+
+	// nothing loaded is uploaded anymore
+	m_Requests.clear();
+	m_Pending.clear();
+	m_Finished.clear();
+}
@@ -0,0 +1,129 @@
+#ifndef VIRTUAL_TEXTURE_H
+#define VIRTUAL_TEXTURE_H
+
+#include "TextureRenderer.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Image far larger than a single texture, like a gigapixel map or scan, split into square tiles with a mip pyramid
+// Only the tiles covering the view at the level matching the zoom are kept on the GPU, in a cache texture of fixed size
+// Tiles are read from a tile file on worker threads (see Build()) and uploaded a few per Draw(), least recently drawn tiles are replaced first
+// A tile still loading is drawn from the closest coarser level that is cached, so panning and zooming never show holes
+// * the coarsest level is a single tile, loaded by Open() and always cached
+class VirtualTexture
+{
+public:
+	VirtualTexture() = default;
+	// stops the worker threads, see Clean() to delete the cache texture
+	~VirtualTexture();
+
+	VirtualTexture(const VirtualTexture&) = delete;
+	VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+	// split an image into a tile file holding every level of its mip pyramid, returns false when the image can't be read or the file written
+	// tileSize is the width and height of a tile in pixels, tiles are stored as RGBA8 with a 1 pixel border for filtering
+	// * the whole image is held in memory while building, build very large files offline
+	static bool Build(const std::string& imagePath, const std::string& tilePath, int tileSize = 256);
+	// pixels have 1 to 4 channels with rows from the top
+	static bool Build(const unsigned char* pixels, int width, int height, int channels, const std::string& tilePath, int tileSize = 256);
+
+	// open a tile file, creating a cache texture of cacheSize x cacheSize tiles
+	// the cache needs about (1.5 * screen width / tileSize + 1) x (1.5 * screen height / tileSize + 1) tiles to hold a whole view
+	// threadCount is the number of threads reading tiles from the file
+	// * claims a texture unit for the cache texture, like any TextureAtlas
+	bool Open(const std::string& tilePath, int cacheSize = 12, unsigned int threadCount = 2);
+
+	// draw the part of the image inside the view, centered at (x, y) like other images
+	// view is the visible rect of top left origin in the same units, (x, y, width, height), pixelWidth its width on screen in pixels
+	// * uploads finished tiles first, then queues the visible tiles that are missing, nearest to the view center first
+	void Draw(TextureRenderer* renderer, float x, float y, float width, float height, glm::vec4 view, unsigned int pixelWidth, float red = 1.f, float green = 1.f, float blue = 1.f);
+
+	// set how many finished tiles Draw() uploads at most, to bound the upload cost of a frame
+	void SetUploadLimit(unsigned int tiles);
+
+	// stop the worker threads and delete the cache texture
+	void Clean();
+
+	// image dimentions in pixels at level 0
+	int GetWidth();
+	int GetHeight();
+	int GetLevelCount();
+	// number of tiles queued or being read
+	unsigned int GetPendingCount();
+
+private:
+	// a tile read by a worker, waiting to be uploaded
+	struct LoadedTile
+	{
+		uint64_t Key = 0;
+		std::vector<unsigned char> Pixels;
+	};
+
+	// a cell of the cache texture
+	struct Slot
+	{
+		uint64_t Key = 0;
+		bool Used = false;
+		unsigned long long LastDrawn = 0;
+	};
+
+	// private helper functions
+	static uint64_t TileKey(int level, int tileX, int tileY);
+	// offset of a tile in the tile file, in bytes
+	size_t TileOffset(int level, int tileX, int tileY);
+	// width or height of a level in pixels
+	int LevelSize(int size, int level);
+
+	// copy finished tiles into the cache texture
+	void UploadTiles();
+	void UploadTile(int slot, const unsigned char* pixels);
+	// place a tile into a free or the least recently drawn slot, returns -1 when every slot is drawn this frame
+	int AcquireSlot(uint64_t key);
+	// draw the part (u0, v0, u1, v1) of the image, in 0 to 1 image coordinates, from a cached tile
+	void DrawRegion(TextureRenderer* renderer, int slot, int level, int tileX, int tileY, float u0, float v0, float u1, float v1);
+
+	void WorkerLoop();
+	void StopWorkers();
+
+private:
+	std::string m_Path;
+	int m_Width = 0, m_Height = 0;
+	int m_TileSize = 256;
+	int m_LevelCount = 0;
+	std::vector<int> m_TilesX, m_TilesY;	// tile grid of every level
+	std::vector<size_t> m_LevelOffsets;		// offset of the first tile of every level in the tile file
+
+	// cache texture, cells are a tile and its border
+	TextureAtlas m_Cache;
+	int m_CacheSize = 0;
+	std::vector<Slot> m_Slots;
+	std::unordered_map<uint64_t, int> m_Resident;	// slots by tile key
+	unsigned long long m_DrawCount = 0;
+	unsigned int m_UploadLimit = 8;
+	std::vector<std::pair<float, uint64_t>> m_Missing;	// visible tiles that aren't cached, by distance to the view center
+
+	// draw state of the image placement, set by Draw()
+	float m_X = 0.f, m_Y = 0.f, m_DrawWidth = 0.f, m_DrawHeight = 0.f;
+	float m_Color[3] = { 1.f, 1.f, 1.f };
+
+	// worker threads, keys move from m_Requests to the workers and on to m_Finished, and stay in m_Pending until uploaded
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::deque<uint64_t> m_Requests;
+	std::unordered_set<uint64_t> m_Pending;
+	std::vector<std::unique_ptr<LoadedTile>> m_Finished;
+	std::vector<std::unique_ptr<LoadedTile>> m_FreeTiles;
+	bool m_Stopping = false;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "Tests.h"
+#include "Capture.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+static const char* CAPTURE_PATH = "CaptureRoundTrip.gcap";
+static const int RECORDED_FRAMES = 3;
+
+// a frame of shapes, an image drawn directly and a container of an image that is never drawn directly
+// * clearing is not recorded, so frames are drawn over each other both times
+static void DrawFrame(TextureAtlas& image, CompiledRenderData& container)
+{
+	Graphics::Rectangle(Graphics::FILL, 10.f, 10.f, 100.f, 60.f, 0.3f, 0.f, 0.f, 0.8f, 0.2f, 0.2f);
+	Graphics::Circle(Graphics::LINE, 180.f, 60.f, 40.f, 0.9f, 0.8f, 0.1f, 32);
+	Graphics::AnalyticRoundedRectangle(Graphics::FILL, 130.f, 110.f, 60.f, 30.f, 8.f, 0.f, 0.f, 0.f, 0.5f, 0.2f, 0.8f);
+	Graphics::Draw(&image, 0, 60.f, 180.f, 64.f, 64.f, 0.4f);
+	Graphics::Draw(container);
+
+	Graphics::Render();
+}
+
+// record frames, replay them on the same context and expect the same pixels, frame count and texture unit count
+// recorded images are mid grey, so replay's blank stand-ins draw exactly like them
+bool RunCaptureRoundTrip(TestContext& context)
+{
+	std::vector<unsigned char> grey(4 * 4 * 4, 128);
+	TextureAtlas image(grey.data(), 4, 4, 4);
+	TextureAtlas containerImage(grey.data(), 4, 4, 4);
+
+	CompiledRenderData container;
+	Graphics::CompileStaticDrawData(container, &containerImage, 0, 190.f, 200.f, 80.f, 40.f);
+
+	glClearColor(0.1f, 0.1f, 0.1f, 1.f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	if (!Graphics::StartCapture(CAPTURE_PATH))
+		return false;
+	for (int frame = 0; frame < RECORDED_FRAMES; frame++)
+		DrawFrame(image, container);
+	Graphics::StopCapture();
+
+	std::vector<uint32_t> recorded;
+	context.ReadPixels(recorded);
+
+	// the container's unit has no texture left, so it only draws grey when replay moves it onto a stand-in
+	containerImage.GetTexture().Clean();
+	image.GetTexture().Clean();
+
+	int atlasCount = TextureAtlas::GetAtlasCount();
+	std::vector<CaptureFrameTime> frames;
+	glClear(GL_COLOR_BUFFER_BIT);
+	bool replayed = Capture::Replay(CAPTURE_PATH, frames);
+	std::remove(CAPTURE_PATH);
+
+	std::vector<uint32_t> replayedPixels;
+	context.ReadPixels(replayedPixels);
+
+	// alpha is left out like in RendererCompare, rgb has to match exactly
+	size_t mismatched = 0;
+	for (size_t i = 0; i < recorded.size(); i++)
+	{
+		if ((recorded[i] & 0x00ffffff) != (replayedPixels[i] & 0x00ffffff))
+			mismatched++;
+	}
+
+	std::cout << "  replayed " << frames.size() << " of " << RECORDED_FRAMES << " frames, " << mismatched << " pixels differ, texture units " << atlasCount << " before and " << TextureAtlas::GetAtlasCount() << " after" << std::endl;
+	return replayed && frames.size() == RECORDED_FRAMES && mismatched == 0 && TextureAtlas::GetAtlasCount() == atlasCount;
+}
@@ -0,0 +1,173 @@
+#include "Tests.h"
+#include "FontMetrics.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+// texture names checked for leaks, far more than the checks ever create
+static const unsigned int TEXTURE_NAMES = 512;
+static const int FRAMES = 3;
+
+static const char* FONT_IMAGE_PATH = "Contexts.ppm";
+static const char* FONT_DATA_PATH = "Contexts.font";
+static const int FONT_CELL_SIZE = 8;
+
+// textures alive in the current GL context
+static int CountTextures()
+{
+	int count = 0;
+	for (unsigned int name = 1; name < TEXTURE_NAMES; name++)
+		count += glIsTexture(name) ? 1 : 0;
+	return count;
+}
+
+// a 2 x 2 cell bitmap font of white squares, written as a binary PPM image and binary font data
+static bool WriteFont()
+{
+	int size = FONT_CELL_SIZE * 2;
+	std::ofstream image(FONT_IMAGE_PATH, std::ios::binary);
+	image << "P6\n" << size << " " << size << "\n255\n" << std::string((size_t)size * size * 3, (char)255);
+	image.close();
+
+	FontMetrics metrics;
+	metrics.ImageWidth = size;
+	metrics.ImageHeight = size;
+	metrics.CellWidth = FONT_CELL_SIZE;
+	metrics.CellHeight = FONT_CELL_SIZE;
+	metrics.StartChar = 'A';
+	for (int i = 0; i < 4; i++)
+		metrics.Widths['A' + i] = FONT_CELL_SIZE;
+
+	return !image.fail() && metrics.Save(FONT_DATA_PATH);
+}
+
+static void DrawScene(TextureAtlas& image)
+{
+	Graphics::Rectangle(Graphics::FILL, 10.f, 10.f, 100.f, 60.f, 0.f, 0.f, 0.f, 0.8f, 0.2f, 0.2f);
+	Graphics::Circle(Graphics::FILL, 190.f, 60.f, 40.f, 0.9f, 0.8f, 0.1f, 32);
+	Graphics::AnalyticCircle(Graphics::FILL, 180.f, 180.f, 35.f, 1.f, 0.5f, 0.f);
+	Graphics::Draw(&image, 0, 40.f, 150.f, 64.f, 64.f, 0.3f);
+}
+
+static void RenderScene(TextureAtlas& image)
+{
+	glClearColor(0.1f, 0.1f, 0.1f, 1.f);
+	for (int frame = 0; frame < FRAMES; frame++)
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
+		DrawScene(image);
+		Graphics::Render();
+	}
+}
+
+// a new context counts its own texture units from 0, and destroying it deletes its font texture
+static bool CheckOwnState(TestContext& context, unsigned char* pixels)
+{
+	if (!WriteFont())
+	{
+		std::cout << "  couldn't write the font to " << FONT_IMAGE_PATH << " and " << FONT_DATA_PATH << std::endl;
+		return false;
+	}
+
+	int defaultCount = TextureAtlas::GetAtlasCount();
+	int texturesBefore = CountTextures();
+	int texturesInside = 0;
+	int firstUnit = -1;
+	int ownCount = -1;
+	bool loaded = false;
+
+	{
+		Graphics::Context own;
+		Graphics::MakeCurrent(&own);
+		Graphics::Init(context.ShapeShader, context.RenderShader);
+		firstUnit = TextureAtlas::GetAtlasCount();
+
+		loaded = Graphics::LoadFont(FONT_IMAGE_PATH, FONT_DATA_PATH);
+		Graphics::Print("ABBA", 10.f, 10.f);
+		Graphics::Render();
+		TextureAtlas image(pixels, 4, 4, 4);
+		ownCount = TextureAtlas::GetAtlasCount();
+		image.GetTexture().Clean();
+		texturesInside = CountTextures();
+	}
+
+	int texturesAfter = CountTextures();
+	std::remove(FONT_IMAGE_PATH);
+	std::remove(FONT_DATA_PATH);
+	bool current = Graphics::GetCurrentContext() == nullptr;
+
+	std::cout << "  new context: font " << (loaded ? "loaded" : "not loaded") << ", first unit " << firstUnit << ", units after an atlas " << ownCount << ", default context units "
+		<< defaultCount << " before and " << TextureAtlas::GetAtlasCount() << " after" << std::endl;
+	std::cout << "  textures " << texturesBefore << " before the context, " << texturesInside << " in it and " << texturesAfter << " after it" << std::endl;
+	return loaded && firstUnit == 0 && ownCount > firstUnit && TextureAtlas::GetAtlasCount() == defaultCount
+		&& texturesInside > texturesBefore && texturesAfter == texturesBefore && current;
+}
+
+// a context on its own thread and GL context renders the same frames as the default context, at the same time
+static bool CheckParallel(TestContext& context, unsigned char* pixels)
+{
+#ifdef GRAPHICS_HEADLESS_EGL
+	bool created = false;
+	std::vector<uint32_t> threadPixels;
+	std::thread worker([&]()
+	{
+		TestContext threadContext;
+		{
+			Graphics::Context own;
+			Graphics::MakeCurrent(&own);
+			created = threadContext.Create(context.GetWidth(), context.GetHeight());
+			if (created)
+			{
+				TextureAtlas image(pixels, 4, 4, 4);
+				RenderScene(image);
+				threadContext.ReadPixels(threadPixels);
+				image.GetTexture().Clean();
+			}
+		}
+		threadContext.Destroy();
+	});
+
+	TextureAtlas image(pixels, 4, 4, 4);
+	RenderScene(image);
+	std::vector<uint32_t> mainPixels;
+	context.ReadPixels(mainPixels);
+	image.GetTexture().Clean();
+
+	worker.join();
+	if (!created)
+	{
+		std::cout << "  couldn't create a GL context on the thread" << std::endl;
+		return false;
+	}
+
+	int mismatched = 0;
+	for (size_t i = 0; i < mainPixels.size(); i++)
+		mismatched += mainPixels[i] != threadPixels[i] ? 1 : 0;
+
+	std::cout << "  rendered on two threads at once: " << mismatched << " of " << mainPixels.size() << " pixels differ" << std::endl;
+	return mismatched == 0;
+#else
+	// GLFW creates windows on the main thread only
+	std::cout << "  parallel rendering is only checked with GRAPHICS_HEADLESS_EGL" << std::endl;
+	return true;
+#endif
+}
+
+bool RunContexts(TestContext& context)
+{
+	// half transparent red pixels, so the image blends over the shapes
+	unsigned char pixels[4 * 4 * 4];
+	for (int i = 0; i < 4 * 4; i++)
+	{
+		pixels[i * 4] = 255;
+		pixels[i * 4 + 1] = 0;
+		pixels[i * 4 + 2] = 0;
+		pixels[i * 4 + 3] = 128;
+	}
+
+	bool passed = CheckOwnState(context, pixels);
+	passed &= CheckParallel(context, pixels);
+	return passed;
+}
@@ -0,0 +1,75 @@
+#include "Tests.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+static const int VALUE_COUNT = 200000;
+static const int MAX_PRECISION = 4;
+
+// values over many magnitudes, with both signs
+static std::vector<double> MakeValues()
+{
+	std::vector<double> values(VALUE_COUNT);
+	double magnitude = 0.001;
+	for (int i = 0; i < VALUE_COUNT; i++)
+	{
+		values[i] = (i % 2 ? -1.0 : 1.0) * magnitude * (1.0 + i % 997 / 997.0);
+		magnitude = magnitude > 1e9 ? 0.001 : magnitude * 1.37;
+	}
+	return values;
+}
+
+// time formatting every value at every precision, sum keeps the formatting from being optimized away
+template<typename Format>
+static double NanosecondsPerNumber(const std::vector<double>& values, Format format, size_t& sum)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int precision = 0; precision <= MAX_PRECISION; precision++)
+	{
+		for (double value : values)
+			sum += format(value, precision).size();
+	}
+	double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	return elapsed / (values.size() * (MAX_PRECISION + 1));
+}
+
+// compare FormatNumber() at a precision against printf, then time it against formatting 6 digits and truncating
+bool RunFormatBenchmark(TestContext& context)
+{
+	std::vector<double> values = MakeValues();
+
+	char buffer[320];
+	char expected[320];
+	size_t mismatched = 0;
+	for (int precision = 0; precision <= MAX_PRECISION; precision++)
+	{
+		for (double value : values)
+		{
+			std::string_view text = Graphics::FormatNumber(buffer, sizeof(buffer), value, precision);
+			snprintf(expected, sizeof(expected), "%.*f", precision, value);
+			if (text != expected)
+				mismatched++;
+		}
+	}
+
+	size_t sum = 0;
+	double direct = NanosecondsPerNumber(values, [&buffer](double value, int precision)
+	{
+		return Graphics::FormatNumber(buffer, sizeof(buffer), value, precision);
+	}, sum);
+	double truncated = NanosecondsPerNumber(values, [&buffer](double value, int precision)
+	{
+		std::string_view text = Graphics::FormatNumber(buffer, sizeof(buffer), value);
+		Graphics::TruncateDigits(text, precision);
+		return text;
+	}, sum);
+	double printed = NanosecondsPerNumber(values, [&buffer](double value, int precision)
+	{
+		return std::string_view(buffer, snprintf(buffer, sizeof(buffer), "%.*f", precision, value));
+	}, sum);
+
+	std::cout << "  " << mismatched << " numbers differ from printf (checksum " << sum << ")" << std::endl;
+	std::cout << "  ns per number: to precision " << direct << ", 6 digits truncated " << truncated << ", snprintf " << printed << std::endl;
+	return mismatched == 0;
+}
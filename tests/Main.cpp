@@ -0,0 +1,48 @@
+#include "Tests.h"
+
+#include <cstring>
+#include <iostream>
+
+struct TestEntry
+{
+	const char* Name;
+	bool (*Run)(TestContext& context);
+};
+
+static const TestEntry TESTS[] = {
+	{ "CaptureRoundTrip", RunCaptureRoundTrip },
+	{ "Contexts", RunContexts },
+	{ "FormatBenchmark", RunFormatBenchmark },
+	{ "MultiView", RunMultiView },
+	{ "RendererCompare", RunRendererCompare },
+	{ "TraceExport", RunTraceExport },
+	{ "VirtualTextures", RunVirtualTextures },
+	{ "ZeroAllocations", RunZeroAllocations },
+};
+
+// runs every check, or only the ones named on the command line, and exits with the number of failed checks
+int main(int argc, char** argv)
+{
+	TestContext context;
+	if (!context.Create(256, 256))
+		return 1;
+
+	int failed = 0;
+	for (const TestEntry& test : TESTS)
+	{
+		bool selected = argc < 2;
+		for (int i = 1; i < argc; i++)
+			selected |= strcmp(argv[i], test.Name) == 0;
+		if (!selected)
+			continue;
+
+		std::cout << test.Name << std::endl;
+		bool passed = test.Run(context);
+		std::cout << test.Name << (passed ? ": passed" : ": FAILED") << std::endl;
+		if (!passed)
+			failed++;
+	}
+
+	context.Destroy();
+	return failed;
+}
@@ -0,0 +1,107 @@
+#include "Tests.h"
+
+#include <cstdlib>
+#include <iostream>
+
+static const int VIEW_COUNT = 2;
+static const int FRAMES = 3;
+// a channel off by more than this is a mismatch, clip distances and the viewport cut a primitive on slightly different edges
+static const int CHANNEL_TOLERANCE = 16;
+// share of mismatched pixels allowed, at the view edges
+static const double MISMATCH_LIMIT = 0.01;
+
+static void DrawScene(TextureAtlas& image)
+{
+	Graphics::Rectangle(Graphics::FILL, 10.f, 10.f, 100.f, 60.f, 0.f, 0.f, 0.f, 0.8f, 0.2f, 0.2f);
+	Graphics::Rectangle(Graphics::FILL, 60.f, 40.f, 80.f, 80.f, 0.5f, 40.f, 40.f, 0.2f, 0.6f, 0.9f);
+	Graphics::Circle(Graphics::FILL, 190.f, 60.f, 40.f, 0.9f, 0.8f, 0.1f, 32);
+
+	float triangle[] = { 20.f, 240.f, 70.f, 150.f, 120.f, 240.f };
+	Graphics::Polygon(Graphics::FILL, triangle, 3, 0.3f, 0.9f, 0.4f);
+
+	Graphics::AnalyticCircle(Graphics::FILL, 180.f, 180.f, 35.f, 1.f, 0.5f, 0.f);
+	Graphics::AnalyticRing(180.f, 180.f, 50.f, 6.f, 0.9f, 0.9f, 0.9f);
+
+	Graphics::Draw(&image, 0, 90.f, 200.f, 64.f, 64.f);
+}
+
+// draw the scene into every view with one multi-view Render(), and again one view at a time with its own viewport and projection
+bool RunMultiView(TestContext& context)
+{
+	int width = context.GetWidth(), height = context.GetHeight();
+
+	// the whole scene squeezed into the left half, and its center magnified into the right half
+	glm::mat4 viewProjections[VIEW_COUNT] = {
+		glm::ortho(0.f, (float)width, (float)height, 0.f),
+		glm::ortho(width / 4.f, width * 3 / 4.f, height * 3 / 4.f, height / 4.f),
+	};
+	glm::vec4 viewports[VIEW_COUNT] = {
+		glm::vec4(0.f, 0.f, width / 2.f, (float)height),
+		glm::vec4(width / 2.f, 0.f, width / 2.f, (float)height),
+	};
+
+	// a context of its own, so the multi-view state doesn't leak into other checks
+	Shader shapeViewShader(SHAPE_MULTI_VIEW);
+	Shader renderViewShader(TEXTURE_RENDERER_MULTI_VIEW);
+	Shader analyticViewShader(ANALYTIC_SHAPE_MULTI_VIEW);
+	std::vector<uint32_t> viewPixels, singlePixels;
+	{
+		Graphics::Context own;
+		Graphics::MakeCurrent(&own);
+		Graphics::Init(context.ShapeShader, context.RenderShader);
+		Graphics::InitAnalyticShapes(context.AnalyticShader);
+		Graphics::InitMultiView(&shapeViewShader, &renderViewShader, &analyticViewShader);
+
+		std::vector<unsigned char> imagePixels(16 * 16 * 4);
+		for (int i = 0; i < 16 * 16; i++)
+		{
+			imagePixels[i * 4] = (unsigned char)(i * 7);
+			imagePixels[i * 4 + 1] = (unsigned char)(255 - i);
+			imagePixels[i * 4 + 2] = 128;
+			imagePixels[i * 4 + 3] = (i / 16) % 2 ? 255 : 160;
+		}
+		TextureAtlas image(imagePixels.data(), 16, 16, 4);
+
+		glClearColor(0.1f, 0.1f, 0.1f, 1.f);
+		Graphics::SetViews(viewProjections, viewports, VIEW_COUNT, width, height);
+		for (int frame = 0; frame < FRAMES; frame++)
+		{
+			glClear(GL_COLOR_BUFFER_BIT);
+			DrawScene(image);
+			Graphics::Render();
+		}
+		Graphics::SetViews(nullptr, nullptr, 0, width, height);
+		context.ReadPixels(viewPixels);
+
+		glClear(GL_COLOR_BUFFER_BIT);
+		for (int view = 0; view < VIEW_COUNT; view++)
+		{
+			glViewport((int)viewports[view].x, (int)viewports[view].y, (int)viewports[view].z, (int)viewports[view].w);
+			context.Matrices->SetData(&viewProjections[view][0][0]);
+			DrawScene(image);
+			Graphics::Render();
+		}
+		context.ReadPixels(singlePixels);
+
+		glm::mat4 viewProjection = context.GetViewProjection();
+		context.Matrices->SetData(&viewProjection[0][0]);
+		glViewport(0, 0, width, height);
+		image.GetTexture().Clean();
+	}
+
+	int mismatched = 0, largest = 0;
+	for (size_t i = 0; i < viewPixels.size(); i++)
+	{
+		int difference = 0;
+		for (int shift = 0; shift < 32; shift += 8)
+			difference = std::max(difference, abs((int)((viewPixels[i] >> shift) & 0xFF) - (int)((singlePixels[i] >> shift) & 0xFF)));
+		largest = std::max(largest, difference);
+		if (difference > CHANNEL_TOLERANCE)
+			mismatched++;
+	}
+
+	double share = (double)mismatched / viewPixels.size();
+	std::cout << "  " << VIEW_COUNT << " views against single view renders: " << mismatched << " of " << viewPixels.size() << " pixels mismatched ("
+		<< share * 100.0 << "%), largest channel difference " << largest << std::endl;
+	return share <= MISMATCH_LIMIT;
+}
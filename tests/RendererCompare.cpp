@@ -0,0 +1,154 @@
+#include "Tests.h"
+#include "SoftwareRenderer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// a channel off by more than this is a mismatch, edge coverage is computed differently by the two backends
+static const int CHANNEL_TOLERANCE = 16;
+// share of mismatched pixels allowed, edges and line rasterization rules differ by a pixel here and there
+static const double MISMATCH_LIMIT = 0.01;
+
+static const int BENCHMARK_FRAMES = 50;
+static const int BENCHMARK_SHAPES = 2000;
+
+// shapes, analytic shapes and translucent images overlapping each other, drawn by both backends
+static void DrawScene(TextureAtlas& image)
+{
+	Graphics::Rectangle(Graphics::FILL, 10.f, 10.f, 100.f, 60.f, 0.f, 0.f, 0.f, 0.8f, 0.2f, 0.2f);
+	Graphics::Rectangle(Graphics::FILL, 60.f, 40.f, 80.f, 80.f, 0.5f, 40.f, 40.f, 0.2f, 0.6f, 0.9f);
+	Graphics::Circle(Graphics::FILL, 190.f, 60.f, 40.f, 0.9f, 0.8f, 0.1f, 32);
+
+	float triangle[] = { 20.f, 240.f, 70.f, 150.f, 120.f, 240.f };
+	Graphics::Polygon(Graphics::FILL, triangle, 3, 0.3f, 0.9f, 0.4f);
+
+	Graphics::AnalyticCircle(Graphics::FILL, 180.f, 180.f, 35.f, 1.f, 0.5f, 0.f);
+	Graphics::AnalyticRing(180.f, 180.f, 50.f, 6.f, 0.9f, 0.9f, 0.9f);
+	Graphics::AnalyticRoundedRectangle(Graphics::FILL, 130.f, 110.f, 60.f, 30.f, 8.f, 0.3f, 0.f, 0.f, 0.5f, 0.2f, 0.8f);
+	Graphics::AnalyticCapsule(Graphics::FILL, 20.f, 130.f, 110.f, 110.f, 6.f, 0.1f, 0.7f, 0.7f);
+
+	Graphics::Draw(&image, 0, 90.f, 200.f, 64.f, 64.f);
+	Graphics::Draw(&image, 0, 230.f, 230.f, 32.f, 32.f, 0.7f);
+}
+
+// many small shapes all over the target, for timing
+static void DrawBenchmarkScene(TextureAtlas& image, int width, int height)
+{
+	srand(1);
+	for (int i = 0; i < BENCHMARK_SHAPES; i++)
+	{
+		float x = (float)(rand() % width);
+		float y = (float)(rand() % height);
+		float red = (rand() % 256) / 255.f, green = (rand() % 256) / 255.f, blue = (rand() % 256) / 255.f;
+
+		switch (i % 4)
+		{
+		case 0: Graphics::Rectangle(Graphics::FILL, x, y, 12.f, 8.f, 0.f, 0.f, 0.f, red, green, blue); break;
+		case 1: Graphics::Circle(Graphics::FILL, x, y, 6.f, red, green, blue); break;
+		case 2: Graphics::AnalyticCircle(Graphics::FILL, x, y, 6.f, red, green, blue); break;
+		case 3: Graphics::Draw(&image, 0, x, y, 12.f, 12.f); break;
+		}
+	}
+}
+
+// 16 x 16 gradient with alpha falling off to the right
+static std::vector<unsigned char> MakeImage()
+{
+	std::vector<unsigned char> pixels(16 * 16 * 4);
+	for (int y = 0; y < 16; y++)
+	{
+		for (int x = 0; x < 16; x++)
+		{
+			unsigned char* pixel = &pixels[((size_t)y * 16 + x) * 4];
+			pixel[0] = (unsigned char)(x * 16);
+			pixel[1] = (unsigned char)(y * 16);
+			pixel[2] = 160;
+			pixel[3] = (unsigned char)(255 - x * 12);
+		}
+	}
+	return pixels;
+}
+
+static double Milliseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool RunRendererCompare(TestContext& context)
+{
+	int width = context.GetWidth();
+	int height = context.GetHeight();
+
+	std::vector<unsigned char> imagePixels = MakeImage();
+	TextureAtlas image(imagePixels.data(), 16, 16, 4);
+
+	SoftwareRenderer software;
+	std::vector<uint32_t> softwarePixels((size_t)width * height);
+	software.SetTarget(softwarePixels.data(), width, height);
+	software.SetViewProjection(context.GetViewProjection());
+	software.SetTexture(&image, imagePixels.data(), 4);
+
+	// gl
+	glClearColor(0.1f, 0.1f, 0.1f, 1.f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	DrawScene(image);
+	Graphics::Render();
+
+	std::vector<uint32_t> glPixels;
+	context.ReadPixels(glPixels);
+
+	// software
+	Graphics::SetSoftwareRenderer(&software);
+	software.Clear(0.1f, 0.1f, 0.1f, 1.f);
+	DrawScene(image);
+	Graphics::Render();
+	Graphics::SetSoftwareRenderer(nullptr);
+
+	// alpha is left out, the two backends don't have to agree on what ends up in the target's alpha
+	size_t mismatched = 0;
+	int maxDifference = 0;
+	for (size_t i = 0; i < glPixels.size(); i++)
+	{
+		const unsigned char* a = (const unsigned char*)&glPixels[i];
+		const unsigned char* b = (const unsigned char*)&softwarePixels[i];
+
+		int difference = 0;
+		for (int channel = 0; channel < 3; channel++)
+			difference = std::max(difference, abs(a[channel] - b[channel]));
+
+		maxDifference = std::max(maxDifference, difference);
+		if (difference > CHANNEL_TOLERANCE)
+			mismatched++;
+	}
+
+	double mismatchShare = (double)mismatched / glPixels.size();
+	std::cout << "  mismatched pixels: " << mismatched << " of " << glPixels.size() << " (" << mismatchShare * 100.0 << "%), largest channel difference " << maxDifference << std::endl;
+
+	// timing, glFinish() keeps the GPU's work inside the measured frame
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < BENCHMARK_FRAMES; frame++)
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
+		DrawBenchmarkScene(image, width, height);
+		Graphics::Render();
+		glFinish();
+	}
+	double glTime = Milliseconds(start) / BENCHMARK_FRAMES;
+
+	Graphics::SetSoftwareRenderer(&software);
+	start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < BENCHMARK_FRAMES; frame++)
+	{
+		software.Clear(0.1f, 0.1f, 0.1f, 1.f);
+		DrawBenchmarkScene(image, width, height);
+		Graphics::Render();
+	}
+	double softwareTime = Milliseconds(start) / BENCHMARK_FRAMES;
+	Graphics::SetSoftwareRenderer(nullptr);
+
+	std::cout << "  " << BENCHMARK_SHAPES << " shapes per frame: gl " << glTime << " ms, software " << softwareTime << " ms" << std::endl;
+
+	image.GetTexture().Clean();
+	return mismatchShare <= MISMATCH_LIMIT;
+}
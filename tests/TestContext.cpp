@@ -0,0 +1,117 @@
+#include "TestContext.h"
+
+#ifndef GRAPHICS_HEADLESS_EGL
+#include <GLFW/glfw3.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+
+bool TestContext::Create(int width, int height)
+{
+#ifdef GRAPHICS_HEADLESS_EGL
+	if (!m_Context.Create())
+		return false;
+#else
+	// the window is never shown, it only carries the context
+	if (!glfwInit())
+	{
+		std::cout << "Error: Failed to initialize GLFW!" << std::endl;
+		return false;
+	}
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	m_Window = glfwCreateWindow(1, 1, "Tests", NULL, NULL);
+	if (!m_Window)
+	{
+		std::cout << "Error: Failed to create a GLFW window!" << std::endl;
+		glfwTerminate();
+		return false;
+	}
+	glfwMakeContextCurrent(m_Window);
+
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK)
+	{
+		std::cout << "Error: Failed to initialize glew!" << std::endl;
+		Destroy();
+		return false;
+	}
+#endif
+
+	m_Width = width;
+	m_Height = height;
+	m_ViewProjection = glm::ortho(0.f, (float)width, (float)height, 0.f);
+
+	Target = new OffscreenTarget(width, height);
+	Target->Bind();
+
+	Matrices = new UBO(sizeof(float) * 16, 0, "Matrices");
+	Matrices->SetData(&m_ViewProjection[0][0]);
+
+	ShapeShader = new Shader(SHAPE);
+	RenderShader = new Shader(TEXTURE_RENDERER);
+	AnalyticShader = new Shader(ANALYTIC_SHAPE);
+	ShapeShader->setUBO(*Matrices);
+	RenderShader->setUBO(*Matrices);
+	AnalyticShader->setUBO(*Matrices);
+
+	Graphics::Init(ShapeShader, RenderShader);
+	Graphics::InitAnalyticShapes(AnalyticShader);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	return true;
+}
+
+void TestContext::Destroy()
+{
+	if (Target)
+	{
+		Target->Unbind();
+		Target->Clean();
+		delete Target;
+		Target = nullptr;
+	}
+
+#ifdef GRAPHICS_HEADLESS_EGL
+	m_Context.Destroy();
+#else
+	if (m_Window)
+	{
+		glfwDestroyWindow(m_Window);
+		glfwTerminate();
+		m_Window = nullptr;
+	}
+#endif
+}
+
+void TestContext::ReadPixels(std::vector<uint32_t>& pixels)
+{
+	pixels.resize((size_t)m_Width * m_Height);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+	// framebuffer rows start at the bottom
+	for (int y = 0; y < m_Height / 2; y++)
+		std::swap_ranges(pixels.begin() + (size_t)y * m_Width, pixels.begin() + (size_t)(y + 1) * m_Width, pixels.begin() + (size_t)(m_Height - 1 - y) * m_Width);
+}
+
+int TestContext::GetWidth()
+{
+	return m_Width;
+}
+
+int TestContext::GetHeight()
+{
+	return m_Height;
+}
+
+glm::mat4 TestContext::GetViewProjection()
+{
+	return m_ViewProjection;
+}
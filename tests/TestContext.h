@@ -0,0 +1,52 @@
+#ifndef TEST_CONTEXT_H
+#define TEST_CONTEXT_H
+
+#include "Graphics.h"
+#include "OffscreenTarget.h"
+
+#ifdef GRAPHICS_HEADLESS_EGL
+#include "HeadlessContext.h"
+#else
+struct GLFWwindow;
+#endif
+
+#include <cstdint>
+#include <vector>
+
+// GL context shared by the test programs, drawing into an offscreen target with a top left origin projection
+// With GRAPHICS_HEADLESS_EGL the context is a HeadlessContext, otherwise a hidden GLFW window
+class TestContext
+{
+public:
+	// create the context and a width x height target, then Graphics::Init() with blending enabled
+	// returns false and prints the failing step when the context could not be created
+	bool Create(int width, int height);
+	void Destroy();
+
+	// read the target's pixels, RGBA8 rows from the top down like a SoftwareRenderer framebuffer
+	void ReadPixels(std::vector<uint32_t>& pixels);
+
+	int GetWidth();
+	int GetHeight();
+	glm::mat4 GetViewProjection();
+
+public:
+	Shader* ShapeShader = nullptr;
+	Shader* RenderShader = nullptr;
+	Shader* AnalyticShader = nullptr;
+	UBO* Matrices = nullptr;
+	OffscreenTarget* Target = nullptr;
+
+private:
+#ifdef GRAPHICS_HEADLESS_EGL
+	HeadlessContext m_Context;
+#else
+	GLFWwindow* m_Window = nullptr;
+#endif
+
+	int m_Width = 0;
+	int m_Height = 0;
+	glm::mat4 m_ViewProjection = glm::mat4(1.f);
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+#include "TestContext.h"
+
+// every check draws into the shared context, prints what it measured and returns false when it failed
+
+// record frames into a capture, replay it and compare the pixels, the frame count and the claimed texture units
+bool RunCaptureRoundTrip(TestContext& context);
+
+// check a new context claims its own texture units and frees its font texture, then render on two threads and contexts at once
+bool RunContexts(TestContext& context);
+
+// compare FormatNumber() at a precision against printf and time it against formatting 6 digits and truncating them
+bool RunFormatBenchmark(TestContext& context);
+
+// draw a scene into two views with one Render() and diff it against rendering each view on its own
+bool RunMultiView(TestContext& context);
+
+// render one scene with GL and with the SoftwareRenderer, diff the images within a tolerance and time both backends
+bool RunRendererCompare(TestContext& context);
+
+// export the zones of a frame, then write traces while other threads record and fail on any torn event
+bool RunTraceExport(TestContext& context);
+
+// stream a virtual texture's tiles for a whole and a zoomed view, fail on holes while loading and on wrong colors once loaded
+bool RunVirtualTextures(TestContext& context);
+
+// render steady frames with and without frames in flight and fail on any heap allocation within a frame
+bool RunZeroAllocations(TestContext& context);
+
+#endif
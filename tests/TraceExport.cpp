@@ -0,0 +1,143 @@
+#include "Tests.h"
+
+#include "Trace.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef GRAPHICS_TRACE
+#error TraceExport needs the library built with GRAPHICS_TRACE, see Tests.vcxproj
+#endif
+
+static const char* TRACE_PATH = "TraceExport.json";
+static const int WRITER_THREADS = 4;
+static const int WRITES = 300;
+static const unsigned int WRITER_BUFFER_SIZE = 64;
+static const unsigned int DEFAULT_BUFFER_SIZE = 1 << 16;
+
+struct TraceFile
+{
+	std::string Text;
+	int Events = 0;
+	int TornEvents = 0;		// zones written while their slot was being overwritten
+	int UnorderedEvents = 0;	// zones older than the one before them on their thread, their slot was lapped
+};
+
+// reads back a written trace, every writer zone lasts exactly 1 microsecond and is named "zone"
+static bool ReadTrace(TraceFile& trace)
+{
+	std::ifstream file(TRACE_PATH);
+	if (!file)
+		return false;
+
+	std::map<int, double> lastStart;
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		trace.Text += line;
+		trace.Text += '\n';
+
+		if (line.find("\"name\":\"zone\"") == std::string::npos)
+			continue;
+
+		trace.Events++;
+		size_t duration = line.find("\"dur\":");
+		if (duration == std::string::npos || line.compare(duration + 6, 5, "1.000") != 0)
+			trace.TornEvents++;
+
+		size_t thread = line.find("\"tid\":");
+		size_t start = line.find("\"ts\":");
+		if (thread == std::string::npos || start == std::string::npos)
+		{
+			trace.TornEvents++;
+			continue;
+		}
+
+		int tid = std::stoi(line.substr(thread + 6));
+		double ts = std::stod(line.substr(start + 5));
+		auto last = lastStart.find(tid);
+		if (last != lastStart.end() && ts < last->second)
+			trace.UnorderedEvents++;
+		lastStart[tid] = ts;
+	}
+	return true;
+}
+
+// the zones of a rendered frame are exported as whole JSON
+static bool CheckFrameZones()
+{
+	Trace::Clear();
+	Trace::SetEnabled(true);
+	Graphics::Rectangle(Graphics::FILL, 10.f, 10.f, 50.f, 50.f);
+	Graphics::Render();
+	Trace::SetEnabled(false);
+
+	TraceFile trace;
+	if (!Trace::Write(TRACE_PATH) || !ReadTrace(trace))
+	{
+		std::cout << "  couldn't write " << TRACE_PATH << std::endl;
+		return false;
+	}
+
+	bool whole = trace.Text.rfind("{\"traceEvents\":[", 0) == 0 && trace.Text.size() >= 4 && trace.Text.compare(trace.Text.size() - 4, 4, "\n]}\n") == 0;
+	bool rendered = trace.Text.find("\"name\":\"Graphics::Render\"") != std::string::npos;
+	bool flushed = trace.Text.find("\"name\":\"Graphics::FlushShapes\"") != std::string::npos;
+	std::cout << "  frame: " << (whole ? "whole" : "broken") << " file, Graphics::Render " << (rendered ? "found" : "missing")
+		<< ", Graphics::FlushShapes " << (flushed ? "found" : "missing") << std::endl;
+	return whole && rendered && flushed;
+}
+
+// threads keep overwriting small rings while the trace is written over and over, no exported event may be torn or lapped
+static bool CheckConcurrentWrites()
+{
+	Trace::Clear();
+	Trace::SetBufferSize(WRITER_BUFFER_SIZE);
+	Trace::SetEnabled(true);
+
+	std::atomic<bool> stop{ false };
+	std::vector<std::thread> writers;
+	for (int i = 0; i < WRITER_THREADS; i++)
+	{
+		writers.emplace_back([&stop]()
+		{
+			while (!stop.load(std::memory_order_relaxed))
+			{
+				uint64_t start = Trace::Now();
+				Trace::Record("zone", start, start + 1000);
+			}
+		});
+	}
+
+	TraceFile trace;
+	bool written = true;
+	for (int i = 0; i < WRITES && written; i++)
+		written = Trace::Write(TRACE_PATH) && ReadTrace(trace);
+
+	stop = true;
+	for (std::thread& writer : writers)
+		writer.join();
+
+	Trace::SetEnabled(false);
+	Trace::SetBufferSize(DEFAULT_BUFFER_SIZE);
+
+	std::cout << "  " << WRITES << " writes beside " << WRITER_THREADS << " recording threads: " << trace.Events << " events, "
+		<< trace.TornEvents << " torn, " << trace.UnorderedEvents << " out of order" << std::endl;
+	return written && trace.Events > 0 && trace.TornEvents == 0 && trace.UnorderedEvents == 0;
+}
+
+bool RunTraceExport(TestContext& context)
+{
+	bool passed = CheckFrameZones();
+	passed &= CheckConcurrentWrites();
+
+	Trace::Clear();
+	std::remove(TRACE_PATH);
+	return passed;
+}
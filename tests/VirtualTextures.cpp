@@ -0,0 +1,132 @@
+#include "Tests.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+static const char* TILE_PATH = "VirtualTextures.tiles";
+static const int IMAGE_SIZE = 1024;
+static const int TILE_SIZE = 64;
+// the image is a grid of flat colored blocks, so every mip level keeps the color at a block's center
+static const int BLOCKS = 8;
+static const int BLOCK_SIZE = IMAGE_SIZE / BLOCKS;
+static const int CHANNEL_TOLERANCE = 2;
+// frames to wait for the visible tiles to stream in
+static const int MAX_FRAMES = 500;
+
+// block colors stay well away from the clear color, so a pixel of clear color is a hole
+static uint32_t BlockColor(int blockX, int blockY)
+{
+	uint32_t red = 40 + blockX * 28;
+	uint32_t green = 40 + blockY * 28;
+	uint32_t blue = (blockX + blockY) % 2 ? 230 : 60;
+	return red | green << 8 | blue << 16 | 0xFF000000u;
+}
+
+static bool Matches(uint32_t a, uint32_t b)
+{
+	for (int shift = 0; shift < 24; shift += 8)
+	{
+		if (abs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)) > CHANNEL_TOLERANCE)
+			return false;
+	}
+	return true;
+}
+
+// draw the image at (x, y, size) through a view of the whole target until every visible tile is cached
+// the first frame may only show coarser stand ins, but never a hole
+static bool CheckView(TestContext& context, VirtualTexture& texture, const char* name, float x, float y, float size)
+{
+	int width = context.GetWidth(), height = context.GetHeight();
+	glm::vec4 view(0.f, 0.f, (float)width, (float)height);
+	uint32_t clearColor = 0xFF1A1A1Au;
+	glClearColor(0x1A / 255.f, 0x1A / 255.f, 0x1A / 255.f, 1.f);
+
+	std::vector<uint32_t> pixels;
+	int holes = -1;
+	int frames = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (; frames < MAX_FRAMES; frames++)
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
+		Graphics::Draw(texture, x, y, size, size, view, width);
+		Graphics::Render();
+
+		if (holes < 0)
+		{
+			context.ReadPixels(pixels);
+			holes = 0;
+			for (uint32_t pixel : pixels)
+				holes += pixel == clearColor ? 1 : 0;
+		}
+
+		// nothing is left to load once a draw queued no tile
+		if (texture.GetPendingCount() == 0)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	context.ReadPixels(pixels);
+
+	// compare the center and the top left corner of every visible block, coarser stand in levels blur the corners
+	float scale = size / IMAGE_SIZE;
+	float left = x - size / 2, top = y - size / 2;
+	int compared = 0, mismatched = 0;
+	for (int blockY = 0; blockY < BLOCKS; blockY++)
+	{
+		for (int blockX = 0; blockX < BLOCKS; blockX++)
+		{
+			int cornerX = (int)(left + blockX * BLOCK_SIZE * scale) + 1;
+			int cornerY = (int)(top + blockY * BLOCK_SIZE * scale) + 1;
+			int centerX = (int)(left + (blockX + 0.5f) * BLOCK_SIZE * scale);
+			int centerY = (int)(top + (blockY + 0.5f) * BLOCK_SIZE * scale);
+			if (cornerX < 0 || cornerY < 0 || centerX >= width || centerY >= height)
+				continue;
+
+			compared += 2;
+			if (!Matches(pixels[(size_t)centerY * width + centerX], BlockColor(blockX, blockY)))
+				mismatched++;
+			if (!Matches(pixels[(size_t)cornerY * width + cornerX], BlockColor(blockX, blockY)))
+				mismatched++;
+		}
+	}
+
+	std::cout << "  " << name << ": streamed in " << frames + 1 << " frames (" << milliseconds << " ms), " << holes << " hole pixels in the first frame, "
+		<< mismatched << " of " << compared << " block samples wrong" << std::endl;
+	return frames < MAX_FRAMES && holes == 0 && compared > 0 && mismatched == 0;
+}
+
+bool RunVirtualTextures(TestContext& context)
+{
+	std::vector<unsigned char> image((size_t)IMAGE_SIZE * IMAGE_SIZE * 4);
+	for (int y = 0; y < IMAGE_SIZE; y++)
+	{
+		for (int x = 0; x < IMAGE_SIZE; x++)
+		{
+			uint32_t color = BlockColor(x / BLOCK_SIZE, y / BLOCK_SIZE);
+			unsigned char* pixel = &image[((size_t)y * IMAGE_SIZE + x) * 4];
+			for (int channel = 0; channel < 4; channel++)
+				pixel[channel] = (unsigned char)(color >> (channel * 8));
+		}
+	}
+
+	VirtualTexture texture;
+	if (!VirtualTexture::Build(image.data(), IMAGE_SIZE, IMAGE_SIZE, 4, TILE_PATH, TILE_SIZE) || !texture.Open(TILE_PATH))
+	{
+		std::cout << "  couldn't build or open " << TILE_PATH << std::endl;
+		std::remove(TILE_PATH);
+		return false;
+	}
+	std::cout << "  " << IMAGE_SIZE << " x " << IMAGE_SIZE << " image in " << texture.GetLevelCount() << " levels of " << TILE_SIZE << " pixel tiles" << std::endl;
+
+	float width = (float)context.GetWidth(), height = (float)context.GetHeight();
+	// the whole image shrunk to the target, then its top left corner at full size
+	bool passed = CheckView(context, texture, "whole image", width / 2, height / 2, width);
+	passed &= CheckView(context, texture, "zoomed in", IMAGE_SIZE / 2.f, IMAGE_SIZE / 2.f, (float)IMAGE_SIZE);
+
+	texture.Clean();
+	std::remove(TILE_PATH);
+	return passed;
+}
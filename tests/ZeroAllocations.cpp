@@ -0,0 +1,68 @@
+#include "Tests.h"
+
+#include <iostream>
+
+#ifndef GRAPHICS_COUNT_ALLOCATIONS
+#error ZeroAllocations needs the library built with GRAPHICS_COUNT_ALLOCATIONS, see Tests.vcxproj
+#endif
+
+static const int WARMUP_FRAMES = 3;
+static const int CHECKED_FRAMES = 100;
+
+// a steady frame of queued shapes, analytic shapes and images, which should reuse last frame's storage
+static void DrawFrame(TextureAtlas& image, int frame)
+{
+	float offset = (float)(frame % 10);
+
+	for (int i = 0; i < 50; i++)
+	{
+		float x = (float)(i % 10) * 25.f + offset;
+		float y = (float)(i / 10) * 25.f;
+		Graphics::Rectangle(Graphics::FILL, x, y, 10.f, 10.f, 0.f, 0.f, 0.f, 0.5f, 0.5f, 0.5f);
+		Graphics::Circle(Graphics::LINE, x, y + 130.f, 5.f);
+		Graphics::AnalyticCircle(Graphics::FILL, x + 5.f, y + 5.f, 4.f, 1.f, 0.f, 0.f);
+		Graphics::Draw(&image, 0, x + 12.f, y + 130.f, 8.f, 8.f);
+	}
+
+	float triangle[] = { 10.f, 250.f, 20.f, 230.f, 30.f, 250.f };
+	Graphics::Polygon(Graphics::FILL, triangle, 3);
+
+	Graphics::Render();
+}
+
+// render warmed up frames, with and without frames in flight, and fail on any heap allocation between two Render() calls
+static bool CheckFrames(TextureAtlas& image, unsigned int framesInFlight)
+{
+	Graphics::SetFramesInFlight(framesInFlight);
+
+	unsigned long long worst = 0;
+	for (int frame = 0; frame < WARMUP_FRAMES + CHECKED_FRAMES; frame++)
+	{
+		if (framesInFlight > 0)
+			Graphics::BeginFrame();
+		DrawFrame(image, frame);
+		if (framesInFlight > 0)
+			Graphics::EndFrame();
+
+		// the first Render() has no frame start to count from, the warm up frames grow the storage
+		if (frame >= WARMUP_FRAMES && Graphics::GetFrameAllocationCount() > worst)
+			worst = Graphics::GetFrameAllocationCount();
+	}
+
+	Graphics::SetFramesInFlight(0);
+
+	std::cout << "  " << framesInFlight << " frames in flight: most heap allocations in a frame " << worst << std::endl;
+	return worst == 0;
+}
+
+bool RunZeroAllocations(TestContext& context)
+{
+	unsigned char pixels[4 * 4 * 4] = {};
+	TextureAtlas image(pixels, 4, 4, 4);
+
+	bool passed = CheckFrames(image, 0);
+	passed &= CheckFrames(image, 2);
+
+	image.GetTexture().Clean();
+	return passed;
+}